@@ -6,119 +6,145 @@
 #include "item.h"
 #include "safe_reference.h"
 
-void active_item_cache::remove( const item *it )
+active_item_cache::speed_bucket &active_item_cache::bucket_for( int speed )
 {
-    active_items[it->processing_speed()].remove_if( [it]( const item_reference & active_item ) {
-        item *const target = active_item.item_ref.get();
-        return !target || target == it;
-    } );
-    if( it->can_revive() ) {
-        special_items[ special_item_type::corpse ].remove_if( [it]( const item_reference & active_item ) {
-            item *const target = active_item.item_ref.get();
-            return !target || target == it;
-        } );
-    }
-    if( it->get_use( "explosion" ) ) {
-        special_items[ special_item_type::explosive ].remove_if( [it]( const item_reference &
-        active_item ) {
-            item *const target = active_item.item_ref.get();
-            return !target || target == it;
-        } );
+    for( speed_bucket &bucket : buckets ) {
+        if( bucket.speed == speed ) {
+            return bucket;
+        }
     }
+    buckets.emplace_back();
+    buckets.back().speed = speed;
+    return buckets.back();
 }
 
-void active_item_cache::add( item &it, point location )
+void active_item_cache::remove_slot( const slot s )
 {
-    // If the item is alread in the cache for some reason, don't add a second reference
-    std::list<item_reference> &target_list = active_items[it.processing_speed()];
-    if( std::find_if( target_list.begin(),
-    target_list.end(), [&it]( const item_reference & active_item_ref ) {
-    return &it == active_item_ref.item_ref.get();
-    } ) != target_list.end() ) {
-        return;
+    std::vector<cached_item> &items = buckets[s.bucket].items;
+    slots.erase( items[s.index].target );
+    if( s.index + 1 != items.size() ) {
+        items[s.index] = std::move( items.back() );
+        slots[items[s.index].target].index = s.index;
     }
-    if( it.can_revive() ) {
-        special_items[ special_item_type::corpse ].push_back( item_reference{ location, it.get_safe_reference() } );
+    items.pop_back();
+}
+
+void active_item_cache::remove_broken( size_t bucket, const std::vector<size_t> &indices )
+{
+    // Backwards, so the items moved into the freed slots are never ones still to be removed
+    for( auto it = indices.rbegin(); it != indices.rend(); ++it ) {
+        remove_slot( slot{ bucket, *it } );
     }
-    if( it.get_use( "explosion" ) ) {
-        special_items[ special_item_type::explosive ].push_back( item_reference{ location, it.get_safe_reference() } );
+}
+
+void active_item_cache::remove( const item *it )
+{
+    const auto iter = slots.find( it );
+    if( iter != slots.end() ) {
+        remove_slot( iter->second );
     }
-    target_list.push_back( item_reference{ location, it.get_safe_reference() } );
 }
 
-bool active_item_cache::empty() const
+void active_item_cache::add( item &it, point location )
 {
-    for( std::pair<int, std::list<item_reference>> active_queue : active_items ) {
-        if( !active_queue.second.empty() ) {
-            return false;
+    const auto iter = slots.find( &it );
+    if( iter != slots.end() ) {
+        // If the item is alread in the cache for some reason, don't add a second reference
+        if( buckets[iter->second.bucket].items[iter->second.index].ref.item_ref ) {
+            return;
         }
+        // A destroyed item that used to live at the same address
+        remove_slot( iter->second );
     }
-    return true;
+    speed_bucket &bucket = bucket_for( it.processing_speed() );
+    slots[&it] = slot{ static_cast<size_t>( &bucket - buckets.data() ), bucket.items.size() };
+    bucket.items.push_back( cached_item{ item_reference{ location, it.get_safe_reference() }, &it,
+                                         it.can_revive(), it.get_use( "explosion" ) != nullptr } );
+}
+
+bool active_item_cache::empty() const
+{
+    return slots.empty();
 }
 
 std::vector<item_reference> active_item_cache::get()
 {
     std::vector<item_reference> all_cached_items;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        for( std::list<item_reference>::iterator it = kv.second.begin(); it != kv.second.end(); ) {
-            if( it->item_ref ) {
-                all_cached_items.emplace_back( *it );
-                ++it;
+    all_cached_items.reserve( slots.size() );
+    for( size_t b = 0; b < buckets.size(); ++b ) {
+        std::vector<size_t> broken;
+        const std::vector<cached_item> &items = buckets[b].items;
+        for( size_t i = 0; i < items.size(); ++i ) {
+            if( items[i].ref.item_ref ) {
+                all_cached_items.push_back( items[i].ref );
             } else {
-                it = kv.second.erase( it );
+                broken.push_back( i );
             }
         }
+        remove_broken( b, broken );
     }
     return all_cached_items;
 }
 
-std::vector<item_reference> active_item_cache::get_for_processing()
+void active_item_cache::get_for_processing( std::vector<item_reference> &items )
 {
-    std::vector<item_reference> items_to_process;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
+    items.clear();
+    for( size_t b = 0; b < buckets.size(); ++b ) {
+        speed_bucket &bucket = buckets[b];
+        const size_t size = bucket.items.size();
+        if( size == 0 ) {
+            continue;
+        }
         // Rely on iteration logic to make sure the number is sane.
-        int num_to_process = kv.second.size() / kv.first;
-        std::list<item_reference>::iterator it = kv.second.begin();
-        for( ; it != kv.second.end() && num_to_process >= 0; ) {
-            if( it->item_ref ) {
-                items_to_process.push_back( *it );
+        int num_to_process = size / bucket.speed;
+        std::vector<size_t> broken;
+        size_t index = bucket.next < size ? bucket.next : 0;
+        for( size_t visited = 0; visited < size && num_to_process >= 0; ++visited ) {
+            const cached_item &cached = bucket.items[index];
+            if( cached.ref.item_ref ) {
+                items.push_back( cached.ref );
                 --num_to_process;
-                ++it;
             } else {
                 // The item has been destroyed, so remove the reference from the cache
-                it = kv.second.erase( it );
+                broken.push_back( index );
             }
+            index = index + 1 < size ? index + 1 : 0;
         }
-        // Rotate the returned items to the end of their list so that the items that weren't
-        // returned this time will be first in line on the next call
-        kv.second.splice( kv.second.end(), kv.second, kv.second.begin(), it );
+        // The items that weren't returned this time are first in line on the next call
+        bucket.next = index;
+        std::sort( broken.begin(), broken.end() );
+        remove_broken( b, broken );
     }
-    return items_to_process;
 }
 
-std::vector<item_reference> active_item_cache::get_special( special_item_type type )
+std::vector<item_reference> active_item_cache::get_special( special_item_type type ) const
 {
     std::vector<item_reference> matching_items;
-    for( const item_reference &it : special_items[type] ) {
-        matching_items.push_back( it );
+    for( const speed_bucket &bucket : buckets ) {
+        for( const cached_item &cached : bucket.items ) {
+            if( ( type == special_item_type::corpse && cached.corpse ) ||
+                ( type == special_item_type::explosive && cached.explosive ) ) {
+                matching_items.push_back( cached.ref );
+            }
+        }
     }
     return matching_items;
 }
 
 void active_item_cache::subtract_locations( const point &delta )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location -= delta;
+    for( speed_bucket &bucket : buckets ) {
+        for( cached_item &cached : bucket.items ) {
+            cached.ref.location -= delta;
         }
     }
 }
 
 void active_item_cache::rotate_locations( int turns, const point &dim )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location = ir.location.rotate( turns, dim );
+    for( speed_bucket &bucket : buckets ) {
+        for( cached_item &cached : bucket.items ) {
+            cached.ref.location = cached.ref.location.rotate( turns, dim );
         }
     }
 }
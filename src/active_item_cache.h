@@ -3,7 +3,6 @@
 #define CATA_SRC_ACTIVE_ITEM_CACHE_H
 
 #include <iosfwd>
-#include <list>
 #include <unordered_map>
 #include <vector>
 
@@ -37,14 +36,36 @@ struct hash<special_item_type> {
 class active_item_cache
 {
     private:
-        std::unordered_map<int, std::list<item_reference>> active_items;
-        std::unordered_map<special_item_type, std::list<item_reference>> special_items;
+        struct cached_item {
+            item_reference ref;
+            // The item the reference was made for, to find it once the reference is broken
+            const item *target;
+            bool corpse;
+            bool explosive;
+        };
+        // Items of the same processing speed, processed round robin starting at next
+        struct speed_bucket {
+            int speed;
+            std::vector<cached_item> items;
+            size_t next = 0;
+        };
+        struct slot {
+            size_t bucket;
+            size_t index;
+        };
+        std::vector<speed_bucket> buckets;
+        // Where each cached item is stored in buckets
+        std::unordered_map<const item *, slot> slots;
+
+        speed_bucket &bucket_for( int speed );
+        /** Removes the item in that slot by moving the last one of its bucket into it. */
+        void remove_slot( slot s );
+        /** Removes the items of a bucket with broken references, given in ascending order. */
+        void remove_broken( size_t bucket, const std::vector<size_t> &indices );
 
     public:
         /**
          * Removes the item if it is in the cache. Does nothing if the item is not in the cache.
-         * Relies on the fact that item::processing_speed() is a constant.
-         * Also removes any items that have been destroyed in the list containing it
          */
         void remove( const item *it );
 
@@ -66,19 +87,19 @@ class active_item_cache
         std::vector<item_reference> get();
 
         /**
-         * Returns the first size() / processing_speed() elements of each list, rounded up.
-         * Items returned are rotated to the back of their respective lists, otherwise only the
-         * first n items will ever be processed.
+         * Replaces the contents of @p items with size() / processing_speed() items of each
+         * speed, rounded up. The items are taken round robin, so that every item gets its
+         * turn. Reusing the same vector on each call avoids allocating it every turn.
          * Broken references encountered when collecting the items to be processed are removed from
          * the cache.
          * Relies on the fact that item::processing_speed() is a constant.
          */
-        std::vector<item_reference> get_for_processing();
+        void get_for_processing( std::vector<item_reference> &items );
 
         /**
          * Returns the currently tracked list of special active items.
          */
-        std::vector<item_reference> get_special( special_item_type type );
+        std::vector<item_reference> get_special( special_item_type type ) const;
         /** Subtract delta from every item_reference's location */
         void subtract_locations( const point &delta );
         void rotate_locations( int turns, const point &dim );
@@ -74,6 +74,7 @@
 #include "optional.h"
 #include "output.h"
 #include "overmapbuffer.h"
+#include "pathfinding.h"
 #include "pimpl.h"
 #include "player.h"
 #include "player_activity.h"
@@ -3034,8 +3035,9 @@ void activity_handlers::travel_do_turn( player_activity *act, player *p )
                 }
             }
         }
-        const std::vector<tripoint> route_to = g->m.route( p->pos(), centre_sub,
-                                               p->get_pathfinding_settings(),
+        pathfinding_settings travel_settings = p->get_pathfinding_settings();
+        travel_settings.guide_by_portals = true;
+        const std::vector<tripoint> route_to = g->m.route( p->pos(), centre_sub, travel_settings,
                                                p->get_path_avoid() );
         if( !route_to.empty() ) {
             const activity_id act_travel = ACT_TRAVELLING;
@@ -11,6 +11,9 @@ int message_cooldown;
 bool trigdist;
 bool fov_3d;
 int fov_3d_z_range;
+bool parallel_map_cache = false;
+bool parallel_fields = false;
+bool perception_pass = false;
 bool tile_iso;
 bool pixel_minimap_option = false;
 int PICKUP_RANGE;
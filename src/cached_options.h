@@ -55,6 +55,15 @@ extern bool fov_3d;
 /** 3D FoV range, in Z levels, in both directions. */
 extern int fov_3d_z_range;
 
+/** Build the map caches of different z-levels on several threads. */
+extern bool parallel_map_cache;
+
+/** Plan the spreading of gas fields in different submaps on several threads. */
+extern bool parallel_fields;
+
+/** Work out the lines of sight to every NPC once per turn so monsters can look them up. */
+extern bool perception_pass;
+
 /** Using isometric tileset. */
 extern bool tile_iso;
 
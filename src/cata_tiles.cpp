@@ -319,6 +319,10 @@ tile_type &tileset::create_tile_type( const std::string &id, tile_type &&new_til
 void cata_tiles::load_tileset( const std::string &tileset_id, const bool precheck,
                                const bool force )
 {
+    // Called again after the game data changes, which invalidates the lookups even
+    // when the tileset stays.
+    clear_resolved_tiles();
+    map_layer.cells.clear();
     if( tileset_ptr && tileset_ptr->get_tileset_id() == tileset_id && !force ) {
         return;
     }
@@ -344,6 +348,11 @@ void cata_tiles::reinit()
     RenderClear( renderer );
 }
 
+void cata_tiles::invalidate_map_layer()
+{
+    map_layer.cells.clear();
+}
+
 static void get_tile_information( const std::string &config_path, std::string &json_path,
                                   std::string &tileset_path )
 {
@@ -753,6 +762,10 @@ void tileset_loader::load_internal( const JsonObject &config, const std::string
             // Now load the tile definitions for the loaded tileset image.
             sprite_offset.x = tile_part_def.get_int( "sprite_offset_x", 0 );
             sprite_offset.y = tile_part_def.get_int( "sprite_offset_y", 0 );
+            if( sprite_width > ts.tile_width || sprite_height > ts.tile_height ||
+                sprite_offset != point_zero ) {
+                ts.sprites_fit_tiles = false;
+            }
             // First load the tileset image to get the number of available tiles.
             dbg( DL::Info ) << "Attempting to Load Tileset file " << tileset_image_path;
             load_tileset( tileset_image_path );
@@ -968,6 +981,9 @@ void tileset_loader::load_tilejson_from_file( const JsonObject &config )
             bool t_multi = entry.get_bool( "multitile", false );
             bool t_rota = entry.get_bool( "rotates", t_multi );
             int t_h3d = entry.get_int( "height_3d", 0 );
+            if( t_h3d != 0 ) {
+                ts.sprites_fit_tiles = false;
+            }
             if( t_multi ) {
                 // fetch additional tiles
                 for( const JsonObject &subentry : entry.get_array( "additional_tiles" ) ) {
@@ -1115,15 +1131,13 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     }
 #endif
 
-    {
-        //set clipping to prevent drawing over stuff we shouldn't
-        SDL_Rect clipRect = {dest.x, dest.y, width, height};
-        printErrorIf( SDL_RenderSetClipRect( renderer.get(), &clipRect ) != 0,
-                      "SDL_RenderSetClipRect failed" );
+    //set clipping to prevent drawing over stuff we shouldn't
+    const SDL_Rect clipRect = {dest.x, dest.y, width, height};
+    printErrorIf( SDL_RenderSetClipRect( renderer.get(), &clipRect ) != 0,
+                  "SDL_RenderSetClipRect failed" );
 
-        //fill render area with black to prevent artifacts where no new pixels are drawn
-        geometry->rect( renderer, clipRect, SDL_Color() );
-    }
+    //fill render area with black to prevent artifacts where no new pixels are drawn
+    geometry->rect( renderer, clipRect, SDL_Color() );
 
     point s;
     get_window_tile_counts( width, height, s.x, s.y );
@@ -1146,6 +1160,17 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     const int min_row = 0;
     const int max_row = s.y;
 
+    // terrain, furniture and graffiti are drawn by update_map_layer() if it is used
+    const bool use_map_layer = can_use_map_layer();
+    std::vector<map_layer_cell> layer_cells;
+    std::vector<std::vector<tile_render_info>> layer_rows;
+    if( use_map_layer ) {
+        layer_cells.resize( s.x * s.y );
+        layer_rows.reserve( s.y );
+    } else {
+        map_layer.cells.clear();
+    }
+
     //limit the render area to maximum view range (121x121 square centered on player)
     const int min_visible_x = g->u.posx() % SEEX;
     const int min_visible_y = g->u.posy() % SEEY;
@@ -1220,6 +1245,41 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                                              direction::NORTH ) );
         }
     }
+    const std::array<decltype( &cata_tiles::draw_furniture ), 11> drawing_layers = {{
+            &cata_tiles::draw_furniture, &cata_tiles::draw_graffiti, &cata_tiles::draw_trap,
+            &cata_tiles::draw_field_or_item, &cata_tiles::draw_vpart_below,
+            &cata_tiles::draw_critter_at_below, &cata_tiles::draw_terrain_below,
+            &cata_tiles::draw_vpart, &cata_tiles::draw_critter_at,
+            &cata_tiles::draw_zone_mark, &cata_tiles::draw_zombie_revival_indicators
+        }
+    };
+    // furniture and graffiti are part of the map layer
+    const size_t first_layer_above_map = 2;
+    const auto draw_layers = [&]( std::vector<tile_render_info> &draw_points, size_t first_layer ) {
+        // for each of the drawing layers in order, back to front ...
+        for( size_t i = first_layer; i < drawing_layers.size(); i++ ) {
+            // ... draw all the points we drew terrain for, in the same order
+            for( auto &p : draw_points ) {
+                ( this->*drawing_layers[i] )( p.pos, p.ll, p.height_3d, p.invisible );
+            }
+        }
+        // display number of monsters to spawn in mapgen preview
+        for( const auto &p : draw_points ) {
+            const auto mon_override = monster_override.find( p.pos );
+            if( mon_override != monster_override.end() ) {
+                const int count = std::get<1>( mon_override->second );
+                const bool more = std::get<2>( mon_override->second );
+                if( count > 1 || more ) {
+                    std::string text = "x" + std::to_string( count );
+                    if( more ) {
+                        text += "+";
+                    }
+                    overlay_strings.emplace( player_to_screen( p.pos.xy() ) + point( tile_width / 2, 0 ),
+                                             formatted_text( text, catacurses::red, direction::NORTH ) );
+                }
+            }
+        }
+    };
     for( int row = min_row; row < max_row; row ++ ) {
         std::vector<tile_render_info> draw_points;
         draw_points.reserve( max_col );
@@ -1241,6 +1301,8 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
             const tripoint pos( temp_x, temp_y, center.z );
             const int &x = pos.x;
             const int &y = pos.y;
+            // only used with the map layer, which is never used in isometric mode
+            map_layer_cell *const layer_cell = use_map_layer ? &layer_cells[row * s.x + col] : nullptr;
 
             lit_level ll;
             // invisible to normal eyes
@@ -1255,7 +1317,11 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                     ll = lit_level::DARK;
                     invisible[0] = true;
                 } else {
-                    apply_vision_effects( pos, offscreen_type );
+                    if( layer_cell ) {
+                        layer_cell->effect = offscreen_type;
+                    } else {
+                        apply_vision_effects( pos, offscreen_type );
+                    }
                     continue;
                 }
             } else {
@@ -1382,7 +1448,13 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                 draw_debug_tile( intensity, string_format( "%.2f", tr ) );
             }
 
-            if( !invisible[0] && apply_vision_effects( pos, here.get_visibility( ll, cache ) ) ) {
+            const visibility_type visibility = invisible[0] ? VIS_CLEAR : here.get_visibility( ll, cache );
+            if( would_apply_vision_effects( visibility ) ) {
+                if( layer_cell ) {
+                    layer_cell->effect = visibility;
+                } else {
+                    apply_vision_effects( pos, visibility );
+                }
                 const Creature *critter = g->critter_at( pos, true );
                 if( has_draw_override( pos ) || has_memory_at( pos ) ||
                     ( critter && ( g->u.sees_with_infrared( *critter ) || g->u.sees_with_specials( *critter ) ) ) ) {
@@ -1401,41 +1473,31 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
 
             int height_3d = 0;
 
-            // light level is now used for choosing between grayscale filter and normal lit tiles.
-            draw_terrain( pos, ll, height_3d, invisible );
+            if( layer_cell ) {
+                layer_cell->drawn = true;
+                layer_cell->ll = ll;
+                std::copy( invisible, invisible + 5, layer_cell->invisible );
+            } else {
+                // light level is now used for choosing between grayscale filter and normal lit tiles.
+                draw_terrain( pos, ll, height_3d, invisible );
+            }
 
             draw_points.emplace_back( pos, height_3d, ll, invisible );
         }
-        const std::array<decltype( &cata_tiles::draw_furniture ), 11> drawing_layers = {{
-                &cata_tiles::draw_furniture, &cata_tiles::draw_graffiti, &cata_tiles::draw_trap,
-                &cata_tiles::draw_field_or_item, &cata_tiles::draw_vpart_below,
-                &cata_tiles::draw_critter_at_below, &cata_tiles::draw_terrain_below,
-                &cata_tiles::draw_vpart, &cata_tiles::draw_critter_at,
-                &cata_tiles::draw_zone_mark, &cata_tiles::draw_zombie_revival_indicators
-            }
-        };
-        // for each of the drawing layers in order, back to front ...
-        for( auto f : drawing_layers ) {
-            // ... draw all the points we drew terrain for, in the same order
-            for( auto &p : draw_points ) {
-                ( this->*f )( p.pos, p.ll, p.height_3d, p.invisible );
-            }
+        if( use_map_layer ) {
+            layer_rows.emplace_back( std::move( draw_points ) );
+        } else {
+            draw_layers( draw_points, 0 );
         }
-        // display number of monsters to spawn in mapgen preview
-        for( const auto &p : draw_points ) {
-            const auto mon_override = monster_override.find( p.pos );
-            if( mon_override != monster_override.end() ) {
-                const int count = std::get<1>( mon_override->second );
-                const bool more = std::get<2>( mon_override->second );
-                if( count > 1 || more ) {
-                    std::string text = "x" + std::to_string( count );
-                    if( more ) {
-                        text += "+";
-                    }
-                    overlay_strings.emplace( player_to_screen( p.pos.xy() ) + point( tile_width / 2, 0 ),
-                                             formatted_text( text, catacurses::red, direction::NORTH ) );
-                }
+    }
+    if( use_map_layer ) {
+        update_map_layer( clipRect, center, s, layer_cells );
+        for( std::vector<tile_render_info> &draw_points : layer_rows ) {
+            for( tile_render_info &p : draw_points ) {
+                const point cell = p.pos.xy() - o;
+                p.height_3d = layer_cells[cell.y * s.x + cell.x].height_3d;
             }
+            draw_layers( draw_points, first_layer_above_map );
         }
     }
     // tile overrides are already drawn in the previous code
@@ -1631,6 +1693,126 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                   "SDL_RenderSetClipRect failed" );
 }
 
+bool cata_tiles::map_layer_cell::same_look( const map_layer_cell &other ) const
+{
+    return effect == other.effect && drawn == other.drawn && ll == other.ll &&
+           std::equal( invisible, invisible + 5, other.invisible );
+}
+
+bool cata_tiles::can_use_map_layer() const
+{
+    // Cells are redrawn independently, so sprites must not cover their neighbors,
+    // and overridden tiles are never kept.
+    return get_option<bool>( "CACHE_MAP_LAYER" ) && !tile_iso &&
+           tileset_ptr->get_sprites_fit_tiles() &&
+           tileset_ptr->get_tile_width() == tileset_ptr->get_tile_height() &&
+           terrain_override.empty() && furniture_override.empty() && graffiti_override.empty();
+}
+
+void cata_tiles::update_map_layer( const SDL_Rect &clip, const tripoint &center,
+                                   const point &tiles, std::vector<map_layer_cell> &frame_cells )
+{
+    const point size( tiles.x * tile_width, tiles.y * tile_height );
+    const point tile_size( tile_width, tile_height );
+    std::vector<std::uint64_t> map_stamps = g->m.display_stamps( center.z );
+    const season_type season = season_of_year( calendar::turn );
+    const bool animations = idle_animations.enabled();
+
+    if( !map_layer.texture || map_layer.size != size ) {
+        map_layer.texture = CreateTexture( renderer, SDL_PIXELFORMAT_ARGB8888,
+                                           SDL_TEXTUREACCESS_TARGET, size.x, size.y );
+        map_layer.spare = CreateTexture( renderer, SDL_PIXELFORMAT_ARGB8888,
+                                         SDL_TEXTUREACCESS_TARGET, size.x, size.y );
+        map_layer.size = size;
+        map_layer.cells.clear();
+    }
+    if( map_layer.tile_size != tile_size || map_layer.zlev != center.z ||
+        map_layer.map_stamps != map_stamps || map_layer.season != season ||
+        map_layer.nv_goggles != nv_goggles_activated || map_layer.animations != animations ) {
+        map_layer.cells.clear();
+    }
+    const point shift = o - map_layer.origin;
+    if( !map_layer.cells.empty() && shift != point_zero ) {
+        if( std::abs( shift.x ) < tiles.x && std::abs( shift.y ) < tiles.y ) {
+            // move what is still in view, the cells that came into view are redrawn below
+            SetRenderTarget( renderer, map_layer.spare );
+            const SDL_Rect moved{ -shift.x * tile_width, -shift.y * tile_height, size.x, size.y };
+            RenderCopy( renderer, map_layer.texture, nullptr, &moved );
+            std::swap( map_layer.texture, map_layer.spare );
+            std::vector<map_layer_cell> moved_cells( map_layer.cells.size() );
+            const half_open_rectangle<point> bounds( point_zero, tiles );
+            for( int y = 0; y < tiles.y; y++ ) {
+                for( int x = 0; x < tiles.x; x++ ) {
+                    const point from = point( x, y ) + shift;
+                    if( bounds.contains( from ) ) {
+                        moved_cells[y * tiles.x + x] = map_layer.cells[from.y * tiles.x + from.x];
+                    }
+                }
+            }
+            map_layer.cells = std::move( moved_cells );
+        } else {
+            map_layer.cells.clear();
+        }
+    }
+    map_layer.cells.resize( frame_cells.size() );
+    map_layer.tile_size = tile_size;
+    map_layer.origin = o;
+    map_layer.zlev = center.z;
+    map_layer.map_stamps = std::move( map_stamps );
+    map_layer.season = season;
+    map_layer.nv_goggles = nv_goggles_activated;
+    map_layer.animations = animations;
+
+    SetRenderTarget( renderer, map_layer.texture );
+    // draw relative to the texture
+    const point screen_offset = op;
+    op = point_zero;
+    const bool animations_present = idle_animations.present();
+    bool layer_animated = false;
+    for( size_t i = 0; i < frame_cells.size(); i++ ) {
+        map_layer_cell &cell = frame_cells[i];
+        map_layer_cell &cached = map_layer.cells[i];
+        if( cached.valid && !cached.animated && cached.same_look( cell ) ) {
+            cell.height_3d = cached.height_3d;
+            continue;
+        }
+        const tripoint pos( o + point( i % tiles.x, i / tiles.x ), center.z );
+        const point cell_pos = player_to_screen( pos.xy() );
+        const SDL_Rect cell_rect{ cell_pos.x, cell_pos.y, tile_width, tile_height };
+        SetRenderDrawColor( renderer, 0x00, 0x00, 0x00, 0x00 );
+        RenderFillRect( renderer, &cell_rect );
+        idle_animations.clear_present();
+        if( cell.effect != VIS_CLEAR ) {
+            apply_vision_effects( pos, cell.effect );
+        }
+        int height_3d = 0;
+        if( cell.drawn ) {
+            // Tiles that are not redrawn are not memorized again either, that only
+            // happens once they change.
+            draw_terrain( pos, cell.ll, height_3d, cell.invisible );
+            draw_furniture( pos, cell.ll, height_3d, cell.invisible );
+            draw_graffiti( pos, cell.ll, height_3d, cell.invisible );
+        }
+        cell.height_3d = height_3d;
+        cell.valid = true;
+        cell.animated = idle_animations.present();
+        layer_animated |= cell.animated;
+        cached = cell;
+    }
+    if( animations_present || layer_animated ) {
+        idle_animations.mark_present();
+    } else {
+        idle_animations.clear_present();
+    }
+    op = screen_offset;
+
+    set_displaybuffer_rendertarget();
+    printErrorIf( SDL_RenderSetClipRect( renderer.get(), &clip ) != 0,
+                  "SDL_RenderSetClipRect failed" );
+    const SDL_Rect layer_rect{ clip.x, clip.y, size.x, size.y };
+    RenderCopy( renderer, map_layer.texture, nullptr, &layer_rect );
+}
+
 bool cata_tiles::terrain_requires_animation() const
 {
     return idle_animations.enabled() && idle_animations.present();
@@ -1782,6 +1964,51 @@ cata_tiles::find_tile_looks_like( const std::string &id, TILE_CATEGORY category,
     }
 }
 
+void cata_tiles::clear_resolved_tiles()
+{
+    resolved_tiles = tile_resolution_cache();
+}
+
+void cata_tiles::resolve_variant( resolved_variant &variant, const std::string &id,
+                                  TILE_CATEGORY category ) const
+{
+    variant.resolved = true;
+    variant.res = find_tile_looks_like( id, category );
+    variant.fixed_furniture = false;
+    if( category == C_FURNITURE ) {
+        // If the furniture is not movable, we'll allow seeding by the position
+        // since we won't get the behavior that occurs where the tile constantly
+        // changes when the player grabs the furniture and drags it, causing the
+        // seed to change.
+        const furn_str_id fid( variant.res ? variant.res->id() : id );
+        variant.fixed_furniture = fid.is_valid() && !fid.obj().is_movable();
+    }
+}
+
+cata_tiles::resolved_tile &cata_tiles::resolve_tile( const std::string &id,
+        TILE_CATEGORY category, int id_index )
+{
+    const season_type season = season_of_year( calendar::turn );
+    if( resolved_tiles.season != season ) {
+        clear_resolved_tiles();
+        resolved_tiles.season = season;
+    }
+    resolved_tile *tile;
+    if( id_index >= 0 ) {
+        std::vector<resolved_tile> &tiles = resolved_tiles.by_int_id[category];
+        if( static_cast<size_t>( id_index ) >= tiles.size() ) {
+            tiles.resize( id_index + 1 );
+        }
+        tile = &tiles[id_index];
+    } else {
+        tile = &resolved_tiles.by_string_id[category][id];
+    }
+    if( !tile->base.resolved ) {
+        resolve_variant( tile->base, id, category );
+    }
+    return *tile;
+}
+
 bool cata_tiles::find_overlay_looks_like( const bool male, const std::string &overlay,
         std::string &draw_id )
 {
@@ -1827,7 +2054,8 @@ bool cata_tiles::find_overlay_looks_like( const bool male, const std::string &ov
 bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                       const std::string &subcategory, const tripoint &pos,
                                       int subtile, int rota, lit_level ll,
-                                      bool apply_night_vision_goggles, int &height_3d )
+                                      bool apply_night_vision_goggles, int &height_3d,
+                                      int id_index )
 {
     // If the ID string does not produce a drawable tile
     // it will revert to the "unknown" tile.
@@ -1842,12 +2070,13 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
         return false;
     }
 
-    cata::optional<tile_lookup_res> res = find_tile_looks_like( id, category );
+    resolved_tile &resolved = resolve_tile( id, category, id_index );
+    const resolved_variant *variant = &resolved.base;
     const tile_type *tt = nullptr;
-    if( res ) {
-        tt = &( res->tile() );
+    if( variant->res ) {
+        tt = &( variant->res->tile() );
     }
-    const std::string &found_id = res ? ( res->id() ) : id;
+    const std::string &found_id = variant->res ? ( variant->res->id() ) : id;
 
     if( !tt ) {
         uint32_t sym = UNKNOWN_UNICODE;
@@ -2027,18 +2256,29 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
         return false;
     }
 
-    const tile_type &display_tile = *tt;
     // check to see if the display_tile is multitile, and if so if it has the key related to subtile
-    if( subtile != -1 && display_tile.multitile ) {
-        const auto &display_subtiles = display_tile.available_subtiles;
+    if( subtile != -1 && tt->multitile ) {
+        const auto &display_subtiles = tt->available_subtiles;
         const auto end = std::end( display_subtiles );
         if( std::find( begin( display_subtiles ), end, multitile_keys[subtile] ) != end ) {
             // append subtile name to tile and re-find display_tile
-            return draw_from_id_string( found_id + "_" + multitile_keys[subtile],
-                                        category, subcategory, pos, -1, rota, ll, apply_night_vision_goggles,
-                                        height_3d );
+            resolved_variant &sub = resolved.subtiles[subtile];
+            if( !sub.resolved ) {
+                resolve_variant( sub, found_id + "_" + multitile_keys[subtile], category );
+            }
+            if( !sub.res ) {
+                // falls back to the generic tiles of the subtile id
+                return draw_from_id_string( found_id + "_" + multitile_keys[subtile],
+                                            category, subcategory, pos, -1, rota, ll, apply_night_vision_goggles,
+                                            height_3d );
+            }
+            variant = &sub;
+            tt = &( sub.res->tile() );
+            subtile = -1;
         }
     }
+    const tile_type &display_tile = *tt;
+    const std::string &display_id = variant->res ? variant->res->id() : found_id;
 
     // translate from player-relative to screen relative tile position
     const point screen_pos = player_to_screen( pos.xy() );
@@ -2090,20 +2330,11 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
 
         }
         break;
-        case C_FURNITURE: {
-            // If the furniture is not movable, we'll allow seeding by the position
-            // since we won't get the behavior that occurs where the tile constantly
-            // changes when the player grabs the furniture and drags it, causing the
-            // seed to change.
-            const furn_str_id fid( found_id );
-            if( fid.is_valid() ) {
-                const furn_t &f = fid.obj();
-                if( !f.is_movable() ) {
-                    seed = simple_point_hash( g->m.getabs( pos ) );
-                }
+        case C_FURNITURE:
+            if( variant->fixed_furniture ) {
+                seed = simple_point_hash( g->m.getabs( pos ) );
             }
-        }
-        break;
+            break;
         case C_ITEM:
         case C_TRAP:
             if( seed_for_animation ) {
@@ -2128,12 +2359,12 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
             break;
         default:
             // player
-            if( string_starts_with( found_id, "player_" ) ) {
+            if( string_starts_with( display_id, "player_" ) ) {
                 seed = g->u.name[0];
                 break;
             }
             // NPC
-            if( string_starts_with( found_id, "npc_" ) ) {
+            if( string_starts_with( display_id, "npc_" ) ) {
                 if( npc *const guy = g->critter_at<npc>( pos ) ) {
                     seed = guy->getID().get_value();
                     break;
@@ -2489,7 +2720,7 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         // draw the actual terrain if there's no override
         if( !neighborhood_overridden ) {
             return draw_from_id_string( tname, C_TERRAIN, empty_string, p, subtile, rotation, ll,
-                                        nv_goggles_activated, height_3d );
+                                        nv_goggles_activated, height_3d, t.to_i() );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -2512,7 +2743,7 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
             const lit_level lit = overridden ? lit_level::LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
             return draw_from_id_string( tname, C_TERRAIN, empty_string, p, subtile, rotation, lit, nv,
-                                        height_3d );
+                                        height_3d, t2.to_i() );
         }
     } else if( invisible[0] && has_terrain_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
@@ -2653,7 +2884,7 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
         // draw the actual furniture if there's no override
         if( !neighborhood_overridden ) {
             return draw_from_id_string( fname, C_FURNITURE, empty_string, p, subtile, rotation, ll,
-                                        nv_goggles_activated, height_3d );
+                                        nv_goggles_activated, height_3d, f.to_i() );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -2682,7 +2913,7 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
             const lit_level lit = overridden ? lit_level::LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
             return draw_from_id_string( fname, C_FURNITURE, empty_string, p, subtile, rotation, lit, nv,
-                                        height_3d );
+                                        height_3d, f2.to_i() );
         }
     } else if( invisible[0] && has_furniture_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
@@ -2727,7 +2958,7 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
         // draw the actual trap if there's no override
         if( !neighborhood_overridden ) {
             return draw_from_id_string( trname, C_TRAP, empty_string, p, subtile, rotation, ll,
-                                        nv_goggles_activated, height_3d );
+                                        nv_goggles_activated, height_3d, tr.to_i() );
         }
     }
     if( overridden || ( !invisible[0] && neighborhood_overridden && tr.obj().can_see( p, g->u ) ) ) {
@@ -2756,7 +2987,7 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
             const lit_level lit = overridden ? lit_level::LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
             return draw_from_id_string( trname, C_TRAP, empty_string, p, subtile, rotation, lit, nv,
-                                        height_3d );
+                                        height_3d, tr2.to_i() );
         }
     } else if( invisible[0] && has_trap_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
@@ -2809,8 +3040,9 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, const lit_level ll, int
         int rotation = 0;
         get_tile_values( fld.to_i(), neighborhood, subtile, rotation );
 
+        int nullint = 0;
         ret_draw_field = draw_from_id_string( fld.id().str(), C_FIELD, empty_string, p, subtile,
-                                              rotation, lit, nv );
+                                              rotation, lit, nv, nullint, fld.to_i() );
     }
     if( fld.obj().display_items ) {
         const auto it_override = item_override.find( p );
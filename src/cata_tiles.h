@@ -2,7 +2,9 @@
 #ifndef CATA_SRC_CATA_TILES_H
 #define CATA_SRC_CATA_TILES_H
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -12,6 +14,7 @@
 #include <vector>
 
 #include "animation.h"
+#include "calendar.h"
 #include "creature.h"
 #include "enums.h"
 #include "lightmap.h"
@@ -70,10 +73,10 @@ class tile_lookup_res
         tile_type *_tile;
     public:
         tile_lookup_res( const std::string &id, tile_type &tile ): _id( &id ), _tile( &tile ) {}
-        inline const std::string &id() {
+        inline const std::string &id() const {
             return *_id;
         }
-        inline tile_type &tile() {
+        inline tile_type &tile() const {
             return *_tile;
         }
 };
@@ -120,6 +123,9 @@ class tileset
         // multiplier for pixel-doubling tilesets
         float tile_pixelscale;
 
+        // false if some sprites are drawn outside of the tile they belong to
+        bool sprites_fit_tiles = true;
+
         std::vector<texture> tile_values;
         std::vector<texture> shadow_tile_values;
         std::vector<texture> night_tile_values;
@@ -148,6 +154,9 @@ class tileset
         float get_tile_pixelscale() const {
             return tile_pixelscale;
         }
+        bool get_sprites_fit_tiles() const {
+            return sprites_fit_tiles;
+        }
         const std::string &get_tileset_id() const {
             return tileset_id;
         }
@@ -314,6 +323,11 @@ class idle_animation_manager
             present_ = true;
         }
 
+        /** Forget the idle animations marked so far */
+        inline void clear_present() {
+            present_ = false;
+        }
+
         /** Whether there are idle animations on screen */
         inline bool present() const {
             return present_;
@@ -378,9 +392,14 @@ class cata_tiles
                                   lit_level ll, bool apply_night_vision_goggles );
         bool draw_from_id_string( const std::string &id, const tripoint &pos, int subtile, int rota,
                                   lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        /**
+         * @param id_index The int_id of @p id, for categories of types that have one. The
+         * tile lookup is then cached by it rather than by the string.
+         */
         bool draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                   const std::string &subcategory, const tripoint &pos, int subtile, int rota,
-                                  lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+                                  lit_level ll, bool apply_night_vision_goggles, int &height_3d,
+                                  int id_index = -1 );
         bool draw_sprite_at(
             const tile_type &tile, const weighted_int_list<std::vector<int>> &svlist,
             const point &, unsigned int loc_rand, bool rota_fg, int rota, lit_level ll,
@@ -544,6 +563,8 @@ class cata_tiles
          * @throw std::exception On any error.
          */
         void reinit();
+        /** Redraws the whole map layer next frame, e.g. after the render targets were lost. */
+        void invalidate_map_layer();
 
         int get_tile_height() const {
             return tile_height;
@@ -583,6 +604,86 @@ class cata_tiles
         /** Lighting */
         void init_light();
 
+        /** A tile lookup, see find_tile_looks_like(). */
+        struct resolved_variant {
+            bool resolved = false;
+            cata::optional<tile_lookup_res> res;
+            // Furniture that can not move is seeded by its position
+            bool fixed_furniture = false;
+        };
+        struct resolved_tile {
+            resolved_variant base;
+            // Lookups of "<found id>_<multitile key>", by subtile
+            std::array<resolved_variant, 8> subtiles;
+        };
+        /**
+         * Following looks_like chains needs a string lookup per step, so the draw path
+         * looks tiles up once and keeps the result here. Terrain, furniture, traps and
+         * fields are kept by int_id, everything else by string id. Results depend on
+         * the tileset, the loaded game data and the season.
+         */
+        struct tile_resolution_cache {
+            season_type season = season_type::NUM_SEASONS;
+            std::array<std::vector<resolved_tile>, C_OVERMAP_NOTE + 1> by_int_id;
+            std::array<std::unordered_map<std::string, resolved_tile>, C_OVERMAP_NOTE + 1> by_string_id;
+        };
+        tile_resolution_cache resolved_tiles;
+
+        resolved_tile &resolve_tile( const std::string &id, TILE_CATEGORY category, int id_index );
+        /** Drops all lookups, for when the tileset or the game data changes. */
+        void clear_resolved_tiles();
+
+        /** What is drawn into one cell of the map layer. */
+        struct map_layer_cell {
+            // false if the cell has to be redrawn
+            bool valid = false;
+            // has idle animations, so it is redrawn every frame
+            bool animated = false;
+            // vision effect drawn below the map, VIS_CLEAR if none
+            visibility_type effect = VIS_CLEAR;
+            // whether terrain, furniture and graffiti are drawn
+            bool drawn = false;
+            lit_level ll = lit_level::DARK;
+            bool invisible[5] = {};
+            // height_3d after drawing the cell
+            int height_3d = 0;
+
+            bool same_look( const map_layer_cell &other ) const;
+        };
+        /**
+         * Terrain, furniture and graffiti of the visible area, kept in a texture between
+         * frames so only the cells whose look changed are redrawn, and scrolling only
+         * draws the cells that came into view. Everything else is drawn on top of it.
+         * Only used when every sprite stays inside its own cell, see can_use_map_layer().
+         */
+        struct map_layer_cache {
+            SDL_Texture_Ptr texture;
+            // the texture is copied into this one when the view scrolls
+            SDL_Texture_Ptr spare;
+            point size;
+            point tile_size;
+            point origin;
+            int zlev = 0;
+            // of the submaps, see map::display_stamps()
+            std::vector<std::uint64_t> map_stamps;
+            season_type season = season_type::NUM_SEASONS;
+            bool nv_goggles = false;
+            bool animations = false;
+            std::vector<map_layer_cell> cells;
+        };
+        map_layer_cache map_layer;
+
+        bool can_use_map_layer() const;
+        /**
+         * Redraws the cells of the map layer that differ from @p frame_cells (one per
+         * tile of the @p tiles sized view, by rows) and copies the layer to @p clip.
+         * Sets the height_3d of @p frame_cells.
+         */
+        void update_map_layer( const SDL_Rect &clip, const tripoint &center, const point &tiles,
+                               std::vector<map_layer_cell> &frame_cells );
+        void resolve_variant( resolved_variant &variant, const std::string &id,
+                              TILE_CATEGORY category ) const;
+
         /** Variables */
         const SDL_Renderer_Ptr &renderer;
         const GeometryRenderer_Ptr &geometry;
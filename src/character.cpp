@@ -7769,8 +7769,85 @@ std::string Character::get_highest_category() const
     return sMaxCat;
 }
 
+bool Character::update_enchantment_sources()
+{
+    bool changed = false;
+    size_t checked = 0;
+    // Only look at the map if it matters, it might not even be loaded yet
+    bool water_matters = false;
+    const auto note_water = [&]( const enchantment & ench ) {
+        water_matters = water_matters || ench.needs_water();
+    };
+    visit_items( [&]( item * it ) {
+        if( it->get_enchantments().empty() ) {
+            return VisitResponse::NEXT;
+        }
+        for( const enchantment &ench : it->get_enchantments() ) {
+            note_water( ench );
+        }
+        const int state = ( it->active ? 1 : 0 ) | ( is_wielding( *it ) ? 2 : 0 ) |
+                          ( is_worn( *it ) ? 4 : 0 );
+        // The reference breaks when the item is destroyed or replaced, so another item
+        // that ends up at the same address is not mistaken for it
+        if( !changed && checked < enchantment_items.size() &&
+            enchantment_items[checked].first.get() == it &&
+            enchantment_items[checked].second == state ) {
+            checked++;
+            return VisitResponse::NEXT;
+        }
+        if( !changed ) {
+            changed = true;
+            enchantment_items.erase( enchantment_items.begin() + checked, enchantment_items.end() );
+        }
+        enchantment_items.emplace_back( it->get_safe_reference(), state );
+        return VisitResponse::NEXT;
+    } );
+    if( !changed && checked != enchantment_items.size() ) {
+        changed = true;
+        enchantment_items.erase( enchantment_items.begin() + checked, enchantment_items.end() );
+    }
+
+    bool sources_changed = false;
+    checked = 0;
+    const auto note = [&]( const void *source, int state ) {
+        if( !sources_changed && checked < enchantment_sources.size() &&
+            enchantment_sources[checked] == std::make_pair( source, state ) ) {
+            checked++;
+            return;
+        }
+        if( !sources_changed ) {
+            sources_changed = true;
+            enchantment_sources.erase( enchantment_sources.begin() + checked, enchantment_sources.end() );
+        }
+        enchantment_sources.emplace_back( source, state );
+    };
+    // All mutations, the cached mutations depend on them as well
+    for( const std::pair<const trait_id, trait_data> &mut : my_mutations ) {
+        note( &mut.first.obj(), mut.second.powered );
+        for( const enchantment_id &ench_id : mut.first->enchantments ) {
+            note_water( ench_id.obj() );
+        }
+    }
+    for( const bionic &bio : *my_bionics ) {
+        note( &bio.id.obj(), bio.powered );
+        for( const enchantment_id &ench_id : bio.id->enchantments ) {
+            note_water( ench_id.obj() );
+        }
+    }
+    note( nullptr, ( pos().z < 0 ? 1 : 0 ) |
+          ( water_matters && get_map().is_divable( pos() ) ? 2 : 0 ) );
+    if( !sources_changed && checked != enchantment_sources.size() ) {
+        sources_changed = true;
+        enchantment_sources.erase( enchantment_sources.begin() + checked, enchantment_sources.end() );
+    }
+    return changed || sources_changed;
+}
+
 void Character::recalculate_enchantment_cache()
 {
+    if( !update_enchantment_sources() ) {
+        return;
+    }
     // start by resetting the cache
     *enchantment_cache = enchantment();
 
@@ -43,6 +43,7 @@
 #include "pldata.h"
 #include "point.h"
 #include "ret_val.h"
+#include "safe_reference.h"
 #include "stomach.h"
 #include "string_formatter.h"
 #include "type_id.h"
@@ -901,6 +902,7 @@ class Character : public Creature, public visitable<Character>
 
     public:
         // recalculates enchantment cache by iterating through all held, worn, and wielded items
+        // does nothing if none of them, the mutations or the bionics changed since the last time
         void recalculate_enchantment_cache();
         void rebuild_mutation_cache();
 
@@ -2257,6 +2259,16 @@ class Character : public Creature, public visitable<Character>
         // a cache of all active enchantment values.
         // is recalculated every turn in Character::recalculate_enchantment_cache
         pimpl<enchantment> enchantment_cache;
+        // What enchantment_cache was calculated from: the enchanted items with
+        // their state, then everything else. See update_enchantment_sources.
+        std::vector<std::pair<safe_reference<item>, int>> enchantment_items;
+        std::vector<std::pair<const void *, int>> enchantment_sources;
+        /**
+         * Compares what the active enchantments depend on against what they were
+         * last calculated from, and records the new state if it changed.
+         * @return Whether anything changed.
+         */
+        bool update_enchantment_sources();
 
         /** Amount of time the player has spent in each overmap tile. */
         std::unordered_map<point_abs_omt, time_duration> overmap_time;
@@ -283,6 +283,9 @@ bool Creature::sees( const tripoint &t, bool is_avatar, int range_mod ) const
             int adj_range = std::floor( range * player_visibility_factor );
             return adj_range >= wanted_range &&
                    g->m.get_cache_ref( pos().z ).seen_cache[pos().x][pos().y] > LIGHT_TRANSPARENCY_SOLID;
+        } else if( const cata::optional<bool> perceived = g->m.perceived( t, pos() ) ) {
+            // Vision was already cast from there this turn
+            return *perceived && wanted_range <= range;
         } else {
             return g->m.sees( pos(), t, range );
         }
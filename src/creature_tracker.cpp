@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -32,6 +34,48 @@ shared_ptr_fast<monster> Creature_tracker::find( const tripoint &pos ) const
     return nullptr;
 }
 
+static point bucket_of( const tripoint &pos, int bucket_size )
+{
+    return divide_xy_round_to_minus_infinity( pos.xy(), bucket_size );
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_near( const tripoint &center,
+                                   const int radius ) const
+{
+    std::vector<shared_ptr_fast<monster>> ret;
+    if( radius < 0 ) {
+        return ret;
+    }
+    const point min = bucket_of( center - tripoint( radius, radius, 0 ), bucket_size );
+    const point max = bucket_of( center + tripoint( radius, radius, 0 ), bucket_size );
+    const auto add_in_range = [&]( const std::vector<shared_ptr_fast<monster>> &bucket ) {
+        for( const shared_ptr_fast<monster> &mon_ptr : bucket ) {
+            const tripoint &pos = mon_ptr->pos();
+            if( !mon_ptr->is_dead() && std::abs( pos.x - center.x ) <= radius &&
+                std::abs( pos.y - center.y ) <= radius ) {
+                ret.push_back( mon_ptr );
+            }
+        }
+    };
+    // Large areas contain more buckets than there are occupied ones
+    const int64_t area = static_cast<int64_t>( max.x - min.x + 1 ) * ( max.y - min.y + 1 );
+    if( area > static_cast<int64_t>( monsters_by_bucket.size() ) ) {
+        for( const auto &bucket : monsters_by_bucket ) {
+            add_in_range( bucket.second );
+        }
+        return ret;
+    }
+    for( int y = min.y; y <= max.y; ++y ) {
+        for( int x = min.x; x <= max.x; ++x ) {
+            const auto iter = monsters_by_bucket.find( point( x, y ) );
+            if( iter != monsters_by_bucket.end() ) {
+                add_in_range( iter->second );
+            }
+        }
+    }
+    return ret;
+}
+
 int Creature_tracker::temporary_id( const monster &critter ) const
 {
     const auto iter = std::find_if( monsters_list.begin(), monsters_list.end(),
@@ -87,10 +131,47 @@ bool Creature_tracker::add( shared_ptr_fast<monster> critter_ptr )
 
     monsters_list.emplace_back( critter_ptr );
     monsters_by_location[critter.pos()] = critter_ptr;
+    add_to_buckets( critter_ptr, critter.pos() );
     add_to_faction_map( critter_ptr );
     return true;
 }
 
+void Creature_tracker::add_to_buckets( const shared_ptr_fast<monster> &critter,
+                                       const tripoint &pos )
+{
+    monsters_by_bucket[bucket_of( pos, bucket_size )].push_back( critter );
+}
+
+void Creature_tracker::remove_from_buckets( const monster &critter, const tripoint &pos )
+{
+    const auto is_critter = [&]( const shared_ptr_fast<monster> &ptr ) {
+        return ptr.get() == &critter;
+    };
+    const auto remove_from = [&]( decltype( monsters_by_bucket )::iterator bucket_iter ) {
+        std::vector<shared_ptr_fast<monster>> &bucket = bucket_iter->second;
+        const auto iter = std::find_if( bucket.begin(), bucket.end(), is_critter );
+        if( iter == bucket.end() ) {
+            return false;
+        }
+        *iter = std::move( bucket.back() );
+        bucket.pop_back();
+        if( bucket.empty() ) {
+            monsters_by_bucket.erase( bucket_iter );
+        }
+        return true;
+    };
+    const auto bucket_iter = monsters_by_bucket.find( bucket_of( pos, bucket_size ) );
+    if( bucket_iter != monsters_by_bucket.end() && remove_from( bucket_iter ) ) {
+        return;
+    }
+    // Like in remove_from_location_map, it might be filed under another location.
+    for( auto iter = monsters_by_bucket.begin(); iter != monsters_by_bucket.end(); ++iter ) {
+        if( remove_from( iter ) ) {
+            return;
+        }
+    }
+}
+
 void Creature_tracker::add_to_faction_map( shared_ptr_fast<monster> critter_ptr )
 {
     assert( critter_ptr );
@@ -138,6 +219,10 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
     if( iter != monsters_list.end() ) {
         monsters_by_location.erase( critter.pos() );
         monsters_by_location[new_pos] = *iter;
+        if( bucket_of( critter.pos(), bucket_size ) != bucket_of( new_pos, bucket_size ) ) {
+            remove_from_buckets( critter, critter.pos() );
+            add_to_buckets( *iter, new_pos );
+        }
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -154,6 +239,8 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
 
 void Creature_tracker::remove_from_location_map( const monster &critter )
 {
+    remove_from_buckets( critter, critter.pos() );
+
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
         monsters_by_location.erase( pos_iter );
@@ -200,6 +287,7 @@ void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_bucket.clear();
     monster_faction_map_.clear();
     removed_.clear();
 }
@@ -207,9 +295,11 @@ void Creature_tracker::clear()
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_bucket.clear();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
         monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        add_to_buckets( mon_ptr, mon_ptr->pos() );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -229,12 +319,14 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
         monsters_by_location.erase( first_iter );
+        remove_from_buckets( *first_ptr, first.pos() );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
         monsters_by_location.erase( second_iter );
+        remove_from_buckets( *second_ptr, second.pos() );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -245,9 +337,11 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
         monsters_by_location[first.pos()] = first_ptr;
+        add_to_buckets( first_ptr, first.pos() );
     }
     if( second_ptr ) {
         monsters_by_location[second.pos()] = second_ptr;
+        add_to_buckets( second_ptr, second.pos() );
     }
 }
 
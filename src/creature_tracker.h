@@ -49,6 +49,12 @@ class Creature_tracker
          * Dead monsters are ignored and not returned.
          */
         shared_ptr_fast<monster> find( const tripoint &pos ) const;
+        /**
+         * Returns the monsters whose x and y coordinates are at most @p radius away from
+         * those of @p center, on any z-level, in no particular order.
+         * Dead monsters are ignored and not returned.
+         */
+        std::vector<shared_ptr_fast<monster>> find_near( const tripoint &center, int radius ) const;
         /**
          * Returns a temporary id of the given monster (which must exist in the tracker).
          * The id is valid until monsters are added or removed from the tracker.
@@ -94,8 +100,17 @@ class Creature_tracker
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
+        /** Width of the square areas @ref monsters_by_bucket groups monsters by. */
+        static constexpr int bucket_size = 16;
+        /**
+         * The monsters of @ref monsters_by_location grouped by the area their x and y
+         * coordinates are in, so @ref find_near only visits the areas in range.
+         */
+        std::unordered_map<point, std::vector<shared_ptr_fast<monster>>> monsters_by_bucket;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        void add_to_buckets( const shared_ptr_fast<monster> &critter, const tripoint &pos );
+        void remove_from_buckets( const monster &critter, const tripoint &pos );
 };
 
 #endif // CATA_SRC_CREATURE_TRACKER_H
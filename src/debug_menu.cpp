@@ -55,6 +55,7 @@
 #include "map.h"
 #include "map_extras.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapgen.h"
 #include "mapgendata.h"
 #include "martialarts.h"
@@ -74,6 +75,7 @@
 #include "overmap.h"
 #include "overmap_ui.h"
 #include "overmapbuffer.h"
+#include "path_info.h"
 #include "pimpl.h"
 #include "player.h"
 #include "pldata.h"
@@ -88,6 +90,7 @@
 #include "string_input_popup.h"
 #include "string_utils.h"
 #include "trait_group.h"
+#include "turn_profiler.h"
 #include "translations.h"
 #include "type_id.h"
 #include "ui.h"
@@ -176,7 +179,10 @@ enum debug_menu_index {
     DEBUG_TEST_MAP_EXTRA_DISTRIBUTION,
     DEBUG_VEHICLE_BATTERY_CHARGE,
     DEBUG_HOUR_TIMER,
-    DEBUG_NESTED_MAPGEN
+    DEBUG_TURN_PROFILER,
+    DEBUG_TURN_PROFILER_REPORT,
+    DEBUG_NESTED_MAPGEN,
+    DEBUG_CONVERT_MAP_SAVES
 };
 
 class mission_debug
@@ -223,6 +229,8 @@ static int info_uilist( bool display_all_entries = true )
             { uilist_entry( DEBUG_BENCHMARK, true, 'b', _( "Draw benchmark" ) ) },
             { uilist_entry( DEBUG_BENCHMARK_FPS, true, 'B', _( "FPS benchmark" ) ) },
             { uilist_entry( DEBUG_HOUR_TIMER, true, 'E', _( "Toggle hour timer" ) ) },
+            { uilist_entry( DEBUG_TURN_PROFILER, true, 'P', _( "Toggle turn profiler" ) ) },
+            { uilist_entry( DEBUG_TURN_PROFILER_REPORT, true, 'F', _( "Write turn profiler report" ) ) },
             { uilist_entry( DEBUG_TRAIT_GROUP, true, 't', _( "Test trait group" ) ) },
             { uilist_entry( DEBUG_SHOW_MSG, true, 'd', _( "Show debug message" ) ) },
             { uilist_entry( DEBUG_CRASH_GAME, true, 'C', _( "Crash game (test crash handling)" ) ) },
@@ -291,6 +299,7 @@ static int map_uilist()
         { uilist_entry( DEBUG_OM_EDITOR, true, 'O', _( "Overmap editor" ) ) },
         { uilist_entry( DEBUG_MAP_EXTRA, true, 'm', _( "Spawn map extra" ) ) },
         { uilist_entry( DEBUG_NESTED_MAPGEN, true, 'n', _( "Spawn nested mapgen" ) ) },
+        { uilist_entry( DEBUG_CONVERT_MAP_SAVES, true, 'c', _( "Convert saved maps to the current save format" ) ) },
     };
 
     return uilist( _( "Map…" ), uilist_initializer );
@@ -1749,6 +1758,31 @@ void debug()
         case DEBUG_HOUR_TIMER:
             g->toggle_debug_hour_timer();
             break;
+        case DEBUG_TURN_PROFILER: {
+            const bool enable = !turn_profiler::is_enabled();
+            if( enable ) {
+                turn_profiler::reset();
+            }
+            turn_profiler::set_enabled( enable );
+            turn_profiler::set_overlay_enabled( enable );
+            add_msg( m_info, _( "Turn profiler %s." ), enable ? _( "enabled" ) : _( "disabled" ) );
+            break;
+        }
+        case DEBUG_TURN_PROFILER_REPORT: {
+            const std::string json_path = PATH_INFO::user_dir() + "turn_profile.json";
+            const std::string csv_path = PATH_INFO::user_dir() + "turn_profile.csv";
+            if( turn_profiler::write_report( json_path, csv_path ) ) {
+                add_msg( m_info, _( "Turn profile of %1$d turns written to %2$s and %3$s." ),
+                         turn_profiler::recorded_turns(), json_path, csv_path );
+            }
+            break;
+        }
+        case DEBUG_CONVERT_MAP_SAVES: {
+            const int converted = MAPBUFFER.convert_saved_quads();
+            add_msg( m_info, _( "Converted %1$d map quads to the %2$s format." ), converted,
+                     get_option<std::string>( "MAP_SAVE_FORMAT" ) );
+            break;
+        }
         case DEBUG_CHANGE_TIME: {
             auto set_turn = [&]( const int initial, const time_duration & factor, const char *const msg ) {
                 const auto text = string_input_popup()
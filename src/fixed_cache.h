@@ -0,0 +1,131 @@
+#pragma once
+#ifndef CATA_SRC_FIXED_CACHE_H
+#define CATA_SRC_FIXED_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lossy hash table with a fixed number of entries, for memoizing the results
+ * of expensive queries on hot paths.
+ *
+ * Keys are 64 bit integers the caller packs its query into, every key maps
+ * to a bucket of four entries and inserting into a full bucket overwrites one
+ * of them. The storage is allocated once on the first insertion, after that
+ * neither lookups nor insertions allocate.
+ *
+ * Every entry remembers the stamp it was inserted at. Clearing the cache just
+ * advances the stamp, and callers can invalidate parts of the cache by
+ * remembering the stamp they were last invalidated at (see @ref advance) and
+ * passing it to @ref find as the oldest stamp they still accept.
+ */
+template<typename Value>
+class fixed_cache
+{
+    public:
+        /** The cache holds 2 ^ capacity_log2 entries, at least one bucket. */
+        explicit fixed_cache( int capacity_log2 ) :
+            mask( ( std::size_t( 1 ) << std::max( capacity_log2, 2 ) ) - 1 ) {}
+
+        /**
+         * Returns the value stored for the key, nullptr if there is none
+         * or if it was stored before the cache was cleared or before the
+         * given stamp.
+         */
+        const Value *find( std::uint64_t key, std::uint32_t oldest = 0 ) const {
+            if( entries.empty() ) {
+                return nullptr;
+            }
+            oldest = std::max( oldest, cleared_at );
+            const entry *bucket = &entries[bucket_of( key )];
+            for( int i = 0; i < bucket_size; ++i ) {
+                if( bucket[i].key == key && bucket[i].stamp >= oldest ) {
+                    return &bucket[i].value;
+                }
+            }
+            return nullptr;
+        }
+
+        Value get( std::uint64_t key, const Value &default_, std::uint32_t oldest = 0 ) const {
+            const Value *found = find( key, oldest );
+            return found != nullptr ? *found : default_;
+        }
+
+        void insert( std::uint64_t key, const Value &value ) {
+            if( entries.empty() ) {
+                entries.resize( mask + 1 );
+            }
+            entry *bucket = &entries[bucket_of( key )];
+            // Replace the key itself, else an outdated entry, else any entry
+            entry *target = nullptr;
+            for( int i = 0; i < bucket_size; ++i ) {
+                if( bucket[i].key == key ) {
+                    target = &bucket[i];
+                    break;
+                }
+                if( target == nullptr && bucket[i].stamp < cleared_at ) {
+                    target = &bucket[i];
+                }
+            }
+            if( target == nullptr ) {
+                target = &bucket[mix( key ) >> 62];
+            }
+            target->key = key;
+            target->stamp = stamp;
+            target->value = value;
+        }
+
+        /** Drops all entries, in constant time. */
+        void clear() {
+            cleared_at = advance();
+        }
+
+        /**
+         * Starts a new stamp and returns it. Entries stored from now on are
+         * accepted by @ref find when it is given the returned stamp, older ones
+         * are not.
+         */
+        std::uint32_t advance() {
+            if( stamp == UINT32_MAX ) {
+                // Entries from before the wrap-around would look new again
+                std::fill( entries.begin(), entries.end(), entry() );
+                stamp = 1;
+                cleared_at = 1;
+            }
+            return ++stamp;
+        }
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+    private:
+        static constexpr int bucket_size = 4;
+
+        struct entry {
+            std::uint64_t key = 0;
+            // 0 is never a valid stamp, so default entries are always outdated
+            std::uint32_t stamp = 0;
+            Value value = Value();
+        };
+
+        // Finalizer of splitmix64, neighbouring keys end up in unrelated buckets
+        static std::uint64_t mix( std::uint64_t key ) {
+            key = ( key ^ ( key >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+            key = ( key ^ ( key >> 27 ) ) * 0x94d049bb133111ebULL;
+            return key ^ ( key >> 31 );
+        }
+
+        std::size_t bucket_of( std::uint64_t key ) const {
+            return mix( key ) & mask & ~std::size_t( bucket_size - 1 );
+        }
+
+        std::size_t mask;
+        std::uint32_t stamp = 1;
+        std::uint32_t cleared_at = 1;
+        std::vector<entry> entries;
+};
+
+#endif // CATA_SRC_FIXED_CACHE_H
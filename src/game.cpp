@@ -42,6 +42,7 @@
 #include "basecamp.h"
 #include "bionics.h"
 #include "bodypart.h"
+#include "cached_options.h"
 #include "cata_utility.h"
 #include "catacharset.h"
 #include "character.h"
@@ -99,6 +100,7 @@
 #include "map.h"
 #include "map_item_stack.h"
 #include "map_iterator.h"
+#include "map_prefetch.h"
 #include "map_selector.h"
 #include "mapbuffer.h"
 #include "mapdata.h"
@@ -122,6 +124,7 @@
 #include "overmapbuffer.h"
 #include "panels.h"
 #include "path_info.h"
+#include "pathfinding.h"
 #include "pickup.h"
 #include "player.h"
 #include "player_activity.h"
@@ -147,6 +150,7 @@
 #include "timed_event.h"
 #include "translations.h"
 #include "trap.h"
+#include "turn_profiler.h"
 #include "ui.h"
 #include "ui_manager.h"
 #include "uistate.h"
@@ -362,11 +366,12 @@ bool game::check_mod_data( const std::vector<mod_id> &opts, loading_ui &ui )
             std::cerr << "Error loading data from json: " << err.what() << std::endl;
         }
 
-        std::string world_name = world_generator->active_world->world_name;
-        world_generator->delete_world( world_name, true );
-
+        // Waits for the background autosave, which must not write into the deleted world
         MAPBUFFER.reset();
         overmap_buffer.clear();
+
+        std::string world_name = world_generator->active_world->world_name;
+        world_generator->delete_world( world_name, true );
     }
 
     for( const auto &e : check ) {
@@ -410,11 +415,12 @@ bool game::check_mod_data( const std::vector<mod_id> &opts, loading_ui &ui )
             std::cerr << "Error loading data: " << err.what() << std::endl;
         }
 
-        std::string world_name = world_generator->active_world->world_name;
-        world_generator->delete_world( world_name, true );
-
+        // Waits for the background autosave, which must not write into the deleted world
         MAPBUFFER.reset();
         overmap_buffer.clear();
+
+        std::string world_name = world_generator->active_world->world_name;
+        world_generator->delete_world( world_name, true );
     }
     return true;
 }
@@ -602,6 +608,7 @@ void game::setup()
     remoteveh_cache = nullptr;
 
     token_provider_ptr->clear();
+    *prefetcher_ptr = map_prefetcher();
     // back to menu for save loading, new game etc
 }
 
@@ -1246,6 +1253,8 @@ bool game::cleanup_at_end()
                 }
             }
 
+            // Waits for the background autosave, which must not write into the deleted world
+            MAPBUFFER.reset();
             if( queryDelete || get_option<std::string>( "WORLD_END" ) == "delete" ) {
                 world_generator->delete_world( world_generator->active_world->world_name, true );
 
@@ -1413,9 +1422,13 @@ bool game::do_turn()
     if( new_game ) {
         new_game = false;
     } else {
-        gamemode->per_turn();
+        // Headless runs that set up the game state themselves have no game mode
+        if( gamemode ) {
+            gamemode->per_turn();
+        }
         calendar::turn += 1_turns;
     }
+    turn_profiler::begin_turn();
 
     // starting a new turn, clear out temperature cache
     weather_manager &weather = get_weather();
@@ -1461,12 +1474,18 @@ bool game::do_turn()
         autosave();
     }
 
-    weather.update_weather();
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::weather );
+        weather.update_weather();
+    }
     reset_light_level();
 
     perhaps_add_random_npc();
     process_voluntary_act_interrupt();
-    process_activity();
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::activity );
+        process_activity();
+    }
     // Process NPC sound events before they move or they hear themselves talking
     for( npc &guy : all_npcs() ) {
         if( rl_dist( guy.pos(), u.pos() ) < MAX_VIEW_DISTANCE ) {
@@ -1535,25 +1554,49 @@ bool game::do_turn()
         scent.set( u.pos(), u.scent, u.get_type_of_scent() );
         overmap_buffer.set_scent( u.global_omt_location(),  u.scent );
     }
-    scent.update( u.pos(), m );
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::scent );
+        scent.update( u.pos(), m );
+    }
 
     // We need floor cache before checking falling 'n stuff
     m.build_floor_caches();
 
     m.process_falling();
     autopilot_vehicles();
-    m.vehmove();
-    m.process_fields();
-    m.process_items();
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::vehmove );
+        m.vehmove();
+    }
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::fields );
+        m.process_fields();
+    }
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::items );
+        m.process_items();
+    }
     m.creature_in_field( u );
-    grid_tracker_ptr->update( calendar::turn );
-
-    // Apply sounds from previous turn to monster and NPC AI.
-    sounds::process_sounds();
-    // Update vision caches for monsters. If this turns out to be expensive,
-    // consider a stripped down cache just for monsters.
-    m.build_map_cache( get_levz(), true );
-    monmove();
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::grid );
+        grid_tracker_ptr->update( calendar::turn );
+    }
+
+    {
+        // Apply sounds from previous turn to monster and NPC AI.
+        turn_profiler::scoped_timer timer( turn_profiler::phase::sounds );
+        sounds::process_sounds();
+    }
+    {
+        // Update vision caches for monsters. If this turns out to be expensive,
+        // consider a stripped down cache just for monsters.
+        turn_profiler::scoped_timer timer( turn_profiler::phase::map_cache );
+        m.build_map_cache( get_levz(), true );
+    }
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::monmove );
+        monmove();
+    }
     if( calendar::once_every( 5_minutes ) ) {
         overmap_npc_move();
     }
@@ -1565,8 +1608,17 @@ bool game::do_turn()
             }
         }
     }
-    update_stair_monsters();
-    mon_info_update();
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::stair_monsters );
+        update_stair_monsters();
+    }
+    {
+        turn_profiler::scoped_timer timer( turn_profiler::phase::mon_info );
+        mon_info_update();
+    }
+    if( get_option<bool>( "PREFETCH_SUBMAPS" ) ) {
+        prefetcher_ptr->update( u.global_square_location(), m.get_abs_sub(), m.has_zlevels() );
+    }
     u.process_turn();
     if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
         ui_manager::redraw();
@@ -1636,6 +1688,8 @@ bool game::do_turn()
     // reset player noise
     u.volume = 0;
 
+    turn_profiler::end_turn();
+
     return false;
 }
 
@@ -2569,8 +2623,10 @@ bool game::try_get_left_click_action( action_id &act, const tripoint &mouse_targ
     }
 
     if( new_destination ) {
-        destination_preview = m.route( u.pos(), mouse_target, u.get_pathfinding_settings(),
-                                       u.get_path_avoid() );
+        // Travel can cross the whole reality bubble
+        pathfinding_settings travel_settings = u.get_pathfinding_settings();
+        travel_settings.guide_by_portals = true;
+        destination_preview = m.route( u.pos(), mouse_target, travel_settings, u.get_path_avoid() );
         return false;
     }
 
@@ -2997,12 +3053,12 @@ bool game::save_artifacts()
     return ::save_artifacts( artfilename );
 }
 
-bool game::save_maps()
+bool game::save_maps( bool in_background )
 {
     try {
         m.save();
         overmap_buffer.save(); // can throw
-        MAPBUFFER.save(); // can throw
+        MAPBUFFER.save( false, in_background ); // can throw
         return true;
     } catch( const std::exception &err ) {
         popup( _( "Failed to save the maps: %s" ), err.what() );
@@ -3056,13 +3112,13 @@ spell_events &game::spell_events_subscriber()
     return *spell_events_ptr;
 }
 
-bool game::save()
+bool game::save( bool maps_in_background )
 {
     try {
         if( !save_player_data() ||
             !save_factions_missions_npcs() ||
             !save_artifacts() ||
-            !save_maps() ||
+            !save_maps( maps_in_background ) ||
             !get_auto_pickup().save_character() ||
             !get_auto_notes_settings().save() ||
             !get_safemode().save_character() ||
@@ -3403,6 +3459,23 @@ static shared_ptr_fast<game::draw_callback_t> create_trail_callback(
     } );
 }
 
+static void draw_turn_profile_overlay( const catacurses::window &w_terrain )
+{
+    const std::vector<std::string> lines = turn_profiler::summary_lines();
+    const int height = std::min( static_cast<int>( lines.size() ), getmaxy( w_terrain ) );
+    const int width = std::min( 46, getmaxx( w_terrain ) );
+    if( height <= 0 || width <= 0 ) {
+        return;
+    }
+    catacurses::window w = catacurses::newwin( height, width,
+                           point( getbegx( w_terrain ), getbegy( w_terrain ) ) );
+    werase( w );
+    for( int i = 0; i < height; i++ ) {
+        mvwprintz( w, point( 0, i ), c_light_gray, lines[i] );
+    }
+    wnoutrefresh( w );
+}
+
 void game::draw()
 {
     if( test_mode ) {
@@ -3427,6 +3500,10 @@ void game::draw()
     }
     wnoutrefresh( w_terrain );
 
+    if( turn_profiler::overlay_enabled() ) {
+        draw_turn_profile_overlay( w_terrain );
+    }
+
     draw_panels( true );
 }
 
@@ -4356,6 +4433,14 @@ void game::monmove()
 {
     cleanup_dead();
 
+    std::vector<tripoint> perception_targets;
+    if( perception_pass ) {
+        for( const npc &guy : all_npcs() ) {
+            perception_targets.push_back( guy.pos() );
+        }
+    }
+    m.build_perception_cache( perception_targets );
+
     for( monster &critter : all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
@@ -6948,7 +7033,9 @@ look_around_result game::look_around( const bool show_window, tripoint &center,
                 continue;
             }
 
-            auto route = m.route( u.pos(), lp, u.get_pathfinding_settings(), u.get_path_avoid() );
+            pathfinding_settings travel_settings = u.get_pathfinding_settings();
+            travel_settings.guide_by_portals = true;
+            auto route = m.route( u.pos(), lp, travel_settings, u.get_path_avoid() );
             if( route.size() > 1 ) {
                 route.pop_back();
                 u.set_destination( route );
@@ -11007,6 +11094,12 @@ point game::update_map( int &x, int &y )
         return point_zero;
     }
 
+    if( get_option<bool>( "PREGENERATE_OVERMAPS" ) ) {
+        // Lay out the overmaps next to the player together, before loading the
+        // map requests them one at a time.
+        overmap_buffer.generate_around( project_to<coords::om>( u.global_omt_location().xy() ) );
+    }
+
     // this handles loading/unloading submaps that have scrolled on or off the viewport
     // NOLINTNEXTLINE(cata-use-named-point-constants)
     inclusive_rectangle<point> size_1( point( -1, -1 ), point( 1, 1 ) );
@@ -11606,7 +11699,7 @@ void game::quicksave()
     time_t now = time( nullptr ); //timestamp for start of saving procedure
 
     //perform save
-    save();
+    save( get_option<bool>( "AUTOSAVE_BACKGROUND" ) );
     //Now reset counters for autosaving, so we don't immediately autosave after a quicksave or autosave.
     moves_since_last_save = 0;
     last_save_timestamp = now;
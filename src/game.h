@@ -93,6 +93,7 @@ class faction_manager;
 class kill_tracker;
 class map;
 class map_item_stack;
+class map_prefetcher;
 class memorial_logger;
 class npc;
 class player;
@@ -209,8 +210,11 @@ class game
         /** write statistics to stdout and @return true if successful */
         bool dump_stats( const std::string &what, dump_mode mode, const std::vector<std::string> &opts );
 
-        /** Returns false if saving failed. */
-        bool save();
+        /** Returns false if saving failed.
+         * @param maps_in_background Write the map files on a background thread
+         * while the game continues.
+         */
+        bool save( bool maps_in_background = false );
 
         /** Returns a list of currently active character saves. */
         std::vector<std::string> list_active_characters();
@@ -766,7 +770,7 @@ class game
         // returns false if saving failed for whatever reason
         bool save_artifacts();
         // returns false if saving failed for whatever reason
-        bool save_maps();
+        bool save_maps( bool in_background = false );
 #if defined(__ANDROID__)
         void save_shortcuts( std::ostream &fout );
 #endif
@@ -982,6 +986,7 @@ class game
         pimpl<spell_events> spell_events_ptr;
         pimpl<distribution_grid_tracker> grid_tracker_ptr;
         pimpl<weather_manager> weather_manager_ptr;
+        pimpl<map_prefetcher> prefetcher_ptr;
 
     public:
         /** Make map a reference here, to avoid map.h in game.h */
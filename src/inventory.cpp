@@ -13,6 +13,7 @@
 #include "distribution_grid.h"
 #include "game.h"
 #include "iexamine.h"
+#include "itype.h"
 #include "magic_enchantment.h"
 #include "map.h"
 #include "map_iterator.h"
@@ -301,7 +302,7 @@ item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, boo
                 } else {
                     newit.invlet = it_ref->invlet;
                 }
-                elem.push_back( newit );
+                elem.push_back( std::move( newit ) );
                 return elem.back();
             } else if( keep_invlet && assign_invlet && it_ref->invlet == newit.invlet &&
                        it_ref->invlet != '\0' ) {
@@ -317,9 +318,8 @@ item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, boo
     }
     update_cache_with_item( newit );
 
-    std::list<item> newstack;
-    newstack.push_back( newit );
-    items.push_back( newstack );
+    items.emplace_back();
+    items.back().push_back( std::move( newit ) );
     return items.back().back();
 }
 
@@ -451,6 +451,7 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
 {
     const time_point bday = calendar::start_of_cataclysm;
     items.clear();
+    binned = false;
     for( const tripoint &p : pts ) {
         if( m.has_furn( p ) ) {
             const furn_t &f = m.furn( p ).obj();
@@ -816,7 +817,7 @@ bool inventory::has_components( const itype_id &it, int quantity,
 bool inventory::has_charges( const itype_id &it, int quantity,
                              const std::function<bool( const item & )> &filter ) const
 {
-    return ( charges_of( it, INT_MAX, filter ) >= quantity );
+    return ( charges_of( it, quantity, filter ) >= quantity );
 }
 
 int inventory::leak_level( const std::string &flag ) const
@@ -1166,18 +1167,38 @@ const itype_bin &inventory::get_binned_items() const
     }
 
     binned_items.clear();
-
-    // HACK: Hack warning
-    inventory *this_nonconst = const_cast<inventory *>( this );
-    this_nonconst->visit_items( [ this ]( item * e ) {
-        binned_items[ e->typeId() ].push_back( e );
-        return VisitResponse::NEXT;
-    } );
+    quality_bins.clear();
+
+    std::vector<quality_id> stack_qualities;
+    for( const std::list<item> &stack : items ) {
+        stack_qualities.clear();
+        for( const item &it : stack ) {
+            it.visit_items( [ this, &stack_qualities ]( const item * e ) {
+                binned_items[ e->typeId() ].push_back( e );
+                for( const std::pair<const quality_id, int> &quality : e->type->qualities ) {
+                    if( std::find( stack_qualities.begin(), stack_qualities.end(),
+                                   quality.first ) == stack_qualities.end() ) {
+                        stack_qualities.push_back( quality.first );
+                    }
+                }
+                return VisitResponse::NEXT;
+            } );
+        }
+        for( const quality_id &quality : stack_qualities ) {
+            quality_bins[ quality ].push_back( &stack );
+        }
+    }
 
     binned = true;
     return binned_items;
 }
 
+const quality_bin &inventory::get_quality_bins() const
+{
+    get_binned_items();
+    return quality_bins;
+}
+
 void inventory::copy_invlet_of( const inventory &other )
 {
     assigned_invlet = other.assigned_invlet;
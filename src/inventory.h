@@ -33,6 +33,7 @@ using invslice = std::vector<std::list<item> *>;
 using const_invslice = std::vector<const std::list<item> *>;
 using indexed_invslice = std::vector< std::pair<std::list<item>*, int> >;
 using itype_bin = std::unordered_map< itype_id, std::list<const item *> >;
+using quality_bin = std::unordered_map< quality_id, std::vector<const std::list<item> *> >;
 using invlets_bitset = std::bitset<std::numeric_limits<char>::max()>;
 
 /** First element is pointer to item stack (first item), second is amount. */
@@ -225,6 +226,11 @@ class inventory : public visitable<inventory>
          * May not contain items that wouldn't be visited by @ref visitable methods.
          */
         const itype_bin &get_binned_items() const;
+        /**
+         * Returns stacks binned by the tool qualities of their items, contents included.
+         * Stacks that are in no bin of a quality can't provide it.
+         */
+        const quality_bin &get_quality_bins() const;
 
         void update_cache_with_item( item &newit );
 
@@ -246,6 +252,10 @@ class inventory : public visitable<inventory>
          * `mutable` because this is a pure cache that doesn't affect the contained items.
          */
         mutable itype_bin binned_items;
+        /**
+         * Stacks binned by quality, built together with @ref binned_items.
+         */
+        mutable quality_bin quality_bins;
 };
 
 #endif // CATA_SRC_INVENTORY_H
@@ -6641,10 +6641,11 @@ bool item::is_relic() const
     return !!relic_data;
 }
 
-std::vector<enchantment> item::get_enchantments() const
+const std::vector<enchantment> &item::get_enchantments() const
 {
     if( !is_relic() ) {
-        return std::vector<enchantment> {};
+        static const std::vector<enchantment> none;
+        return none;
     }
     return relic_data->get_enchantments();
 }
@@ -34,6 +34,7 @@
 #include "string_formatter.h"
 #include "submap.h"
 #include "tileray.h"
+#include "turn_profiler.h"
 #include "type_id.h"
 #include "veh_type.h"
 #include "vehicle.h"
@@ -158,6 +159,7 @@ bool map::build_transparency_cache( const int zlev )
             }
         }
     }
+    map_cache.transparency_planes.build( transparency_cache );
     map_cache.transparency_cache_dirty.reset();
     return true;
 }
@@ -169,6 +171,7 @@ bool map::build_vision_transparency_cache( const int zlev )
     auto &vision_transparency_cache = map_cache.vision_transparency_cache;
 
     memcpy( &vision_transparency_cache, &transparency_cache, sizeof( transparency_cache ) );
+    map_cache.vision_transparency_planes = map_cache.transparency_planes;
 
     const tripoint &p = g->u.pos();
 
@@ -183,9 +186,11 @@ bool map::build_vision_transparency_cache( const int zlev )
         if( loc == p ) {
             // The tile player is standing on should always be visible
             vision_transparency_cache[p.x][p.y] = LIGHT_TRANSPARENCY_OPEN_AIR;
+            map_cache.vision_transparency_planes.set( p.xy(), LIGHT_TRANSPARENCY_OPEN_AIR );
         } else if( is_crouching && coverage( loc ) >= 30 ) {
             // If we're crouching behind an obstacle, we can't see past it.
             vision_transparency_cache[loc.x][loc.y] = LIGHT_TRANSPARENCY_SOLID;
+            map_cache.vision_transparency_planes.set( loc.xy(), LIGHT_TRANSPARENCY_SOLID );
             dirty = true;
         }
     }
@@ -833,6 +838,8 @@ void cast_zlight_segment(
         delta.y = distance;
         bool started_block = false;
         T current_transparency = 0.0f;
+        // Same as in castLight, intensity only depends on the distance within a row
+        int last_dist = -1;
 
         // TODO: Precalculate min/max delta.z based on start/end and distance
         for( delta.z = 0; delta.z <= std::min( fov_3d_z_range, distance ); delta.z++ ) {
@@ -886,7 +893,10 @@ void cast_zlight_segment(
                 }
 
                 const int dist = rl_dist( tripoint_zero, delta ) + offset_distance;
-                last_intensity = calc( numerator, cumulative_transparency, dist );
+                if( dist != last_dist ) {
+                    last_intensity = calc( numerator, cumulative_transparency, dist );
+                    last_dist = dist;
+                }
 
                 if( !floor_block ) {
                     ( *output_caches[z_index] )[current.x][current.y] =
@@ -1061,6 +1071,70 @@ template void cast_zlight<float, shrapnel_calc, shrapnel_check, accumulate_fragm
     const array_of_grids_of<const bool> &floor_caches,
     const tripoint &origin, int offset_distance, float numerator );
 
+transparency_bitplanes::transparency_bitplanes()
+{
+    std::memset( columns, 0, sizeof( columns ) );
+    std::memset( rows, 0, sizeof( rows ) );
+}
+
+void transparency_bitplanes::build( const float ( &transparency )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    std::memset( columns, 0, sizeof( columns ) );
+    std::memset( rows, 0, sizeof( rows ) );
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const float value = transparency[x][y];
+            const bool opaque = value == LIGHT_TRANSPARENCY_SOLID;
+            if( opaque || value == LIGHT_TRANSPARENCY_OPEN_AIR ) {
+                const int is_clear = opaque ? 0 : 1;
+                columns[is_clear][x][y / 64] |= std::uint64_t( 1 ) << ( y % 64 );
+                rows[is_clear][y][x / 64] |= std::uint64_t( 1 ) << ( x % 64 );
+            }
+        }
+    }
+}
+
+void transparency_bitplanes::set( const point &p, const float transparency )
+{
+    const std::uint64_t y_bit = std::uint64_t( 1 ) << ( p.y % 64 );
+    const std::uint64_t x_bit = std::uint64_t( 1 ) << ( p.x % 64 );
+    for( int is_clear = 0; is_clear < 2; is_clear++ ) {
+        const float value = is_clear ? LIGHT_TRANSPARENCY_OPEN_AIR : LIGHT_TRANSPARENCY_SOLID;
+        std::uint64_t &column_word = columns[is_clear][p.x][p.y / 64];
+        std::uint64_t &row_word = rows[is_clear][p.y][p.x / 64];
+        if( transparency == value ) {
+            column_word |= y_bit;
+            row_word |= x_bit;
+        } else {
+            column_word &= ~y_bit;
+            row_word &= ~x_bit;
+        }
+    }
+}
+
+bool transparency_bitplanes::all_set( const line &bits, const int lo, const int hi )
+{
+    for( int word = lo / 64; word <= hi / 64; word++ ) {
+        const int first = std::max( lo, word * 64 ) % 64;
+        const int last = std::min( hi, word * 64 + 63 ) % 64;
+        const std::uint64_t mask = ( ~std::uint64_t( 0 ) >> ( 63 - ( last - first ) ) ) << first;
+        if( ( bits[word] & mask ) != mask ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool transparency_bitplanes::column_is_uniform( const int x, const int y_lo, const int y_hi ) const
+{
+    return all_set( columns[0][x], y_lo, y_hi ) || all_set( columns[1][x], y_lo, y_hi );
+}
+
+bool transparency_bitplanes::row_is_uniform( const int y, const int x_lo, const int x_hi ) const
+{
+    return all_set( rows[0][y], x_lo, x_hi ) || all_set( rows[1][y], x_lo, x_hi );
+}
+
 template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
@@ -1068,6 +1142,7 @@ template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *accumulate )( const T &, const T &, const int & )>
 void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                const transparency_bitplanes *planes,
                 const point &offset, int offsetDistance,
                 T numerator = VISIBILITY_FULL,
                 int row = 1, float start = 1.0f, float end = 0.0f,
@@ -1080,6 +1155,7 @@ template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *accumulate )( const T &, const T &, const int & )>
 void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                const transparency_bitplanes *planes,
                 const point &offset, const int offsetDistance, const T numerator,
                 const int row, float start, const float end, T cumulative_transparency )
 {
@@ -1091,20 +1167,87 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     }
     T last_intensity = 0.0;
     tripoint delta;
+    const auto trailing_edge = [&delta]( int dx ) {
+        return ( dx - 0.5f ) / ( delta.y + 0.5f );
+    };
+    const auto leading_edge = [&delta]( int dx ) {
+        return ( dx + 0.5f ) / ( delta.y - 0.5f );
+    };
     for( int distance = row; distance <= radius; distance++ ) {
         delta.y = -distance;
         bool started_row = false;
         T current_transparency = 0.0;
+        // The cumulative transparency only changes between rows, so the
+        // intensity only needs recomputing when the distance changes. With
+        // square distances that is once per row.
+        int last_dist = -1;
         float away = start - ( -distance + 0.5f ) / ( -distance -
                      0.5f ); //The distance between our first leadingEdge and start
 
         //We initialize delta.x to -distance adjusted so that the commented start < leadingEdge condition below is never false
         delta.x = -distance + std::max( static_cast<int>( std::ceil( away * ( -distance - 0.5f ) ) ), 0 );
 
-        for( ; delta.x <= 0; delta.x++ ) {
+        bool row_done = false;
+        if( planes != nullptr ) {
+            // Cells outside the map are skipped without ending the row, so the
+            // visited cells are the in-bounds ones from delta.x up to the last
+            // one before the end slope. The trailing edge falls as delta.x
+            // grows, so that one is found by bisection.
+            const int row_origin = xx != 0 ? offset.x : offset.y;
+            const int step = xx != 0 ? xx : yx;
+            const int row_line = xx != 0 ? offset.y + delta.y * yy : offset.x + delta.y * xy;
+            int first = delta.x;
+            int last = 0;
+            if( step > 0 ) {
+                first = std::max( first, -row_origin );
+                last = std::min( last, MAPSIZE_X - 1 - row_origin );
+            } else {
+                first = std::max( first, row_origin - ( MAPSIZE_X - 1 ) );
+                last = std::min( last, row_origin );
+            }
+            if( row_line < 0 || row_line >= MAPSIZE_X ) {
+                last = first - 1;
+            }
+            int past_end = last + 1;
+            for( int lo = first; lo < past_end; ) {
+                const int mid = lo + ( past_end - lo ) / 2;
+                if( end > trailing_edge( mid ) ) {
+                    past_end = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            last = past_end - 1;
+            const int from = row_origin + first * step;
+            const int to = row_origin + last * step;
+            const int low = std::min( from, to );
+            const int high = std::max( from, to );
+            if( first <= last && ( xx != 0 ? planes->row_is_uniform( row_line, low, high ) :
+                                   planes->column_is_uniform( row_line, low, high ) ) ) {
+                // Every visited cell has the same transparency, so the row has
+                // no transitions and only the output needs writing.
+                started_row = true;
+                current_transparency = xx != 0 ? input_array[from][row_line] : input_array[row_line][from];
+                for( delta.x = first; delta.x <= last; delta.x++ ) {
+                    const point current( offset.x + delta.x * xx + delta.y * xy,
+                                         offset.y + delta.x * yx + delta.y * yy );
+                    const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
+                    if( dist != last_dist ) {
+                        last_intensity = calc( numerator, cumulative_transparency, dist );
+                        last_dist = dist;
+                    }
+                    update_output( output_cache[current.x][current.y], last_intensity,
+                                   check( current_transparency, last_intensity ) ? quadrant::default_ : quad );
+                }
+                newStart = leading_edge( last );
+                row_done = true;
+            }
+        }
+
+        for( ; !row_done && delta.x <= 0; delta.x++ ) {
             point current( offset.x + delta.x * xx + delta.y * xy, offset.y + delta.x * yx + delta.y * yy );
-            float trailingEdge = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
-            float leadingEdge = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+            float trailingEdge = trailing_edge( delta.x );
+            float leadingEdge = leading_edge( delta.x );
 
             if( !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
                    current.y < MAPSIZE_Y ) /* || start < leadingEdge */ ) {
@@ -1118,7 +1261,10 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
             }
 
             const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
-            last_intensity = calc( numerator, cumulative_transparency, dist );
+            if( dist != last_dist ) {
+                last_intensity = calc( numerator, cumulative_transparency, dist );
+                last_dist = dist;
+            }
 
             T new_transparency = input_array[ current.x ][ current.y ];
 
@@ -1136,7 +1282,7 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
             // Only cast recursively if previous span was not opaque.
             if( check( current_transparency, last_intensity ) ) {
                 castLight<xx, xy, yx, yy, T, Out, calc, check, update_output, accumulate>(
-                    output_cache, input_array, offset, offsetDistance,
+                    output_cache, input_array, planes, offset, offsetDistance,
                     numerator, distance + 1, start, trailingEdge,
                     accumulate( cumulative_transparency, current_transparency, distance ) );
             }
@@ -1170,34 +1316,37 @@ template<typename T, typename Out, T( *calc )( const T &, const T &, const int &
          T( *accumulate )( const T &, const T &, const int & )>
 void castLightAll( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                    const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
-                   const point &offset, int offsetDistance, T numerator )
+                   const point &offset, int offsetDistance, T numerator,
+                   const transparency_bitplanes *planes )
 {
+    turn_profiler::scoped_timer timer( turn_profiler::phase::cast_light );
     castLight<0, 1, 1, 0, T, Out, calc, check, update_output, accumulate>(
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
     castLight<1, 0, 0, 1, T, Out, calc, check, update_output, accumulate>(
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
 
     castLight < 0, -1, 1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
     castLight < -1, 0, 0, 1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
 
     castLight < 0, 1, -1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
     castLight < 1, 0, 0, -1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
 
     castLight < 0, -1, -1, 0, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
     castLight < -1, 0, 0, -1, T, Out, calc, check, update_output, accumulate > (
-        output_cache, input_array, offset, offsetDistance, numerator );
+        output_cache, input_array, planes, offset, offsetDistance, numerator );
 }
 
 template void castLightAll<float, four_quadrants, sight_calc, sight_check,
                            update_light_quadrants, accumulate_transparency>(
                                four_quadrants( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                                const float ( &input_array )[MAPSIZE_X][MAPSIZE_Y],
-                               const point &offset, int offsetDistance, float numerator );
+                               const point &offset, int offsetDistance, float numerator,
+                               const transparency_bitplanes *planes );
 
 template void
 castLightAll<float, float, shrapnel_calc, shrapnel_check,
@@ -1205,7 +1354,8 @@ castLightAll<float, float, shrapnel_calc, shrapnel_check,
 (
     float( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     const float( &input_array )[MAPSIZE_X][MAPSIZE_Y],
-    const point &offset, int offsetDistance, float numerator );
+    const point &offset, int offsetDistance, float numerator,
+    const transparency_bitplanes *planes );
 
 /**
  * Calculates the Field Of View for the provided map from the given x, y
@@ -1243,7 +1393,8 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
             if( z == target_z ) {
                 seen_cache[origin.x][origin.y] = VISIBILITY_FULL;
                 castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
-                    seen_cache, transparency_cache, origin.xy(), 0 );
+                    seen_cache, transparency_cache, origin.xy(), 0, VISIBILITY_FULL,
+                    &map_cache.vision_transparency_planes );
             }
         }
     } else {
@@ -1320,8 +1471,108 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
         // The naive solution of making the mirrors act like a second player
         // at an offset appears to give reasonable results though.
         castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
-            camera_cache, transparency_cache, mirror_pos.xy(), offsetDistance );
+            camera_cache, transparency_cache, mirror_pos.xy(), offsetDistance, VISIBILITY_FULL,
+            &map_cache.vision_transparency_planes );
+    }
+}
+
+// The line map::sees traces from a cell towards the target steps along the major
+// axis every time and along the minor axis at most as often, all within the octant.
+// So if every such staircase is clear, or every one is blocked, so is that line.
+void map::build_perception_cache( const std::vector<tripoint> &targets )
+{
+    // Major and minor direction of each octant
+    static constexpr std::array<std::pair<point, point>, 8> octants = {{
+            { point_east, point_south }, { point_east, point_north },
+            { point_west, point_south }, { point_west, point_north },
+            { point_south, point_east }, { point_south, point_west },
+            { point_north, point_east }, { point_north, point_west }
+        }
+    };
+    perception_grid_count = 0;
+    for( const tripoint &origin : targets ) {
+        if( !inbounds( origin ) ) {
+            continue;
+        }
+        if( perception_grid_count == perception_grids.size() ) {
+            perception_grids.push_back( std::make_unique<perception_grid>() );
+        }
+        perception_grid &grid = *perception_grids[perception_grid_count++];
+        grid.origin = origin;
+        grid.abs_sub = abs_sub;
+        grid.stamp = skew_vision_level_stamps[origin.z + OVERMAP_DEPTH];
+        std::uninitialized_fill_n( &grid.line[0][0], MAPSIZE_X * MAPSIZE_Y,
+                                   perception_grid::undecided );
+        grid.line[origin.x][origin.y] = perception_grid::clear;
+
+        const auto &transparency_cache = get_cache( origin.z ).transparency_cache;
+        // Whether the line, after stepping onto p, is certainly clear or blocked
+        const auto step_onto = [&]( const point & p ) {
+            if( p == origin.xy() ) {
+                return perception_grid::clear;
+            }
+            if( transparency_cache[p.x][p.y] <= LIGHT_TRANSPARENCY_SOLID ) {
+                return perception_grid::blocked;
+            }
+            return grid.line[p.x][p.y];
+        };
+        for( const std::pair<point, point> &octant : octants ) {
+            const point major = octant.first;
+            const point minor = octant.second;
+            for( int u = 1; ; u++ ) {
+                const point row_start = origin.xy() + major * u;
+                if( !inbounds( row_start ) ) {
+                    break;
+                }
+                for( int v = 0; v <= u; v++ ) {
+                    const point p = row_start + minor * v;
+                    if( !inbounds( p ) ) {
+                        break;
+                    }
+                    // Back towards the origin, along the major axis or diagonally
+                    const point straight = p - major;
+                    const point diagonal = p - major - minor;
+                    const bool can_go_straight = v < u;
+                    const bool can_go_diagonal = v > 0;
+                    const perception_grid::state first = step_onto( can_go_straight ? straight : diagonal );
+                    if( first == perception_grid::undecided ||
+                        ( can_go_straight && can_go_diagonal && step_onto( diagonal ) != first ) ) {
+                        grid.line[p.x][p.y] = perception_grid::undecided;
+                    } else {
+                        grid.line[p.x][p.y] = first;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Looks up the lines worked out by build_perception_cache
+cata::optional<bool> map::perceived( const tripoint &target, const tripoint &from ) const
+{
+    if( from.z != target.z || !inbounds( from ) ) {
+        return cata::nullopt;
+    }
+    for( size_t i = 0; i < perception_grid_count; i++ ) {
+        const perception_grid &grid = *perception_grids[i];
+        if( grid.origin != target ) {
+            continue;
+        }
+        if( grid.abs_sub != abs_sub ||
+            grid.stamp != skew_vision_level_stamps[target.z + OVERMAP_DEPTH] ) {
+            return cata::nullopt;
+        }
+        switch( grid.line[from.x][from.y] ) {
+            case perception_grid::clear:
+                return true;
+            case perception_grid::blocked:
+                return false;
+            case perception_grid::undecided:
+                break;
+        }
+        return cata::nullopt;
     }
+    return cata::nullopt;
 }
 
 //Schraudolph's algorithm with John's constants
@@ -1400,37 +1651,37 @@ void map::apply_light_source( const tripoint &p, float luminance )
     if( north ) {
         castLight < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < -1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     }
 
     if( east ) {
         castLight < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < 0, -1, -1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     }
 
     if( south ) {
         castLight<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < -1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     }
 
     if( west ) {
         castLight<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < 0, 1, -1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     }
 }
 
@@ -1445,31 +1696,31 @@ void map::apply_directional_light( const tripoint &p, int direction, float lumin
     if( direction == 90 ) {
         castLight < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < -1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     } else if( direction == 0 ) {
         castLight < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < 0, -1, -1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     } else if( direction == 270 ) {
         castLight<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < -1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     } else if( direction == 180 ) {
         castLight<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
         castLight < 0, 1, -1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
-                      lm, transparency_cache, p2, 0, luminance );
+                      lm, transparency_cache, &cache.transparency_planes, p2, 0, luminance );
     }
 }
 
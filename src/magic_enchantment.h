@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_MAGIC_ENCHANTMENT_H
 #define CATA_SRC_MAGIC_ENCHANTMENT_H
 
+#include <array>
 #include <map>
 #include <string>
 #include <utility>
@@ -146,6 +147,11 @@ class enchantment
             return has::WIELD == active_conditions.first || has::HELD == active_conditions.first;
         }
 
+        /** Whether this enchantment is only active underwater. */
+        inline bool needs_water() const {
+            return active_conditions.second == condition::UNDERWATER;
+        }
+
         // modifies character stats, or does other passive effects
         void activate_passive( Character &guy ) const;
 
@@ -172,11 +178,11 @@ class enchantment
         std::set<trait_id> mutations;
         cata::optional<emit_id> emitter;
         std::map<efftype_id, int> ench_effects;
-        // values that add to the base value
-        std::map<enchant_vals::mod, int> values_add;
-        // values that get multiplied to the base value
+        // values that add to the base value, indexed by enchant_vals::mod
+        std::array<int, static_cast<size_t>( enchant_vals::mod::NUM_MOD )> values_add = {};
+        // values that get multiplied to the base value, indexed by enchant_vals::mod
         // multipliers add to each other instead of multiply against themselves
-        std::map<enchant_vals::mod, double> values_multiply;
+        std::array<double, static_cast<size_t>( enchant_vals::mod::NUM_MOD )> values_multiply = {};
 
         std::vector<fake_spell> hit_me_effect;
         std::vector<fake_spell> hit_you_effect;
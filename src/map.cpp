@@ -30,6 +30,7 @@
 #include "creature.h"
 #include "cursesdef.h"
 #include "damage.h"
+#include "cached_options.h"
 #include "debug.h"
 #include "distribution_grid.h"
 #include "drawing_primitives.h"
@@ -95,6 +96,7 @@
 #include "vpart_range.h"
 #include "weather.h"
 #include "weighted_list.h"
+#include "worker_pool.h"
 
 static const itype_id itype_battery( "battery" );
 static const itype_id itype_chemistry_set( "chemistry_set" );
@@ -377,6 +379,7 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
                 overmap_buffer.remove_vehicle( veh );
             }
             dirty_vehicle_list.erase( veh );
+            moving_vehicles.erase( veh );
             return result;
         }
     }
@@ -402,7 +405,7 @@ void map::on_vehicle_moved( const int smz )
 void map::vehmove()
 {
     // give vehicles movement points
-    VehicleList vehicle_list;
+    moving_vehicles.clear();
     int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int zlev = minz; zlev <= maxz; ++zlev ) {
@@ -410,16 +413,14 @@ void map::vehmove()
         for( vehicle *veh : cache.vehicle_list ) {
             veh->gain_moves();
             veh->slow_leak();
-            wrapped_vehicle w;
-            w.v = veh;
-            vehicle_list.push_back( w );
+            moving_vehicles.push( veh );
         }
     }
 
     // 15 equals 3 >50mph vehicles, or up to 15 slow (1 square move) ones
     // But 15 is too low for V12 death-bikes, let's put 100 here
     for( int count = 0; count < 100; count++ ) {
-        if( !vehproceed( vehicle_list ) ) {
+        if( !vehproceed() ) {
             break;
         }
     }
@@ -427,55 +428,49 @@ void map::vehmove()
     // Use a copy because part_removal_cleanup can modify the container.
     auto temp = dirty_vehicle_list;
     for( const auto &elem : temp ) {
-        auto same_ptr = [ elem ]( const struct wrapped_vehicle & tgt ) {
-            return elem == tgt.v;
-        };
-        if( std::find_if( vehicle_list.begin(), vehicle_list.end(), same_ptr ) !=
-            vehicle_list.end() ) {
+        if( moving_vehicles.contains( elem ) ) {
             elem->part_removal_cleanup();
         }
     }
     dirty_vehicle_list.clear();
+    moving_vehicles.clear();
     // The bool tracks whether the vehicles is on the map or not.
-    std::map<vehicle *, bool> connected_vehicles;
+    std::vector<std::pair<vehicle *, bool>> connected_vehicles;
+    std::unordered_map<const vehicle *, size_t> connected_indices;
     for( int zlev = minz; zlev <= maxz; ++zlev ) {
         level_cache &cache = get_cache( zlev );
-        vehicle::enumerate_vehicles( connected_vehicles, cache.vehicle_list );
+        vehicle::enumerate_vehicles( connected_vehicles, connected_indices, cache.vehicle_list );
     }
-    for( std::pair<vehicle *const, bool> &veh_pair : connected_vehicles ) {
+    for( std::pair<vehicle *, bool> &veh_pair : connected_vehicles ) {
         veh_pair.first->idle( veh_pair.second );
     }
 }
 
-bool map::vehproceed( VehicleList &vehicle_list )
+bool map::vehproceed()
 {
-    wrapped_vehicle *cur_veh = nullptr;
-    float max_of_turn = 0;
     // First horizontal movement
-    for( wrapped_vehicle &vehs_v : vehicle_list ) {
-        if( vehs_v.v->of_turn > max_of_turn ) {
-            cur_veh = &vehs_v;
-            max_of_turn = cur_veh->v->of_turn;
-        }
+    vehicle *cur_veh = moving_vehicles.top();
+    if( cur_veh != nullptr && cur_veh->of_turn <= 0 ) {
+        cur_veh = nullptr;
     }
 
     // Then vertical-only movement
     if( cur_veh == nullptr ) {
-        for( wrapped_vehicle &vehs_v : vehicle_list ) {
-            if( vehs_v.v->is_falling || ( vehs_v.v->is_rotorcraft() && vehs_v.v->get_z_change() != 0 ) ) {
-                cur_veh = &vehs_v;
-                break;
-            }
-        }
+        cur_veh = moving_vehicles.first_added( []( const vehicle & veh ) {
+            return veh.is_falling || ( veh.is_rotorcraft() && veh.get_z_change() != 0 );
+        } );
     }
 
     if( cur_veh == nullptr ) {
         return false;
     }
 
-    cur_veh->v = cur_veh->v->act_on_map();
-    if( cur_veh->v == nullptr ) {
-        vehicle_list = get_vehicles();
+    vehicle *const new_veh = cur_veh->act_on_map();
+    if( new_veh == nullptr ) {
+        // Destroyed vehicles already left the queue in detach_vehicle
+        moving_vehicles.erase( cur_veh );
+    } else {
+        moving_vehicles.replace( cur_veh, new_veh );
     }
     return true;
 }
@@ -818,6 +813,8 @@ float map::vehicle_vehicle_collision( vehicle &veh, vehicle &veh2,
 
         veh.of_turn = avg_of_turn * .9;
         veh2.of_turn = avg_of_turn * 1.1;
+        moving_vehicles.update( &veh );
+        moving_vehicles.update( &veh2 );
 
         //Energy after collision
         float E_a = 0.5 * m1 * final1.magnitude() * final1.magnitude() +
@@ -4575,9 +4572,9 @@ void map::process_items_in_submap( submap &current_submap, const tripoint &gridp
     // Get a COPY of the active item list for this submap.
     // If more are added as a side effect of processing, they are ignored this turn.
     // If they are destroyed before processing, they don't get processed.
-    std::vector<item_reference> active_items = current_submap.active_items.get_for_processing();
+    current_submap.active_items.get_for_processing( active_items_to_process );
     const point grid_offset( gridp.x * SEEX, gridp.y * SEEY );
-    for( item_reference &active_item_ref : active_items ) {
+    for( item_reference &active_item_ref : active_items_to_process ) {
         if( !active_item_ref.item_ref ) {
             // The item was destroyed, so skip it.
             continue;
@@ -4627,7 +4624,9 @@ void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap )
         process_vehicle_items( cur_veh, vp.part_index() );
     }
 
-    for( item_reference &active_item_ref : cur_veh.active_items.get_for_processing() ) {
+    // A copy again, the vehicle might get destroyed while processing its items
+    cur_veh.active_items.get_for_processing( active_items_to_process );
+    for( item_reference &active_item_ref : active_items_to_process ) {
         if( empty( cargo_parts ) ) {
             return;
         } else if( !active_item_ref.item_ref ) {
@@ -6070,6 +6069,11 @@ void map::draw_from_above( const catacurses::window &w, const tripoint &p,
     }
 }
 
+void map::invalidate_vision_lines( const int zlev )
+{
+    skew_vision_level_stamps[zlev + OVERMAP_DEPTH] = skew_vision_cache.advance();
+}
+
 bool map::sees( const tripoint &F, const tripoint &T, const int range ) const
 {
     int dummy = 0;
@@ -6089,12 +6093,17 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
     // Cannonicalize the order of the tripoints so the cache is reflexive.
     const tripoint &min = F < T ? F : T;
     const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key(
-        min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
-        max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
-    );
-    char cached = skew_vision_cache.get( key, -1 );
+    // A little gross, just pack the values into an integer.
+    const std::uint64_t key =
+        static_cast<std::uint64_t>( min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ) ) << 32 |
+        static_cast<std::uint32_t>( max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH ) );
+    // The line is only valid if none of the levels it passes through changed since
+    std::uint32_t oldest = 0;
+    for( int z = std::max( std::min( F.z, T.z ), -OVERMAP_DEPTH );
+         z <= std::min( std::max( F.z, T.z ), OVERMAP_HEIGHT ); z++ ) {
+        oldest = std::max( oldest, skew_vision_level_stamps[z + OVERMAP_DEPTH] );
+    }
+    char cached = skew_vision_cache.get( key, -1, oldest );
     if( cached >= 0 ) {
         return cached > 0;
     }
@@ -6115,7 +6124,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
             }
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        skew_vision_cache.insert( key, visible ? 1 : 0 );
         return visible;
     }
 
@@ -6148,7 +6157,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    skew_vision_cache.insert( key, visible ? 1 : 0 );
     return visible;
 }
 
@@ -6771,12 +6780,34 @@ static void generate_uniform( const tripoint &p, const ter_id &terrain_type )
     }
 }
 
-void map::loadn( const tripoint &grid, const bool update_vehicles )
+void map::generate_quad( const tripoint &abs_sub )
 {
     // Cache empty overmap types
     static const oter_id rock( "empty_rock" );
     static const oter_id air( "open_air" );
 
+    // Each overmap square is two nonants; to prevent overlap, generate only at
+    //  squares divisible by 2.
+    // TODO: fix point types
+    const tripoint_abs_omt grid_abs_omt( sm_to_omt_copy( abs_sub ) );
+    const tripoint grid_abs_sub_rounded = omt_to_sm_copy( grid_abs_omt.raw() );
+
+    const oter_id terrain_type = overmap_buffer.ter( grid_abs_omt );
+
+    // Short-circuit if the map tile is uniform
+    // TODO: Replace with json mapgen functions.
+    if( terrain_type == air ) {
+        generate_uniform( grid_abs_sub_rounded, t_open_air );
+    } else if( terrain_type == rock ) {
+        generate_uniform( grid_abs_sub_rounded, t_rock );
+    } else {
+        tinymap tmp_map;
+        tmp_map.generate( grid_abs_sub_rounded, calendar::turn );
+    }
+}
+
+void map::loadn( const tripoint &grid, const bool update_vehicles )
+{
     const tripoint grid_abs_sub = abs_sub.xy() + grid;
     const size_t gridn = get_nonant( grid );
 
@@ -6787,25 +6818,7 @@ void map::loadn( const tripoint &grid, const bool update_vehicles )
     if( tmpsub == nullptr ) {
         // It doesn't exist; we must generate it!
         dbg( DL::Info ) << "map::loadn: Missing mapbuffer data.  Regenerating.";
-
-        // Each overmap square is two nonants; to prevent overlap, generate only at
-        //  squares divisible by 2.
-        // TODO: fix point types
-        const tripoint_abs_omt grid_abs_omt( sm_to_omt_copy( grid_abs_sub ) );
-        const tripoint grid_abs_sub_rounded = omt_to_sm_copy( grid_abs_omt.raw() );
-
-        const oter_id terrain_type = overmap_buffer.ter( grid_abs_omt );
-
-        // Short-circuit if the map tile is uniform
-        // TODO: Replace with json mapgen functions.
-        if( terrain_type == air ) {
-            generate_uniform( grid_abs_sub_rounded, t_open_air );
-        } else if( terrain_type == rock ) {
-            generate_uniform( grid_abs_sub_rounded, t_rock );
-        } else {
-            tinymap tmp_map;
-            tmp_map.generate( grid_abs_sub_rounded, calendar::turn );
-        }
+        generate_quad( grid_abs_sub );
 
         // This is the same call to MAPBUFFER as above!
         tmpsub = MAPBUFFER.lookup_submap( grid_abs_sub );
@@ -7599,6 +7612,19 @@ void map::delete_graffiti( const tripoint &p )
     current_submap->delete_graffiti( l );
 }
 
+std::vector<std::uint64_t> map::display_stamps( const int zlev ) const
+{
+    std::vector<std::uint64_t> ret;
+    ret.reserve( my_MAPSIZE * my_MAPSIZE );
+    for( int gridx = 0; gridx < my_MAPSIZE; gridx++ ) {
+        for( int gridy = 0; gridy < my_MAPSIZE; gridy++ ) {
+            const submap *sm = get_submap_at_grid( { gridx, gridy, zlev } );
+            ret.push_back( sm != nullptr ? sm->display_stamp : 0 );
+        }
+    }
+    return ret;
+}
+
 const std::string &map::graffiti_at( const tripoint &p ) const
 {
     if( !inbounds( p ) ) {
@@ -7777,7 +7803,13 @@ void map::build_obstacle_cache( const tripoint &start, const tripoint &end,
     }
 }
 
-bool map::build_floor_cache( const int zlev )
+static void report_missing_floor_submap( const tripoint &grid )
+{
+    debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", grid.x, grid.y,
+              grid.z );
+}
+
+bool map::build_floor_cache( const int zlev, cata::optional<tripoint> *missing_submap )
 {
     auto &ch = get_cache( zlev );
     if( !ch.floor_cache_dirty ) {
@@ -7795,13 +7827,13 @@ bool map::build_floor_cache( const int zlev )
             const submap *cur_submap = get_submap_at_grid( { smx, smy, zlev } );
             const submap *below_submap = !lowest_z_lev ? get_submap_at_grid( { smx, smy, zlev - 1 } ) : nullptr;
 
-            if( cur_submap == nullptr ) {
-                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy, zlev );
-                continue;
-            }
-            if( !lowest_z_lev && below_submap == nullptr ) {
-                debugmsg( "Tried to build floor cache at (%d,%d,%d) but the submap is not loaded", smx, smy,
-                          zlev - 1 );
+            if( cur_submap == nullptr || ( !lowest_z_lev && below_submap == nullptr ) ) {
+                const tripoint grid( smx, smy, cur_submap == nullptr ? zlev : zlev - 1 );
+                if( missing_submap == nullptr ) {
+                    report_missing_floor_submap( grid );
+                } else if( !*missing_submap ) {
+                    *missing_submap = grid;
+                }
                 continue;
             }
 
@@ -7858,6 +7890,7 @@ void map::do_vehicle_caching( int z )
                 int dpart = v->part_with_feature( part, VPFLAG_OPENABLE, true );
                 if( dpart < 0 || !v->parts[dpart].open ) {
                     transparency_cache[p2.x][p2.y] = LIGHT_TRANSPARENCY_SOLID;
+                    ch.transparency_planes.set( p2, LIGHT_TRANSPARENCY_SOLID );
                 } else {
                     vehicle_is_opaque = false;
                 }
@@ -7878,19 +7911,55 @@ void map::do_vehicle_caching( int z )
     }
 }
 
+static worker_pool &map_cache_workers()
+{
+    // One level per thread at most, the calling thread takes part too
+    static worker_pool pool( std::min<int>( OVERMAP_LAYERS,
+                                            std::max<int>( 1, std::thread::hardware_concurrency() ) ) - 1 );
+    return pool;
+}
+
 void map::build_map_cache( const int zlev, bool skip_lightmap )
 {
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
-    bool seen_cache_dirty = false;
-    for( int z = minz; z <= maxz; z++ ) {
+    // These caches only read the submaps of their own level (and the one
+    // below for floors) and only write to their own level_cache, so levels
+    // can be built independently. The order of the results does not depend
+    // on the order the levels are processed in.
+    std::array<bool, OVERMAP_LAYERS> level_dirty{};
+    std::array<bool, OVERMAP_LAYERS> level_lines_dirty{};
+    // debugmsg is not safe on the workers, so the levels leave it to this thread
+    std::array<cata::optional<tripoint>, OVERMAP_LAYERS> missing_submaps;
+    const auto build_level = [&]( int index ) {
+        const int z = minz + index;
         // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
         const bool affects_seen_cache =  z == zlev || fov_3d;
         build_outside_cache( z );
-        build_transparency_cache( z );
-        seen_cache_dirty |= ( build_floor_cache( z ) && affects_seen_cache );
-        seen_cache_dirty |= get_cache( z ).seen_cache_dirty && affects_seen_cache;
+        const bool transparency_changed = build_transparency_cache( z );
+        const bool changed = build_floor_cache( z, &missing_submaps[index] ) ||
+                             get_cache( z ).seen_cache_dirty;
+        level_dirty[index] = changed && affects_seen_cache;
+        level_lines_dirty[index] = changed || transparency_changed;
+    };
+    if( parallel_map_cache && maxz > minz ) {
+        map_cache_workers().run( maxz - minz + 1, build_level );
+    } else {
+        for( int z = minz; z <= maxz; z++ ) {
+            build_level( z - minz );
+        }
+    }
+    for( const cata::optional<tripoint> &missing : missing_submaps ) {
+        if( missing ) {
+            report_missing_floor_submap( *missing );
+        }
     }
+    bool seen_cache_dirty = std::any_of( level_dirty.begin(), level_dirty.end(), []( bool dirty ) {
+        return dirty;
+    } );
+
+    // Everything below depends on several levels at once (vehicles, sunlight
+    // coming from above, 3D vision) and runs on this thread.
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
     // otherwise such changes might be overwritten by main cache-building logic
     for( int z = minz; z <= maxz; z++ ) {
@@ -7899,8 +7968,10 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
 
     seen_cache_dirty |= build_vision_transparency_cache( zlev );
 
-    if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
+    for( int z = minz; z <= maxz; z++ ) {
+        if( level_lines_dirty[z - minz] || ( z == zlev && seen_cache_dirty ) ) {
+            invalidate_vision_lines( z );
+        }
     }
     // Initial value is illegal player position.
     const tripoint &p = g->u.pos();
@@ -8436,6 +8507,20 @@ const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
     return cache;
 }
 
+const pathfinding_portal_graph &map::get_portal_graph_ref( int zlev ) const
+{
+    const pathfinding_cache &cache = get_pathfinding_cache_ref( zlev );
+    if( !inbounds_z( zlev ) ) {
+        zlev = 0;
+    }
+    auto &graph = portal_graphs[zlev + OVERMAP_DEPTH];
+    if( !graph ) {
+        graph = std::make_unique<pathfinding_portal_graph>();
+    }
+    graph->refresh( cache, my_MAPSIZE );
+    return *graph;
+}
+
 void map::update_pathfinding_cache( int zlev ) const
 {
     auto &cache = get_pathfinding_cache( zlev );
@@ -8511,6 +8596,7 @@ void map::update_pathfinding_cache( int zlev ) const
         }
     }
 
+    cache.generation++;
     cache.dirty = false;
 }
 
@@ -17,6 +17,7 @@
 #include <utility>
 #include <vector>
 
+#include "active_item_cache.h"
 #include "bodypart.h"
 #include "calendar.h"
 #include "colony.h"
@@ -24,18 +25,19 @@
 #include "coordinates.h"
 #include "enums.h"
 #include "filter_utils.h"
+#include "fixed_cache.h"
 #include "game_constants.h"
 #include "item.h"
 #include "item_stack.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
 #include "mapdata.h"
 #include "memory_fast.h"
 #include "point.h"
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
+#include "vehicle_queue.h"
 
 struct scent_block;
 template <typename T> class string_id;
@@ -87,6 +89,8 @@ class map;
 
 enum ter_bitflags : int;
 struct pathfinding_cache;
+class pathfinding_flow_field;
+class pathfinding_portal_graph;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
@@ -300,11 +304,14 @@ struct level_cache {
     // stores cached transparency of the tiles
     // units: "transparency" (see LIGHT_TRANSPARENCY_OPEN_AIR)
     float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+    // opaque and clear tiles of transparency_cache, for the shadowcasting kernels
+    transparency_bitplanes transparency_planes;
 
     // stores "adjusted transparency" of the tiles
     // initial values derived from transparency_cache, uses same units
     // examples of adjustment: changed transparency on player's tile and special case for crouching
     float vision_transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+    transparency_bitplanes vision_transparency_planes;
 
     // stores "visibility" of the tiles to the player
     // values range from 1 (fully visible to player) to 0 (not visible)
@@ -553,10 +560,57 @@ class map
         maptile maptile_at_internal( const tripoint &p );
         std::pair<tripoint, maptile> maptile_has_bounds( const tripoint &p, bool bounds_checked );
         std::array<std::pair<tripoint, maptile>, 8> get_neighbors( const tripoint &p );
+        /**
+         * Where a gas field spreads to, decided before its submap is processed.
+         * Kept in the order process_fields_in_submap visits the fields.
+         */
+        struct planned_gas_spread {
+            point local;
+            field_type_id type;
+            cata::optional<tripoint> destination;
+        };
+        /**
+         * @param plan Where the gas spreads to, decided in advance. Without it, that is
+         * decided here.
+         */
         void spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
-                         const time_duration &outdoor_age_speedup, scent_block &sblk );
+                         const time_duration &outdoor_age_speedup, scent_block &sblk,
+                         const planned_gas_spread *plan = nullptr );
+        /**
+         * Where the gas at p spreads to this turn, if anywhere. Only reads the map.
+         * @param om_ter The overmap terrain at p, for the wind.
+         */
+        cata::optional<tripoint> plan_gas_spread( const field_entry &cur, const tripoint &p,
+                int percent_spread, const oter_id &om_ter );
+        /**
+         * Which neighbours a fire catches, decided before its submap is processed.
+         * Kept in the order process_fields_in_submap visits the fires.
+         */
+        struct planned_fire_spread {
+            point local;
+            /**
+             * Indices into @ref get_neighbors. If the flag is set, the neighbour only
+             * catches fire if it holds flammable items, which is checked when the plan
+             * is followed.
+             */
+            std::vector<std::pair<int, bool>> targets;
+        };
+        struct planned_field_spreads {
+            std::vector<planned_gas_spread> gas;
+            std::vector<planned_fire_spread> fire;
+        };
+        /** Which neighbours of p the fire spreads to this turn. Only reads the map. */
+        std::vector<std::pair<int, bool>> plan_fire_spread( const field_entry &cur,
+                                       const tripoint &p );
+        /**
+         * Decides where the gas and fire fields of the submap spread to this turn. Only
+         * reads the map and seeds the random numbers from the submap, so submaps can be
+         * planned on several threads with reproducible results.
+         * @param om_ter The overmap terrain the submap is part of.
+         */
+        planned_field_spreads plan_field_spreads( const tripoint &submap_pos, const oter_id &om_ter );
         void create_hot_air( const tripoint &p, int intensity );
-        bool gas_can_spread_to( field_entry &cur, const maptile &dst );
+        bool gas_can_spread_to( const field_entry &cur, const maptile &dst );
         void gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p );
         int burn_body_part( player &u, field_entry &cur, body_part bp, int scale );
     public:
@@ -629,6 +683,21 @@ class map
         * Returns whether `F` sees `T` with a view range of `range`.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
+
+        /**
+         * Works out the lines of sight to each of the targets, replacing the previous ones.
+         * Used by the per-turn perception pass so monsters don't need to trace
+         * a line to every NPC they consider.
+         */
+        void build_perception_cache( const std::vector<tripoint> &targets );
+        /**
+         * Returns whether there is a line of sight between `from` and `target`, with
+         * the same answer as @ref sees, if the pass worked it out for `target` since
+         * the map last changed there. Doesn't check range, like @ref sees with a
+         * negative range. Returns nothing where the line passes close to the edge of an
+         * obstacle, whether it is blocked then depends on the exact line.
+         */
+        cata::optional<bool> perceived( const tripoint &target, const tripoint &from ) const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -707,6 +776,13 @@ class map
         std::vector<tripoint> route( const tripoint &f, const tripoint &t,
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /**
+         * Like @ref route, for creatures that tend to chase a target in groups.
+         * Within a turn, all callers heading for the same target with equal
+         * settings share a single flow field instead of searching one by one.
+         */
+        std::vector<tripoint> crowd_route( const tripoint &f, const tripoint &t,
+                                           const pathfinding_settings &settings ) const;
 
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
@@ -728,7 +804,7 @@ class map
         // Vehicle movement
         void vehmove();
         // Selects a vehicle to move, returns false if no moving vehicles
-        bool vehproceed( VehicleList &vehicle_list );
+        bool vehproceed();
 
         // Vehicles
         VehicleList get_vehicles( const tripoint &start, const tripoint &end );
@@ -1341,7 +1417,12 @@ class map
         void create_burnproducts( const tripoint &p, const item &fuel, const units::mass &burned_mass );
         // See fields.cpp
         void process_fields();
-        void process_fields_in_submap( submap *current_submap, const tripoint &submap_pos );
+        /**
+         * @param plans Where gas and fire spread to, from @ref plan_field_spreads. Without
+         * them, spreading is decided while processing.
+         */
+        void process_fields_in_submap( submap *current_submap, const tripoint &submap_pos,
+                                       const planned_field_spreads *plans = nullptr );
         /**
          * Apply field effects to the creature when it's on a square with fields.
          */
@@ -1468,6 +1549,12 @@ class map
         const std::string &graffiti_at( const tripoint &p ) const;
         void set_graffiti( const tripoint &p, const std::string &contents );
         void delete_graffiti( const tripoint &p );
+        /**
+         * The display stamps of the submaps of a level, by grid position. They change
+         * whenever terrain, furniture or graffiti change, through this map or any other,
+         * and when the map shifts.
+         */
+        std::vector<std::uint64_t> display_stamps( int zlev ) const;
 
         // Climbing
         /**
@@ -1510,6 +1597,12 @@ class map
 
         bool is_cornerfloor( const tripoint &p ) const;
 
+        /**
+         * Generates the quad of submaps holding the submap at absolute position
+         * @p abs_sub into the map buffer, the way loading a missing submap does.
+         */
+        static void generate_quad( const tripoint &abs_sub );
+
         // mapgen.cpp functions
         void generate( const tripoint &p, const time_point &when );
         void place_spawns( const mongroup_id &group, int chance,
@@ -1575,6 +1668,8 @@ class map
          */
         bool pl_line_of_sight( const tripoint &t, int max_range ) const;
         std::set<vehicle *> dirty_vehicle_list;
+        // Vehicles that still get to move during vehmove
+        vehicle_queue moving_vehicles;
 
         /** return @ref abs_sub */
         tripoint get_abs_sub() const;
@@ -1733,6 +1828,8 @@ class map
         // Builds a transparency cache and returns true if the cache was invalidated.
         // Used to determine if seen cache should be rebuilt.
         bool build_transparency_cache( int zlev );
+        // Forgets the cached lines of sight that pass through the given z-level.
+        void invalidate_vision_lines( int zlev );
         bool build_vision_transparency_cache( int zlev );
         // fills lm with sunlight. pzlev is current player's zlevel
         void build_sunlight_cache( int pzlev );
@@ -1740,7 +1837,9 @@ class map
         void build_outside_cache( int zlev );
         // Builds a floor cache and returns true if the cache was invalidated.
         // Used to determine if seen cache should be rebuilt.
-        bool build_floor_cache( int zlev );
+        // A submap that is not loaded is reported with debugmsg, unless @p missing_submap
+        // is given, then the first one is stored there for the main thread to report.
+        bool build_floor_cache( int zlev, cata::optional<tripoint> *missing_submap = nullptr );
         // We want this visible in `game`, because we want it built earlier in the turn than the rest
         void build_floor_caches();
 
@@ -1929,15 +2028,41 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        mutable std::array< std::unique_ptr<pathfinding_portal_graph>, OVERMAP_LAYERS > portal_graphs;
+        // Flow fields of @ref crowd_route, valid for a single turn
+        mutable std::vector<pathfinding_flow_field> flow_fields;
+        mutable time_point flow_fields_turn = calendar::before_time_starts;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
         std::set<tripoint> submaps_with_active_items;
+        // Reused by process_items for the items it processes in one submap or vehicle
+        std::vector<item_reference> active_items_to_process;
 
         /**
          * Cache of coordinate pairs recently checked for visibility.
-         */
-        mutable lru_cache<point, char> skew_vision_cache;
+         * Lines between two z-levels are valid only if they were stored after
+         * the stamps of all levels in between, see @ref invalidate_vision_lines.
+         */
+        mutable fixed_cache<char> skew_vision_cache{ 17 };
+        std::array<std::uint32_t, OVERMAP_LAYERS> skew_vision_level_stamps{};
+
+        struct perception_grid {
+            enum state : std::uint8_t {
+                undecided,
+                clear,
+                blocked
+            };
+            tripoint origin;
+            tripoint abs_sub;
+            // Of the origin's level, the grid is outdated once it changes
+            std::uint32_t stamp = 0;
+            // Of the line from each cell to the origin
+            state line[MAPSIZE_X][MAPSIZE_Y];
+        };
+        // Grids of the last perception pass, the ones past the count are kept for reuse
+        std::vector<std::unique_ptr<perception_grid>> perception_grids;
+        size_t perception_grid_count = 0;
 
         /**
          * Vehicle list doesn't change often, but is pretty expensive.
@@ -1964,6 +2089,8 @@ class map
         }
 
         const pathfinding_cache &get_pathfinding_cache_ref( int zlev ) const;
+        /** Portal graph of a z-level, brought up to date with its pathfinding cache. */
+        const pathfinding_portal_graph &get_portal_graph_ref( int zlev ) const;
 
         void update_pathfinding_cache( int zlev ) const;
 
@@ -7,6 +7,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -14,6 +15,7 @@
 #include "avatar.h"
 #include "basecamp.h"
 #include "bodypart.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_utility.h"
 #include "colony.h"
@@ -30,6 +32,7 @@
 #include "fungal_effects.h"
 #include "game.h"
 #include "game_constants.h"
+#include "hash_utils.h"
 #include "int_id.h"
 #include "item.h"
 #include "item_contents.h"
@@ -60,6 +63,7 @@
 #include "vehicle.h"
 #include "vpart_position.h"
 #include "weather.h"
+#include "worker_pool.h"
 
 static const itype_id itype_rm13_armor_on( "rm13_armor_on" );
 static const itype_id itype_rock( "rock" );
@@ -138,17 +142,85 @@ int map::burn_body_part( player &u, field_entry &cur, body_part bp, const int sc
     return total_damage;
 }
 
+static worker_pool &field_workers()
+{
+    // The calling thread takes part too
+    static worker_pool pool( std::max<int>( 1, std::thread::hardware_concurrency() ) - 1 );
+    return pool;
+}
+
+// Seed for processing the fields of a submap in a turn, see map::plan_field_spreads
+static size_t field_seed( const tripoint &abs_sub_pos, int phase )
+{
+    size_t seed = g->get_seed();
+    cata::hash_combine( seed, to_turn<int>( calendar::turn ) );
+    cata::hash_combine( seed, abs_sub_pos.x );
+    cata::hash_combine( seed, abs_sub_pos.y );
+    cata::hash_combine( seed, abs_sub_pos.z );
+    cata::hash_combine( seed, phase );
+    return seed;
+}
+
 void map::process_fields()
 {
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int z = minz; z <= maxz; z++ ) {
         auto &field_cache = get_cache( z ).field_cache;
+        if( !parallel_fields ) {
+            for( int x = 0; x < my_MAPSIZE; x++ ) {
+                for( int y = 0; y < my_MAPSIZE; y++ ) {
+                    if( field_cache[ x + y * MAPSIZE ] ) {
+                        submap *const current_submap = get_submap_at_grid( { x, y, z } );
+                        process_fields_in_submap( current_submap, tripoint( x, y, z ) );
+                    }
+                }
+            }
+            continue;
+        }
+
+        // Decide where the gas and fire of every submap spread on several threads, reading
+        // the fields as they are at the start of the turn. Then process the submaps
+        // one after another as usual, following those decisions where they still
+        // apply. Both steps draw their random numbers from the submap's own seed.
+        std::vector<tripoint> planned;
+        std::vector<oter_id> om_ters;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
                 if( field_cache[ x + y * MAPSIZE ] ) {
-                    submap *const current_submap = get_submap_at_grid( { x, y, z } );
-                    process_fields_in_submap( current_submap, tripoint( x, y, z ) );
+                    planned.emplace_back( x, y, z );
+                    // TODO: fix point types
+                    om_ters.push_back( overmap_buffer.ter( tripoint_abs_omt(
+                                           sm_to_omt_copy( tripoint( abs_sub.xy() + point( x, y ), z ) ) ) ) );
+                }
+            }
+        }
+        if( planned.empty() ) {
+            continue;
+        }
+        // Refreshing the insides of vehicles has side effects, the planning only reads them
+        for( vehicle *veh : get_cache( z ).vehicle_list ) {
+            veh->refresh_insides();
+        }
+        std::vector<planned_field_spreads> plans( planned.size() );
+        field_workers().run( planned.size(), [&]( int i ) {
+            plans[i] = plan_field_spreads( planned[i], om_ters[i] );
+        } );
+
+        size_t next = 0;
+        for( int x = 0; x < my_MAPSIZE; x++ ) {
+            for( int y = 0; y < my_MAPSIZE; y++ ) {
+                if( !field_cache[ x + y * MAPSIZE ] ) {
+                    continue;
+                }
+                const tripoint grid( x, y, z );
+                // Processing the submaps before may have added fields to this one
+                const bool has_plan = next < planned.size() && planned[next] == grid;
+                const scoped_rng_seed seed( field_seed( grid + abs_sub.xy(), 1 ) );
+                process_fields_in_submap( get_submap_at_grid( grid ), grid,
+                                          has_plan ? &plans[next] : nullptr );
+                if( has_plan ) {
+                    next++;
                 }
             }
         }
@@ -208,7 +280,7 @@ std::array<std::pair<tripoint, maptile>, 8> map::get_neighbors( const tripoint &
     };
 }
 
-bool map::gas_can_spread_to( field_entry &cur, const maptile &dst )
+bool map::gas_can_spread_to( const field_entry &cur, const maptile &dst )
 {
     const field_entry *tmpfld = dst.get_field().find_field( cur.get_field_type() );
     // Candidates are existing weaker fields or navigable/flagged tiles with no field.
@@ -247,18 +319,9 @@ void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p )
 }
 
 void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
-                      const time_duration &outdoor_age_speedup, scent_block &sblk )
+                      const time_duration &outdoor_age_speedup, scent_block &sblk,
+                      const planned_gas_spread *plan )
 {
-    map &here = get_map();
-    // TODO: fix point types
-    const oter_id &cur_om_ter =
-        overmap_buffer.ter( tripoint_abs_omt( ms_to_omt_copy( here.getabs( p ) ) ) );
-    const bool sheltered = g->is_sheltered( p );
-    const weather_manager &weather = get_weather();
-    const int winddirection = weather.winddirection;
-    const int windpower = get_local_windpower( weather.windspeed, cur_om_ter, p, winddirection,
-                          sheltered );
-
     const int current_intensity = cur.get_field_intensity();
     const field_type_id ft_id = cur.get_field_type();
 
@@ -278,19 +341,44 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
         cur.set_field_age( current_age + outdoor_age_speedup );
     }
 
+    cata::optional<tripoint> destination;
+    if( plan == nullptr ) {
+        map &here = get_map();
+        // TODO: fix point types
+        const oter_id &cur_om_ter =
+            overmap_buffer.ter( tripoint_abs_omt( ms_to_omt_copy( here.getabs( p ) ) ) );
+        destination = plan_gas_spread( cur, p, percent_spread, cur_om_ter );
+    } else if( plan->destination && current_intensity > 1 &&
+               gas_can_spread_to( cur, maptile_at( *plan->destination ) ) ) {
+        // The fields processed since the plan was made may have filled the destination
+        destination = plan->destination;
+    }
+    if( destination ) {
+        maptile dst = maptile_at( *destination );
+        gas_spread_to( cur, dst, *destination );
+    }
+}
+
+cata::optional<tripoint> map::plan_gas_spread( const field_entry &cur, const tripoint &p,
+        int percent_spread, const oter_id &om_ter )
+{
+    const bool sheltered = g->is_sheltered( p );
+    const weather_manager &weather = get_weather();
+    const int winddirection = weather.winddirection;
+    const int windpower = get_local_windpower( weather.windspeed, om_ter, p, winddirection,
+                          sheltered );
+
     // Bail out if we don't meet the spread chance or required intensity.
-    if( current_intensity <= 1 || rng( 1, 100 - windpower ) > percent_spread ) {
-        return;
+    if( cur.get_field_intensity() <= 1 || rng( 1, 100 - windpower ) > percent_spread ) {
+        return cata::nullopt;
     }
 
     // First check if we can fall
     // TODO: Make fall and rise chances parameters to enable heavy/light gas
     if( zlevels && p.z > -OVERMAP_DEPTH ) {
         const tripoint down{ p.xy(), p.z - 1 };
-        maptile down_tile = maptile_at_internal( down );
-        if( gas_can_spread_to( cur, down_tile ) && valid_move( p, down, true, true ) ) {
-            gas_spread_to( cur, down_tile, down );
-            return;
+        if( gas_can_spread_to( cur, maptile_at_internal( down ) ) && valid_move( p, down, true, true ) ) {
+            return down;
         }
     }
 
@@ -317,9 +405,8 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
     const maptile remove_tile3 = std::get<2>( maptiles );
     if( !spread.empty() && ( !zlevels || one_in( spread.size() ) ) ) {
         // Construct the destination from offset and p
-        if( g->is_sheltered( p ) || windpower < 5 ) {
-            std::pair<tripoint, maptile> &n = neighs[ random_entry( spread ) ];
-            gas_spread_to( cur, n.second, n.first );
+        if( sheltered || windpower < 5 ) {
+            return neighs[ random_entry( spread ) ].first;
         } else {
             end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
             // Start at end_it + 1, then wrap around until all elements have been processed.
@@ -336,17 +423,50 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
                 }
             }
             if( !neighbour_vec.empty() ) {
-                std::pair<tripoint, maptile> &n = neighs[neighbour_vec[rng( 0, neighbour_vec.size() - 1 )]];
-                gas_spread_to( cur, n.second, n.first );
+                return neighs[neighbour_vec[rng( 0, neighbour_vec.size() - 1 )]].first;
             }
         }
     } else if( zlevels && p.z < OVERMAP_HEIGHT ) {
         const tripoint up{ p.xy(), p.z + 1 };
-        maptile up_tile = maptile_at_internal( up );
-        if( gas_can_spread_to( cur, up_tile ) && valid_move( p, up, true, true ) ) {
-            gas_spread_to( cur, up_tile, up );
+        if( gas_can_spread_to( cur, maptile_at_internal( up ) ) && valid_move( p, up, true, true ) ) {
+            return up;
         }
     }
+    return cata::nullopt;
+}
+
+map::planned_field_spreads map::plan_field_spreads( const tripoint &submap_pos,
+        const oter_id &om_ter )
+{
+    const scoped_rng_seed seed( field_seed( submap_pos + abs_sub.xy(), 0 ) );
+    planned_field_spreads plans;
+    submap *const current_submap = get_submap_at_grid( submap_pos );
+    const point sm_offset( submap_pos.x * SEEX, submap_pos.y * SEEY );
+    // Same order as process_fields_in_submap
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            field &curfield = current_submap->get_field( { x, y } );
+            if( !curfield.displayed_field_type() ) {
+                continue;
+            }
+            const tripoint p( sm_offset + point( x, y ), submap_pos.z );
+            for( std::pair<const field_type_id, field_entry> &fd : curfield ) {
+                field_entry &cur = fd.second;
+                // Newborn fields are not processed
+                if( cur.get_field_age() == 0_turns ) {
+                    continue;
+                }
+                if( fd.first == fd_fire ) {
+                    plans.fire.push_back( { point( x, y ), plan_fire_spread( cur, p ) } );
+                }
+                if( cur.gas_can_spread() ) {
+                    plans.gas.push_back( { point( x, y ), fd.first,
+                                           plan_gas_spread( cur, p, fd.first->percent_spread, om_ter ) } );
+                }
+            }
+        }
+    }
+    return plans;
 }
 
 static inline bool check_flammable( const map_data_common_t &t )
@@ -355,6 +475,56 @@ static inline bool check_flammable( const map_data_common_t &t )
            t.has_flag( TFLAG_FLAMMABLE_HARD );
 }
 
+std::vector<std::pair<int, bool>> map::plan_fire_spread( const field_entry &cur,
+                               const tripoint &p )
+{
+    std::vector<std::pair<int, bool>> targets;
+    const maptile fire_tile = maptile_at_internal( p );
+    if( ter_furn_has_flag( fire_tile.get_ter_t(), fire_tile.get_furn_t(), TFLAG_FIRE_CONTAINER ) ) {
+        return targets;
+    }
+    // Compared by int id, resolving a string id is not safe on several threads
+    const bool in_pit = fire_tile.get_ter() == t_pit;
+    std::array<std::pair<tripoint, maptile>, 8> neighs = get_neighbors( p );
+    // The same checks as where the fire spreads in process_fields_in_submap
+    const size_t end_i = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+    for( size_t i = ( end_i + 1 ) % neighs.size(), count = 0;
+         count != neighs.size();
+         i = ( i + 1 ) % neighs.size(), count++ ) {
+        if( one_in( cur.get_field_intensity() * 2 ) ) {
+            continue;
+        }
+        maptile &dst = neighs[i].second;
+        if( dst.find_field( fd_fire ) != nullptr ) {
+            continue;
+        }
+        const bool near_web = dst.find_field( fd_web ) != nullptr;
+        int spread_chance = 25 * ( cur.get_field_intensity() - 1 );
+        if( near_web ) {
+            spread_chance = 50 + spread_chance / 2;
+        }
+        const ter_t &dster = dst.get_ter_t();
+        const furn_t &dsfrn = dst.get_furn_t();
+        const int power = cur.get_field_intensity() + one_in( 5 );
+        if( rng( 1, 100 ) >= spread_chance ||
+            !( check_flammable( dster ) || check_flammable( dsfrn ) ) ||
+            in_pit != ( dst.get_ter() == t_pit ) ) {
+            continue;
+        }
+        if( ( power >= 3 && cur.get_field_age() < 0_turns && one_in( 20 ) ) ||
+            ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE ) && one_in( 2 ) ) ) ||
+            ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_ASH ) && one_in( 2 ) ) ) ||
+            ( power >= 3 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_HARD ) && one_in( 5 ) ) ) ||
+            near_web ) {
+            targets.emplace_back( static_cast<int>( i ), false );
+        } else if( dst.get_item_count() > 0 && one_in( 5 ) ) {
+            // Item materials are looked up by string id, so that part waits for the main thread
+            targets.emplace_back( static_cast<int>( i ), true );
+        }
+    }
+    return targets;
+}
+
 /*
 Helper function that encapsulates the logic involved in creating hot air.
 */
@@ -392,7 +562,7 @@ This is the general update function for field effects. This should only be calle
 If you need to insert a new field behavior per unit time add a case statement in the switch below.
 */
 void map::process_fields_in_submap( submap *const current_submap,
-                                    const tripoint &submap )
+                                    const tripoint &submap, const planned_field_spreads *plans )
 {
     scent_block sblk( submap, g->scent );
 
@@ -409,6 +579,31 @@ void map::process_fields_in_submap( submap *const current_submap,
     int &locy = map_tile.pos_.y;
     const point sm_offset( submap.x * SEEX, submap.y * SEEY );
 
+    // The plans are in the order the fields are visited, but fields may have come and
+    // gone since they were made
+    size_t next_plan = 0;
+    const auto find_plan = [&]( const point & local,
+    const field_type_id & type ) -> const planned_gas_spread * {
+        for( ; plans != nullptr && next_plan < plans->gas.size(); next_plan++ ) {
+            const planned_gas_spread &plan = plans->gas[next_plan];
+            if( std::tie( plan.local.x, plan.local.y, plan.type ) >= std::tie( local.x, local.y, type ) ) {
+                return plan.local == local && plan.type == type ? &plan : nullptr;
+            }
+        }
+        return nullptr;
+    };
+    size_t next_fire_plan = 0;
+    const auto find_fire_plan = [&]( const point & local ) -> const planned_fire_spread * {
+        for( ; plans != nullptr && next_fire_plan < plans->fire.size(); next_fire_plan++ )
+        {
+            const planned_fire_spread &plan = plans->fire[next_fire_plan];
+            if( std::tie( plan.local.x, plan.local.y ) >= std::tie( local.x, local.y ) ) {
+                return plan.local == local ? &plan : nullptr;
+            }
+        }
+        return nullptr;
+    };
+
     // Loop through all tiles in this submap indicated by current_submap
     for( locx = 0; locx < SEEX; locx++ ) {
         for( locy = 0; locy < SEEY; locy++ ) {
@@ -778,64 +973,81 @@ void map::process_fields_in_submap( submap *const current_submap,
                             }
                         }
 
-                        // Consume adjacent fuel / terrain / webs to spread.
-                        // Our iterator will start at end_i + 1 and increment from there and then wrap around.
-                        // This guarantees it will check all neighbors, starting from a random one
-                        const size_t end_i = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
-                        for( size_t i = ( end_i + 1 ) % neighs.size(), count = 0;
-                             count != neighs.size();
-                             i = ( i + 1 ) % neighs.size(), count++ ) {
-                            if( one_in( cur.get_field_intensity() * 2 ) ) {
-                                // Skip some processing to save on CPU
-                                continue;
+                        // Sets a neighbour on fire and burns away its web
+                        const auto ignite = [&]( size_t i, field_entry * nearwebfld ) {
+                            // Nearby open flammable ground? Set it on fire.
+                            add_field( neighs[i].first, fd_fire, 1, 0_turns, false );
+                            tmpfld = neighs[i].second.find_field( fd_fire );
+                            if( tmpfld != nullptr ) {
+                                // Make the new fire quite weak, so that it doesn't start jumping around instantly
+                                tmpfld->set_field_age( 2_minutes );
+                                // Consume a bit of our fuel
+                                cur.set_field_age( cur.get_field_age() + 1_minutes );
                             }
-
-                            tripoint &dst_p = neighs[i].first;
-                            maptile &dst = neighs[i].second;
-                            // No bounds checking here: we'll treat the invalid neighbors as valid.
-                            // We're using the map tile wrapper, so we can treat invalid tiles as sentinels.
-                            // This will create small oddities on map edges, but nothing more noticeable than
-                            // "cut-off" that happens with bounds checks.
-
-                            field_entry *nearfire = dst.find_field( fd_fire );
-                            if( nearfire != nullptr ) {
-                                // We handled supporting fires in the section above, no need to do it here
-                                continue;
+                            if( nearwebfld ) {
+                                nearwebfld->set_field_intensity( 0 );
                             }
-
-                            field_entry *nearwebfld = dst.find_field( fd_web );
-                            int spread_chance = 25 * ( cur.get_field_intensity() - 1 );
-                            if( nearwebfld != nullptr ) {
-                                spread_chance = 50 + spread_chance / 2;
+                        };
+
+                        if( const planned_fire_spread *fire_plan = find_fire_plan( point( locx, locy ) ) ) {
+                            for( const std::pair<int, bool> &target : fire_plan->targets ) {
+                                maptile &dst = neighs[target.first].second;
+                                // The fires processed since the plan was made may have got there first
+                                if( dst.find_field( fd_fire ) != nullptr ||
+                                    ( target.second &&
+                                      !flammable_items_at( p + eight_horizontal_neighbors[target.first] ) ) ) {
+                                    continue;
+                                }
+                                ignite( target.first, dst.find_field( fd_web ) );
                             }
+                        } else {
+                            // Consume adjacent fuel / terrain / webs to spread.
+                            // Our iterator will start at end_i + 1 and increment from there and then wrap around.
+                            // This guarantees it will check all neighbors, starting from a random one
+                            const size_t end_i = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+                            for( size_t i = ( end_i + 1 ) % neighs.size(), count = 0;
+                                 count != neighs.size();
+                                 i = ( i + 1 ) % neighs.size(), count++ ) {
+                                if( one_in( cur.get_field_intensity() * 2 ) ) {
+                                    // Skip some processing to save on CPU
+                                    continue;
+                                }
 
-                            const ter_t &dster = dst.get_ter_t();
-                            const furn_t &dsfrn = dst.get_furn_t();
-                            // Allow weaker fires to spread occasionally
-                            const int power = cur.get_field_intensity() + one_in( 5 );
-                            if( can_spread && rng( 1, 100 ) < spread_chance &&
-                                ( check_flammable( dster ) || check_flammable( dsfrn ) ) &&
-                                ( in_pit == ( dster.id.id() == t_pit ) ) &&
-                                (
-                                    ( power >= 3 && cur.get_field_age() < 0_turns && one_in( 20 ) ) ||
-                                    ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE ) && one_in( 2 ) ) ) ||
-                                    ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_ASH ) && one_in( 2 ) ) ) ||
-                                    ( power >= 3 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_HARD ) && one_in( 5 ) ) ) ||
-                                    nearwebfld || ( dst.get_item_count() > 0 &&
-                                                    flammable_items_at( p + eight_horizontal_neighbors[i] ) &&
-                                                    one_in( 5 ) )
-                                ) ) {
-                                // Nearby open flammable ground? Set it on fire.
-                                add_field( dst_p, fd_fire, 1, 0_turns, false );
-                                tmpfld = dst.find_field( fd_fire );
-                                if( tmpfld != nullptr ) {
-                                    // Make the new fire quite weak, so that it doesn't start jumping around instantly
-                                    tmpfld->set_field_age( 2_minutes );
-                                    // Consume a bit of our fuel
-                                    cur.set_field_age( cur.get_field_age() + 1_minutes );
+                                maptile &dst = neighs[i].second;
+                                // No bounds checking here: we'll treat the invalid neighbors as valid.
+                                // We're using the map tile wrapper, so we can treat invalid tiles as sentinels.
+                                // This will create small oddities on map edges, but nothing more noticeable than
+                                // "cut-off" that happens with bounds checks.
+
+                                field_entry *nearfire = dst.find_field( fd_fire );
+                                if( nearfire != nullptr ) {
+                                    // We handled supporting fires in the section above, no need to do it here
+                                    continue;
                                 }
-                                if( nearwebfld ) {
-                                    nearwebfld->set_field_intensity( 0 );
+
+                                field_entry *nearwebfld = dst.find_field( fd_web );
+                                int spread_chance = 25 * ( cur.get_field_intensity() - 1 );
+                                if( nearwebfld != nullptr ) {
+                                    spread_chance = 50 + spread_chance / 2;
+                                }
+
+                                const ter_t &dster = dst.get_ter_t();
+                                const furn_t &dsfrn = dst.get_furn_t();
+                                // Allow weaker fires to spread occasionally
+                                const int power = cur.get_field_intensity() + one_in( 5 );
+                                if( can_spread && rng( 1, 100 ) < spread_chance &&
+                                    ( check_flammable( dster ) || check_flammable( dsfrn ) ) &&
+                                    ( in_pit == ( dster.id.id() == t_pit ) ) &&
+                                    (
+                                        ( power >= 3 && cur.get_field_age() < 0_turns && one_in( 20 ) ) ||
+                                        ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE ) && one_in( 2 ) ) ) ||
+                                        ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_ASH ) && one_in( 2 ) ) ) ||
+                                        ( power >= 3 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_HARD ) && one_in( 5 ) ) ) ||
+                                        nearwebfld || ( dst.get_item_count() > 0 &&
+                                                        flammable_items_at( p + eight_horizontal_neighbors[i] ) &&
+                                                        one_in( 5 ) )
+                                    ) ) {
+                                    ignite( i, nearwebfld );
                                 }
                             }
                         }
@@ -847,7 +1059,8 @@ void map::process_fields_in_submap( submap *const current_submap,
                     const int gas_percent_spread = cur_fd_type.percent_spread;
                     if( gas_percent_spread > 0 ) {
                         const time_duration outdoor_age_speedup = cur_fd_type.outdoor_age_speedup;
-                        spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk );
+                        spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk,
+                                    find_plan( point( locx, locy ), cur_fd_type_id ) );
                     }
                 }
 
@@ -0,0 +1,76 @@
+#include "map_prefetch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#include "coordinate_conversions.h"
+#include "game_constants.h"
+#include "map.h"
+#include "mapbuffer.h"
+
+// Expected shift of the map along one axis after moving with the given speed
+static int predicted_shift( int velocity )
+{
+    if( velocity == 0 ) {
+        return 0;
+    }
+    // Always at least the next row of submaps, the map shifts before the player
+    // reaches its edge.
+    const int shift = std::max( 1, std::abs( velocity ) * map_prefetcher::lookahead_turns / SEEX );
+    return velocity > 0 ? std::min( shift, MAPSIZE ) : -std::min( shift, MAPSIZE );
+}
+
+std::vector<tripoint> map_prefetcher::predict_quads( const tripoint &abs_sub,
+        const point &velocity, const int min_z, const int max_z )
+{
+    const point shift( predicted_shift( velocity.x ), predicted_shift( velocity.y ) );
+    if( shift == point_zero ) {
+        return std::vector<tripoint>();
+    }
+    std::set<tripoint> quads;
+    const point corner = abs_sub.xy() + shift;
+    for( int x = corner.x; x < corner.x + MAPSIZE; ++x ) {
+        for( int y = corner.y; y < corner.y + MAPSIZE; ++y ) {
+            const bool loaded = x >= abs_sub.x && x < abs_sub.x + MAPSIZE &&
+                                y >= abs_sub.y && y < abs_sub.y + MAPSIZE;
+            if( loaded ) {
+                continue;
+            }
+            for( int z = min_z; z <= max_z; ++z ) {
+                quads.insert( sm_to_omt_copy( tripoint( x, y, z ) ) );
+            }
+        }
+    }
+    return std::vector<tripoint>( quads.begin(), quads.end() );
+}
+
+void map_prefetcher::update( const tripoint &player_pos, const tripoint &abs_sub,
+                             const bool zlevels )
+{
+    MAPBUFFER.load_prefetched( quads_per_turn );
+    for( const tripoint &om_addr : MAPBUFFER.take_unsaved_prefetched( generated_quads_per_turn ) ) {
+        // Looking it up first loads it if it has been saved after all
+        const tripoint sm_addr = omt_to_sm_copy( om_addr );
+        if( MAPBUFFER.lookup_submap( sm_addr ) == nullptr ) {
+            map::generate_quad( sm_addr );
+        }
+    }
+
+    const cata::optional<tripoint> last_pos = last_player_pos;
+    last_player_pos = player_pos;
+    if( !last_pos ) {
+        return;
+    }
+    const point velocity = player_pos.xy() - last_pos->xy();
+    // Teleports and the like are no movement to extrapolate
+    if( std::abs( velocity.x ) > MAPSIZE_X || std::abs( velocity.y ) > MAPSIZE_Y ) {
+        return;
+    }
+    const int min_z = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int max_z = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    const std::vector<tripoint> quads = predict_quads( abs_sub, velocity, min_z, max_z );
+    if( !quads.empty() ) {
+        MAPBUFFER.prefetch( quads );
+    }
+}
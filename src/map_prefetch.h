@@ -0,0 +1,50 @@
+#pragma once
+#ifndef CATA_SRC_MAP_PREFETCH_H
+#define CATA_SRC_MAP_PREFETCH_H
+
+#include <vector>
+
+#include "optional.h"
+#include "point.h"
+
+/**
+ * Reads the saved submaps the reality bubble is about to move onto ahead of time.
+ *
+ * The player's movement over the last turn is used to guess where the bubble will
+ * be a few turns later, and the quads that would enter it are handed to
+ * @ref mapbuffer::prefetch. Whatever has been read in the meantime is loaded into
+ * the buffer a few quads per turn, so shifting the map only has to look them up.
+ * Quads that turn out to have never been generated are generated on this thread,
+ * one per turn, instead of all at once when the map shifts onto them.
+ */
+class map_prefetcher
+{
+    public:
+        /** How many turns of movement the prediction covers. */
+        static constexpr int lookahead_turns = 10;
+        /** At most this many read quads get loaded each turn. */
+        static constexpr int quads_per_turn = 4;
+        /** At most this many missing quads get generated each turn. */
+        static constexpr int generated_quads_per_turn = 1;
+
+        /**
+         * Called once per turn.
+         * @param player_pos Absolute map square position of the player.
+         * @param abs_sub Absolute submap position of the map's corner, @ref map::get_abs_sub.
+         * @param zlevels Whether the map holds all z-levels or only the player's.
+         */
+        void update( const tripoint &player_pos, const tripoint &abs_sub, bool zlevels );
+
+        /**
+         * The quads, in absolute overmap terrain coordinates, that enter the map when
+         * its corner moves from @p abs_sub while the player moves @p velocity map
+         * squares per turn for @ref lookahead_turns turns.
+         */
+        static std::vector<tripoint> predict_quads( const tripoint &abs_sub, const point &velocity,
+                int min_z, int max_z );
+
+    private:
+        cata::optional<tripoint> last_player_pos;
+};
+
+#endif // CATA_SRC_MAP_PREFETCH_H
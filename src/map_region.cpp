@@ -0,0 +1,317 @@
+#include "map_region.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "catacharset.h"
+#include "filesystem.h"
+
+namespace
+{
+
+constexpr std::array<char, 4> magic = {{ 'C', 'B', 'N', 'R' }};
+constexpr uint32_t format_version = 2;
+// Magic, version, generation and checksum, then the location of every quad
+constexpr size_t generation_pos = magic.size() + 4;
+constexpr size_t checksum_pos = generation_pos + 4;
+constexpr size_t index_pos = checksum_pos + 4;
+constexpr size_t header_bytes = index_pos + map_region::size * map_region::size * 8;
+constexpr int slot_sectors = ( header_bytes + map_region::sector_size - 1 ) /
+                             map_region::sector_size;
+// Two copies of the header, written alternately
+constexpr int header_sectors = 2 * slot_sectors;
+
+int sectors_for( uint32_t length )
+{
+    return static_cast<int>( ( length + map_region::sector_size - 1 ) / map_region::sector_size );
+}
+
+void put_u32( std::string &out, uint32_t v )
+{
+    for( int i = 0; i < 4; i++ ) {
+        out.push_back( static_cast<char>( ( v >> ( 8 * i ) ) & 0xff ) );
+    }
+}
+
+uint32_t get_u32( const std::string &in, size_t pos )
+{
+    uint32_t v = 0;
+    for( int i = 0; i < 4; i++ ) {
+        v |= static_cast<uint32_t>( static_cast<unsigned char>( in[pos + i] ) ) << ( 8 * i );
+    }
+    return v;
+}
+
+// FNV-1a of the header, skipping the checksum itself
+uint32_t header_checksum( const std::string &header )
+{
+    uint32_t hash = 2166136261u;
+    for( size_t i = 0; i < header.size(); i++ ) {
+        if( i >= checksum_pos && i < index_pos ) {
+            continue;
+        }
+        hash = ( hash ^ static_cast<unsigned char>( header[i] ) ) * 16777619u;
+    }
+    return hash;
+}
+
+size_t slot_offset( uint32_t generation )
+{
+    return static_cast<size_t>( generation % 2 ) * slot_sectors * map_region::sector_size;
+}
+
+// Region files are updated in place, which the stream wrappers in fstream_utils.h
+// do not support, so this uses stdio directly.
+class file_handle
+{
+    public:
+        file_handle( const std::string &path, const char *mode ) {
+#if defined(_WIN32)
+            file = _wfopen( utf8_to_wstr( path ).c_str(), utf8_to_wstr( mode ).c_str() );
+#else
+            file = std::fopen( path.c_str(), mode );
+#endif
+            if( file == nullptr ) {
+                throw std::runtime_error( "opening map region " + path + " failed" );
+            }
+        }
+        file_handle( const file_handle & ) = delete;
+        file_handle &operator=( const file_handle & ) = delete;
+        ~file_handle() {
+            if( file != nullptr ) {
+                std::fclose( file );
+            }
+        }
+
+        void seek( size_t pos ) {
+            if( std::fseek( file, static_cast<long>( pos ), SEEK_SET ) != 0 ) {
+                throw std::runtime_error( "seeking in map region failed" );
+            }
+        }
+        void read( std::string &out, size_t length ) {
+            if( !try_read( out, length ) ) {
+                throw std::runtime_error( "map region is truncated" );
+            }
+        }
+        bool try_read( std::string &out, size_t length ) {
+            out.resize( length );
+            return length == 0 || std::fread( &out[0], 1, length, file ) == length;
+        }
+        void write( const std::string &data ) {
+            if( std::fwrite( data.data(), 1, data.size(), file ) != data.size() ) {
+                throw std::runtime_error( "writing map region failed" );
+            }
+        }
+        // What was written so far reaches the disk before anything written later
+        void sync() {
+            bool failed = std::fflush( file ) != 0;
+#if defined(_WIN32)
+            failed = failed || _commit( _fileno( file ) ) != 0;
+#else
+            failed = failed || fsync( fileno( file ) ) != 0;
+#endif
+            if( failed ) {
+                throw std::runtime_error( "writing map region failed" );
+            }
+        }
+        void close() {
+            const bool failed = std::fflush( file ) != 0 || std::ferror( file ) != 0;
+            const bool close_failed = std::fclose( file ) != 0;
+            file = nullptr;
+            if( failed || close_failed ) {
+                throw std::runtime_error( "writing map region failed" );
+            }
+        }
+
+    private:
+        FILE *file = nullptr;
+};
+
+int local_index( const point &local )
+{
+    if( local.x < 0 || local.y < 0 || local.x >= map_region::size || local.y >= map_region::size ) {
+        throw std::runtime_error( "quad is outside of the map region" );
+    }
+    return local.y * map_region::size + local.x;
+}
+
+} // namespace
+
+map_region::map_region( const std::string &path ) : path( path ),
+    index( size * size ), used( header_sectors, true )
+{
+    if( !file_exist( path ) ) {
+        return;
+    }
+    file_handle file( path, "rb" );
+    // The newer of the two headers, unless it was torn by an interrupted save
+    std::string header;
+    bool found = false;
+    for( uint32_t slot = 0; slot < 2; slot++ ) {
+        std::string candidate;
+        file.seek( slot_offset( slot ) );
+        if( !file.try_read( candidate, header_bytes ) ||
+            !std::equal( magic.begin(), magic.end(), candidate.begin() ) ) {
+            continue;
+        }
+        if( get_u32( candidate, magic.size() ) != format_version ) {
+            throw std::runtime_error( path + " has an unsupported map region version" );
+        }
+        const uint32_t candidate_generation = get_u32( candidate, generation_pos );
+        if( header_checksum( candidate ) != get_u32( candidate, checksum_pos ) ||
+            candidate_generation % 2 != slot ) {
+            continue;
+        }
+        if( !found || candidate_generation > generation ) {
+            header = std::move( candidate );
+            generation = candidate_generation;
+            found = true;
+        }
+    }
+    if( !found ) {
+        throw std::runtime_error( path + " has no readable map region header" );
+    }
+    for( size_t i = 0; i < index.size(); i++ ) {
+        entry &e = index[i];
+        e.sector = get_u32( header, index_pos + i * 8 );
+        e.length = get_u32( header, index_pos + 4 + i * 8 );
+        if( e.sector == 0 ) {
+            continue;
+        }
+        if( e.sector < static_cast<uint32_t>( header_sectors ) ) {
+            throw std::runtime_error( path + " has a corrupted index" );
+        }
+        const size_t end = e.sector + sectors_for( e.length );
+        if( used.size() < end ) {
+            used.resize( end, false );
+        }
+        std::fill( used.begin() + e.sector, used.begin() + end, true );
+    }
+}
+
+bool map_region::contains( const point &local ) const
+{
+    return index[local_index( local )].sector != 0;
+}
+
+std::string map_region::read( const point &local ) const
+{
+    const entry &e = index[local_index( local )];
+    std::string ret;
+    if( e.sector == 0 ) {
+        return ret;
+    }
+    file_handle file( path, "rb" );
+    file.seek( static_cast<size_t>( e.sector ) * sector_size );
+    file.read( ret, e.length );
+    return ret;
+}
+
+std::vector<point> map_region::quads() const
+{
+    std::vector<point> ret;
+    for( int i = 0; i < size * size; i++ ) {
+        if( index[i].sector != 0 ) {
+            ret.emplace_back( i % size, i / size );
+        }
+    }
+    return ret;
+}
+
+int map_region::allocate( int sectors )
+{
+    int run = 0;
+    for( int s = header_sectors; s < static_cast<int>( used.size() ); s++ ) {
+        run = used[s] ? 0 : run + 1;
+        if( run == sectors ) {
+            std::fill( used.begin() + s + 1 - sectors, used.begin() + s + 1, true );
+            return s + 1 - sectors;
+        }
+    }
+    // Grow the file, reusing the free sectors at its end
+    const int start = static_cast<int>( used.size() ) - run;
+    used.resize( start + sectors );
+    std::fill( used.begin() + start, used.end(), true );
+    return start;
+}
+
+void map_region::release( const entry &e )
+{
+    if( e.sector == 0 ) {
+        return;
+    }
+    std::fill( used.begin() + e.sector, used.begin() + e.sector + sectors_for( e.length ), false );
+}
+
+void map_region::write( const std::vector<std::pair<point, std::string>> &quads )
+{
+    if( quads.empty() ) {
+        return;
+    }
+    const std::vector<entry> old_index = index;
+    const std::vector<bool> old_used = used;
+    try {
+        // New data never overwrites sectors the current header points to, those
+        // are only released once the new header has been written.
+        std::vector<entry> replaced;
+        std::vector<std::pair<uint32_t, const std::string *>> writes;
+        for( const std::pair<point, std::string> &quad : quads ) {
+            entry &e = index[local_index( quad.first )];
+            replaced.push_back( e );
+            e = entry();
+            if( quad.second.empty() ) {
+                continue;
+            }
+            e.sector = allocate( sectors_for( quad.second.size() ) );
+            e.length = static_cast<uint32_t>( quad.second.size() );
+            writes.emplace_back( e.sector, &quad.second );
+        }
+        // In file order, so the writes are as sequential as the free space allows
+        std::sort( writes.begin(), writes.end() );
+
+        file_handle file( path, file_exist( path ) ? "r+b" : "w+b" );
+        for( const std::pair<uint32_t, const std::string *> &w : writes ) {
+            file.seek( static_cast<size_t>( w.first ) * sector_size );
+            file.write( *w.second );
+        }
+        // The header must not point at data that is not on the disk yet
+        file.sync();
+
+        // Replaces the older header, the current one stays intact if this is interrupted
+        const uint32_t new_generation = generation + 1;
+        std::string header( magic.begin(), magic.end() );
+        header.reserve( header_bytes );
+        put_u32( header, format_version );
+        put_u32( header, new_generation );
+        put_u32( header, 0 );
+        for( const entry &e : index ) {
+            put_u32( header, e.sector );
+            put_u32( header, e.length );
+        }
+        const uint32_t checksum = header_checksum( header );
+        for( int i = 0; i < 4; i++ ) {
+            header[checksum_pos + i] = static_cast<char>( ( checksum >> ( 8 * i ) ) & 0xff );
+        }
+        file.seek( slot_offset( new_generation ) );
+        file.write( header );
+        file.sync();
+        file.close();
+        generation = new_generation;
+
+        for( const entry &e : replaced ) {
+            release( e );
+        }
+    } catch( ... ) {
+        index = old_index;
+        used = old_used;
+        throw;
+    }
+}
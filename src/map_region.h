@@ -0,0 +1,73 @@
+#pragma once
+#ifndef CATA_SRC_MAP_REGION_H
+#define CATA_SRC_MAP_REGION_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game_constants.h"
+#include "point.h"
+
+/**
+ * A single file packing the saved submap quads of one map segment
+ * (SEG_SIZE x SEG_SIZE overmap terrains), so @ref mapbuffer does a few large
+ * reads and writes instead of touching one small file per quad.
+ *
+ * The file starts with two copies of a header holding the location of every
+ * quad, followed by the quad data in fixed size sectors. A quad that is saved
+ * again is written to free sectors first. Once that data is on the disk the
+ * older header copy is replaced, with a generation counter and a checksum.
+ * An interrupted save therefore leaves the previous header and the data it
+ * points to readable. Sectors no longer used by any quad are reused by later
+ * writes.
+ */
+class map_region
+{
+    public:
+        /** Quads along each side of a region. */
+        static constexpr int size = SEG_SIZE;
+        static constexpr int sector_size = 4096;
+
+        /** Loads the header of the region file at @p path, if it exists. */
+        explicit map_region( const std::string &path );
+
+        /** Whether the quad at @p local (0 <= x, y < size) has been written. */
+        bool contains( const point &local ) const;
+        /**
+         * Data written for the quad at @p local, empty if there is none.
+         * @throw std::runtime_error on I/O errors.
+         */
+        std::string read( const point &local ) const;
+        /**
+         * Writes the data of several quads, replacing earlier versions.
+         * @throw std::runtime_error on I/O errors.
+         */
+        void write( const std::vector<std::pair<point, std::string>> &quads );
+        /** Local positions of all quads in the region. */
+        std::vector<point> quads() const;
+
+        /** Sectors in the file, including the header and free ones. */
+        int sector_count() const {
+            return static_cast<int>( used.size() );
+        }
+
+    private:
+        struct entry {
+            // 0 if the quad is not stored, sector 0 is always part of the header
+            uint32_t sector = 0;
+            uint32_t length = 0;
+        };
+
+        int allocate( int sectors );
+        void release( const entry &e );
+
+        std::string path;
+        std::vector<entry> index;
+        std::vector<bool> used;
+        // Of the header the index was read from or last written to
+        uint32_t generation = 0;
+};
+
+#endif // CATA_SRC_MAP_REGION_H
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <utility>
@@ -18,10 +19,13 @@
 #include "game_constants.h"
 #include "json.h"
 #include "map.h"
+#include "map_region.h"
+#include "options.h"
 #include "output.h"
 #include "popup.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_binary.h"
 #include "translations.h"
 #include "ui_manager.h"
 
@@ -37,6 +41,102 @@ static std::string find_dirname( const tripoint &om_addr )
                           segment_addr.y, segment_addr.z );
 }
 
+static std::string find_region_path( const tripoint &segment_addr )
+{
+    return string_format( "%s/maps/%d.%d.%d.region", g->get_world_base_save_path(),
+                          segment_addr.x, segment_addr.y, segment_addr.z );
+}
+
+// Position of the quad within its region
+static point region_local( const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    return om_addr.xy() - segment_addr.xy() * SEG_SIZE;
+}
+
+using quad_contents = std::vector<std::pair<tripoint, std::unique_ptr<submap>>>;
+
+// We're reading in way too many entities here to mess around with creating sub-objects and
+// seeking around in them, so we're using the json streaming API.
+static quad_contents read_json_quad( JsonIn &jsin )
+{
+    quad_contents ret;
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+        tripoint submap_coordinates;
+        jsin.start_object();
+        int version = 0;
+        while( !jsin.end_object() ) {
+            std::string submap_member_name = jsin.get_member_name();
+            if( submap_member_name == "version" ) {
+                version = jsin.get_int();
+            } else if( submap_member_name == "coordinates" ) {
+                jsin.start_array();
+                tripoint loc{ jsin.get_int(), jsin.get_int(), jsin.get_int() };
+                jsin.end_array();
+                submap_coordinates = loc;
+            } else {
+                sm->load( jsin, submap_member_name, version );
+            }
+        }
+        ret.emplace_back( submap_coordinates, std::move( sm ) );
+    }
+    return ret;
+}
+
+// Parses a saved quad in either the binary or the JSON format.
+static quad_contents parse_quad( const std::string &data )
+{
+    if( submap_binary::is_binary( data ) ) {
+        return submap_binary::decode_quad( data );
+    }
+    std::istringstream buffer( data );
+    JsonIn jsin( buffer );
+    return read_json_quad( jsin );
+}
+
+// Reads a quad from a file of the layout used before map regions.
+static bool read_legacy_quad( const std::string &path, quad_contents &quad )
+{
+    return read_from_file_optional( path, [&quad]( std::istream & fin ) {
+        quad = parse_quad( std::string( std::istreambuf_iterator<char>( fin ),
+                                        std::istreambuf_iterator<char>() ) );
+    } );
+}
+
+// Serializes a quad in the format selected by the MAP_SAVE_FORMAT option.
+static std::string serialize_quad( const std::vector<std::pair<tripoint, const submap *>> &quad )
+{
+    const std::string format = get_option<std::string>( "MAP_SAVE_FORMAT" );
+    if( format != "json" ) {
+        return submap_binary::encode_quad( quad, format == "binary_compressed" ?
+                                           submap_binary::compression::lz :
+                                           submap_binary::compression::none );
+    }
+    std::ostringstream fout;
+    JsonOut jsout( fout );
+    jsout.start_array();
+    for( const std::pair<tripoint, const submap *> &entry : quad ) {
+        jsout.start_object();
+
+        jsout.member( "version", savegame_version );
+        jsout.member( "coordinates" );
+
+        jsout.start_array();
+        jsout.write( entry.first.x );
+        jsout.write( entry.first.y );
+        jsout.write( entry.first.z );
+        jsout.end_array();
+
+        entry.second->store( jsout );
+
+        jsout.end_object();
+    }
+    jsout.end_array();
+    return fout.str();
+}
+
 mapbuffer MAPBUFFER;
 
 mapbuffer::mapbuffer() = default;
@@ -48,10 +148,83 @@ mapbuffer::~mapbuffer()
 
 void mapbuffer::reset()
 {
+    discard_prefetched();
+    finish_background_save();
     for( auto &elem : submaps ) {
         delete elem.second;
     }
     submaps.clear();
+    regions.clear();
+    saved_quad_hashes.clear();
+}
+
+map_region &mapbuffer::get_region( const tripoint &segment_addr )
+{
+    std::unique_ptr<map_region> &region = regions[segment_addr];
+    if( !region ) {
+        region = std::make_unique<map_region>( find_region_path( segment_addr ) );
+    }
+    return *region;
+}
+
+std::vector<mapbuffer::pending_region> mapbuffer::prepare_writes(
+    std::map<tripoint, region_writes> &writes )
+{
+    std::vector<pending_region> ret;
+    std::lock_guard<std::mutex> lock( regions_mutex );
+    for( std::pair<const tripoint, region_writes> &region : writes ) {
+        if( region.second.empty() ) {
+            continue;
+        }
+        const tripoint om_addr( region.first.xy() * SEG_SIZE, region.first.z );
+        ret.push_back( { &get_region( region.first ), find_dirname( om_addr ), region.first,
+                         std::move( region.second )
+                       } );
+    }
+    return ret;
+}
+
+void mapbuffer::write_regions( const std::vector<pending_region> &pending )
+{
+    for( const pending_region &region : pending ) {
+        {
+            std::lock_guard<std::mutex> lock( regions_mutex );
+            region.region->write( region.quads );
+        }
+
+        // Files of the old layout would only be shadowed by the region now
+        if( !dir_exist( region.legacy_dir ) ) {
+            continue;
+        }
+        for( const std::pair<point, std::string> &quad : region.quads ) {
+            const tripoint om_addr( region.segment_addr.xy() * SEG_SIZE + quad.first,
+                                    region.segment_addr.z );
+            const std::string quad_path = find_quad_path( region.legacy_dir, om_addr );
+            if( file_exist( quad_path ) ) {
+                remove_file( quad_path );
+            }
+        }
+    }
+}
+
+void mapbuffer::finish_background_save()
+{
+    if( !background_writer.joinable() ) {
+        return;
+    }
+    background_writer.join();
+    in_flight.clear();
+    if( background_error ) {
+        // What was written is unknown, save everything next time
+        saved_quad_hashes.clear();
+        std::exception_ptr error = background_error;
+        background_error = nullptr;
+        try {
+            std::rethrow_exception( error );
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to save the maps: %s", err.what() );
+        }
+    }
 }
 
 bool mapbuffer::add_submap( const tripoint &p, submap *sm )
@@ -100,8 +273,15 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
     return iter->second;
 }
 
-void mapbuffer::save( bool delete_after_save )
+void mapbuffer::save( bool delete_after_save, bool in_background )
 {
+    // A save must not race the previous one, and a synchronous save is only
+    // complete once the earlier writes are. If those failed, this save still
+    // goes on and writes everything again.
+    finish_background_save();
+    // Quads that get unloaded now might be written with new data
+    discard_prefetched();
+
     assure_dir_exist( g->get_world_base_save_path() + "/maps" );
 
     int num_saved_submaps = 0;
@@ -115,6 +295,8 @@ void mapbuffer::save( bool delete_after_save )
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint> saved_submaps;
     std::list<tripoint> submaps_to_delete;
+    // Quads are written once per region after serializing all of them
+    std::map<tripoint, region_writes> writes;
     static constexpr std::chrono::milliseconds update_interval( 500 );
     auto last_update = std::chrono::steady_clock::now();
 
@@ -138,22 +320,38 @@ void mapbuffer::save( bool delete_after_save )
         }
         saved_submaps.insert( om_addr );
 
-        // A segment is a chunk of 32x32 submap quads.
-        // We're breaking them into subdirectories so there aren't too many files per directory.
-        // Might want to make a set for this one too so it's only checked once per save().
-        const std::string dirname = find_dirname( om_addr );
-        const std::string quad_path = find_quad_path( dirname, om_addr );
+        // A segment is a chunk of 32x32 submap quads, all stored in one region file.
+        region_writes &region = writes[omt_to_seg_copy( om_addr )];
 
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
         const bool zlev_del = !map_has_zlevels && om_addr.z != g->get_levz();
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
+        save_quad( region, om_addr, submaps_to_delete,
                    delete_after_save || zlev_del ||
                    om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
                    om_addr.x > map_origin.x + HALF_MAPSIZE ||
                    om_addr.y > map_origin.y + HALF_MAPSIZE );
         num_saved_submaps += 4;
     }
+    std::vector<pending_region> pending = prepare_writes( writes );
+    if( in_background ) {
+        // Everything the writer needs is serialized by now, so play can go on
+        in_flight = std::move( pending );
+        background_writer = std::thread( [this]() {
+            try {
+                write_regions( in_flight );
+            } catch( ... ) {
+                background_error = std::current_exception();
+            }
+        } );
+    } else {
+        try {
+            write_regions( pending );
+        } catch( ... ) {
+            saved_quad_hashes.clear();
+            throw;
+        }
+    }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
@@ -161,9 +359,8 @@ void mapbuffer::save( bool delete_after_save )
     get_distribution_grid_tracker().on_saved();
 }
 
-void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
-                           const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+void mapbuffer::save_quad( region_writes &region, const tripoint &om_addr,
+                           std::list<tripoint> &submaps_to_delete, bool delete_after_save )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -197,56 +394,66 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr];
-
-            if( sm == nullptr ) {
-                continue;
-            }
-
-            jsout.start_object();
-
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+    std::vector<std::pair<tripoint, const submap *>> quad;
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            jsout.start_array();
-            jsout.write( submap_addr.x );
-            jsout.write( submap_addr.y );
-            jsout.write( submap_addr.z );
-            jsout.end_array();
+        submap *sm = submaps[submap_addr];
 
-            sm->store( jsout );
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.end_object();
+        quad.emplace_back( submap_addr, sm );
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
         }
+    }
 
-        jsout.end_array();
-    } );
+    std::string data = serialize_quad( quad );
+    // Quads that did not change since they were last saved are not written again
+    const size_t hash = std::hash<std::string>()( data );
+    const auto iter = saved_quad_hashes.find( om_addr );
+    if( iter != saved_quad_hashes.end() && iter->second == hash ) {
+        return;
+    }
+    saved_quad_hashes[om_addr] = hash;
+    region.emplace_back( region_local( om_addr ), std::move( data ) );
 }
 
-// We're reading in way too many entities here to mess around with creating sub-objects and
-// seeking around in them, so we're using the json streaming API.
 submap *mapbuffer::unserialize_submaps( const tripoint &p )
 {
     // Map the tripoint to the submap quad that stores it.
     const tripoint om_addr = sm_to_omt_copy( p );
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
     const std::string dirname = find_dirname( om_addr );
     std::string quad_path = find_quad_path( dirname, om_addr );
 
-    if( !file_exist( quad_path ) ) {
+    quad_contents quad;
+    const point local = region_local( om_addr );
+    std::string region_data = take_prefetched( om_addr );
+    for( const pending_region &pending : in_flight ) {
+        if( pending.segment_addr != segment_addr ) {
+            continue;
+        }
+        // The background save may not have written this one yet
+        for( const std::pair<point, std::string> &written : pending.quads ) {
+            if( written.first == local ) {
+                region_data = written.second;
+            }
+        }
+    }
+    if( region_data.empty() ) {
+        std::lock_guard<std::mutex> lock( regions_mutex );
+        region_data = get_region( segment_addr ).read( local );
+    }
+    if( !region_data.empty() ) {
+        quad_path = find_region_path( segment_addr );
+        quad = parse_quad( region_data );
+    } else if( !file_exist( quad_path ) ) {
         // Fix for old saves where the path was generated using std::stringstream, which
         // did format the number using the current locale. That formatting may insert
         // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
@@ -258,11 +465,16 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
         }
     }
 
-    using namespace std::placeholders;
-    if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
+    if( quad.empty() && !read_legacy_quad( quad_path, quad ) ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
     }
+    for( std::pair<tripoint, std::unique_ptr<submap>> &entry : quad ) {
+        if( !add_submap( entry.first, entry.second ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", entry.first.x, entry.first.y,
+                      entry.first.z );
+        }
+    }
     if( submaps.count( p ) == 0 ) {
         debugmsg( "file %s did not contain the expected submap %d,%d,%d",
                   quad_path, p.x, p.y, p.z );
@@ -271,31 +483,176 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     return submaps[ p ];
 }
 
-void mapbuffer::deserialize( JsonIn &jsin )
+std::string mapbuffer::take_prefetched( const tripoint &om_addr )
 {
-    jsin.start_array();
-    while( !jsin.end_array() ) {
-        std::unique_ptr<submap> sm = std::make_unique<submap>();
-        tripoint submap_coordinates;
-        jsin.start_object();
-        int version = 0;
-        while( !jsin.end_object() ) {
-            std::string submap_member_name = jsin.get_member_name();
-            if( submap_member_name == "version" ) {
-                version = jsin.get_int();
-            } else if( submap_member_name == "coordinates" ) {
-                jsin.start_array();
-                tripoint loc{ jsin.get_int(), jsin.get_int(), jsin.get_int() };
-                jsin.end_array();
-                submap_coordinates = loc;
+    std::lock_guard<std::mutex> lock( prefetch_mutex );
+    const auto iter = prefetched_quads.find( om_addr );
+    if( iter == prefetched_quads.end() ) {
+        return std::string();
+    }
+    std::string ret = std::move( iter->second );
+    prefetched_quads.erase( iter );
+    return ret;
+}
+
+void mapbuffer::discard_prefetched()
+{
+    if( prefetch_reader.joinable() ) {
+        prefetch_reader.join();
+    }
+    prefetched_quads.clear();
+    unsaved_quads.clear();
+}
+
+void mapbuffer::prefetch( const std::vector<tripoint> &om_addrs )
+{
+    if( prefetch_running ) {
+        return;
+    }
+    if( prefetch_reader.joinable() ) {
+        prefetch_reader.join();
+    }
+    struct read_job {
+        tripoint om_addr;
+        map_region *region;
+    };
+    std::vector<read_job> jobs;
+    {
+        std::lock_guard<std::mutex> lock( prefetch_mutex );
+        for( const tripoint &om_addr : om_addrs ) {
+            const tripoint sm_addr = omt_to_sm_copy( om_addr );
+            if( submaps.count( sm_addr ) != 0 || prefetched_quads.count( om_addr ) != 0 ||
+                unsaved_quads.count( om_addr ) != 0 ) {
+                continue;
+            }
+            const tripoint segment_addr = omt_to_seg_copy( om_addr );
+            const bool saving = std::any_of( in_flight.begin(), in_flight.end(),
+            [&]( const pending_region & pending ) {
+                return pending.segment_addr == segment_addr;
+            } );
+            if( saving ) {
+                continue;
+            }
+            map_region *region = nullptr;
+            try {
+                std::lock_guard<std::mutex> regions_lock( regions_mutex );
+                region = &get_region( segment_addr );
+            } catch( const std::exception & ) {
+                // Loading the quad normally reports the error
+                continue;
+            }
+            jobs.push_back( { om_addr, region } );
+        }
+    }
+    if( jobs.empty() ) {
+        return;
+    }
+    prefetch_running = true;
+    prefetch_reader = std::thread( [this, jobs]() {
+        for( const read_job &job : jobs ) {
+            std::string data;
+            try {
+                std::lock_guard<std::mutex> lock( regions_mutex );
+                data = job.region->read( region_local( job.om_addr ) );
+            } catch( const std::exception & ) {
+                // Loading the quad normally reports the error
+                data.clear();
+            }
+            std::lock_guard<std::mutex> lock( prefetch_mutex );
+            if( data.empty() ) {
+                unsaved_quads.insert( job.om_addr );
             } else {
-                sm->load( jsin, submap_member_name, version );
+                prefetched_quads[job.om_addr] = std::move( data );
             }
         }
+        prefetch_running = false;
+    } );
+}
 
-        if( !add_submap( submap_coordinates, sm ) ) {
-            debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
-                      submap_coordinates.z );
+int mapbuffer::load_prefetched( const int max_quads )
+{
+    int loaded = 0;
+    while( loaded < max_quads ) {
+        tripoint om_addr;
+        std::string data;
+        {
+            std::lock_guard<std::mutex> lock( prefetch_mutex );
+            if( prefetched_quads.empty() ) {
+                break;
+            }
+            om_addr = prefetched_quads.begin()->first;
+            data = std::move( prefetched_quads.begin()->second );
+            prefetched_quads.erase( prefetched_quads.begin() );
+        }
+        if( submaps.count( omt_to_sm_copy( om_addr ) ) != 0 ) {
+            // Loaded some other way in the meantime
+            continue;
+        }
+        try {
+            for( std::pair<tripoint, std::unique_ptr<submap>> &entry : parse_quad( data ) ) {
+                if( !add_submap( entry.first, entry.second ) ) {
+                    debugmsg( "submap %d,%d,%d was already loaded", entry.first.x, entry.first.y,
+                              entry.first.z );
+                }
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to load submap quad %s: %s", om_addr.to_string(), err.what() );
+        }
+        loaded++;
+    }
+    return loaded;
+}
+
+std::vector<tripoint> mapbuffer::take_unsaved_prefetched( const int max_quads )
+{
+    std::vector<tripoint> ret;
+    std::lock_guard<std::mutex> lock( prefetch_mutex );
+    while( static_cast<int>( ret.size() ) < max_quads && !unsaved_quads.empty() ) {
+        ret.push_back( *unsaved_quads.begin() );
+        unsaved_quads.erase( unsaved_quads.begin() );
+    }
+    return ret;
+}
+
+int mapbuffer::convert_saved_quads()
+{
+    // Whatever is in memory is written in the new format by this
+    save();
+
+    int converted = 0;
+    std::map<tripoint, region_writes> writes;
+    const auto convert = [&]( const quad_contents & quad ) {
+        if( quad.empty() ) {
+            return;
+        }
+        std::vector<std::pair<tripoint, const submap *>> to_write;
+        for( const std::pair<tripoint, std::unique_ptr<submap>> &entry : quad ) {
+            to_write.emplace_back( entry.first, entry.second.get() );
+        }
+        const tripoint om_addr = sm_to_omt_copy( quad.front().first );
+        writes[omt_to_seg_copy( om_addr )].emplace_back( region_local( om_addr ),
+                serialize_quad( to_write ) );
+        converted++;
+    };
+
+    const std::string maps_dir = g->get_world_base_save_path() + "/maps";
+    for( const std::string &path : get_files_from_path( ".region", maps_dir, false, true ) ) {
+        try {
+            const map_region region( path );
+            for( const point &local : region.quads() ) {
+                convert( parse_quad( region.read( local ) ) );
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to convert %s: %s", path, err.what() );
+        }
+    }
+    // Quads of the old one file per quad layout are moved into regions
+    for( const std::string &path : get_files_from_path( ".map", maps_dir, true, true ) ) {
+        quad_contents quad;
+        if( read_legacy_quad( path, quad ) ) {
+            convert( quad );
         }
     }
+    write_regions( prepare_writes( writes ) );
+    return converted;
 }
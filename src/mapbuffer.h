@@ -2,16 +2,27 @@
 #ifndef CATA_SRC_MAPBUFFER_H
 #define CATA_SRC_MAPBUFFER_H
 
+#include <atomic>
+#include <exception>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
 
 #include "coordinates.h"
 #include "point.h"
 
+class map_region;
 class submap;
-class JsonIn;
 
 /**
  * Store, buffer, save and load the entire world map.
@@ -25,10 +36,18 @@ class mapbuffer
         /** Store all submaps in this instance into savefiles.
          * @param delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
+         * @param in_background If true, the submaps are serialized right away but
+         * written to disk by a background thread. Later saves, @ref reset and
+         * @ref finish_background_save wait for it.
          **/
-        void save( bool delete_after_save = false );
+        void save( bool delete_after_save = false, bool in_background = false );
+
+        /** Waits for a background save to finish. Reports it with debugmsg if it failed,
+         * the next save then writes all submaps again.
+         */
+        void finish_background_save();
 
-        /** Delete all buffered submaps. **/
+        /** Delete all buffered submaps. Waits for a background save first. **/
         void reset();
 
         /** Add a new submap to the buffer.
@@ -58,6 +77,36 @@ class mapbuffer
             return lookup_submap( p.raw() );
         }
 
+        /**
+         * Saves the buffer, then rewrites every saved quad of the world in the format
+         * selected by the MAP_SAVE_FORMAT option, moving quads saved one per file into
+         * region files.
+         * @return Number of quads converted.
+         */
+        int convert_saved_quads();
+
+        /**
+         * Starts reading the saved data of the given quads (in absolute overmap terrain
+         * coordinates) from their region files on a background thread, so loading them
+         * later does not have to wait for the disk. Does nothing while the previous
+         * prefetch is still running. Quads that are loaded already or are being saved
+         * are skipped. Quads without saved data in a region, including those in the
+         * old one file per quad format, are listed by @ref take_unsaved_prefetched.
+         */
+        void prefetch( const std::vector<tripoint> &om_addrs );
+        /**
+         * Loads up to @p max_quads of the quads read by @ref prefetch into the buffer,
+         * so shifting the map onto them only has to look them up.
+         * @return Number of quads loaded.
+         */
+        int load_prefetched( int max_quads );
+        /**
+         * Takes up to @p max_quads of the quads for which @ref prefetch found no
+         * saved data. Unless they were saved in the old format or have been saved
+         * since, they have never been generated.
+         */
+        std::vector<tripoint> take_unsaved_prefetched( int max_quads );
+
     private:
         using submap_map_t = std::map<tripoint, submap *>;
 
@@ -74,15 +123,50 @@ class mapbuffer
         }
 
     private:
+        // Serialized quads to write to one region, by position within it
+        using region_writes = std::vector<std::pair<point, std::string>>;
+        struct pending_region {
+            map_region *region;
+            // Directory of the layout before regions, holding files the region replaces
+            std::string legacy_dir;
+            tripoint segment_addr;
+            region_writes quads;
+        };
+
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
-        void deserialize( JsonIn &jsin );
-        void save_quad( const std::string &dirname, const std::string &filename,
-                        const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+        /** Takes the data @ref prefetch read for the quad, empty if there is none. */
+        std::string take_prefetched( const tripoint &om_addr );
+        /** Waits for the prefetch thread and forgets what it read or did not find. */
+        void discard_prefetched();
+        void save_quad( region_writes &region, const tripoint &om_addr,
+                        std::list<tripoint> &submaps_to_delete, bool delete_after_save );
+        /** Region of a map segment, loaded on first use. */
+        map_region &get_region( const tripoint &segment_addr );
+        // Resolves everything write_regions needs from the main thread
+        std::vector<pending_region> prepare_writes( std::map<tripoint, region_writes> &writes );
+        void write_regions( const std::vector<pending_region> &pending );
         submap_map_t submaps;
+        std::map<tripoint, std::unique_ptr<map_region>> regions;
+        // Guards the regions while a background save writes them
+        std::mutex regions_mutex;
+        std::thread background_writer;
+        std::exception_ptr background_error;
+        // What the background save is writing, for loading quads it has not written yet
+        std::vector<pending_region> in_flight;
+        // Hash of the data last saved for each quad, by overmap terrain position
+        std::map<tripoint, size_t> saved_quad_hashes;
+        std::thread prefetch_reader;
+        std::atomic<bool> prefetch_running{ false };
+        // Guards prefetched_quads, which the prefetch thread fills
+        std::mutex prefetch_mutex;
+        // Saved data of quads that are not loaded, by overmap terrain position.
+        // Only valid until the next save, which might change the quads on disk.
+        std::map<tripoint, std::string> prefetched_quads;
+        // Quads the prefetch thread found nothing saved for
+        std::set<tripoint> unsaved_quads;
 };
 
 extern mapbuffer MAPBUFFER;
@@ -80,6 +80,79 @@ float mongroup::avg_speed() const
     return avg_speed;
 }
 
+mongroup_map::mongroup_map( const mongroup_map &other )
+{
+    *this = other;
+}
+
+mongroup_map &mongroup_map::operator=( const mongroup_map &other )
+{
+    if( this == &other ) {
+        return *this;
+    }
+    // The index of the other map points into its own groups
+    clear();
+    for( const mongroup &group : other.groups ) {
+        insert( group );
+    }
+    return *this;
+}
+
+mongroup &mongroup_map::insert( mongroup group )
+{
+    groups.push_back( std::move( group ) );
+    mongroup &added = groups.back();
+    index[added.pos].push_back( &added );
+    return added;
+}
+
+void mongroup_map::unlink( const mongroup &group )
+{
+    const auto bucket = index.find( group.pos );
+    if( bucket == index.end() ) {
+        debugmsg( "monster group at %s is missing from the index", group.pos.to_string() );
+        return;
+    }
+    std::vector<mongroup *> &here = bucket->second;
+    const auto it = std::find( here.begin(), here.end(), &group );
+    if( it != here.end() ) {
+        *it = here.back();
+        here.pop_back();
+    }
+    if( here.empty() ) {
+        index.erase( bucket );
+    }
+}
+
+mongroup_map::iterator mongroup_map::erase( iterator it )
+{
+    unlink( *it );
+    return groups.erase( it );
+}
+
+void mongroup_map::clear()
+{
+    groups.clear();
+    index.clear();
+}
+
+void mongroup_map::move( mongroup &group, const tripoint_om_sm &p )
+{
+    if( group.pos == p ) {
+        return;
+    }
+    unlink( group );
+    group.pos = p;
+    index[p].push_back( &group );
+}
+
+const std::vector<mongroup *> &mongroup_map::at( const tripoint_om_sm &p ) const
+{
+    static const std::vector<mongroup *> none;
+    const auto it = index.find( p );
+    return it == index.end() ? none : it->second;
+}
+
 const MonsterGroup &MonsterGroupManager::GetUpgradedMonsterGroup( const mongroup_id &group )
 {
     const MonsterGroup *groupptr = &group.obj();
@@ -2,9 +2,12 @@
 #ifndef CATA_SRC_MONGROUP_H
 #define CATA_SRC_MONGROUP_H
 
+#include <cstddef>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "calendar.h"
@@ -157,6 +160,59 @@ struct mongroup {
     void serialize( JsonOut &json ) const;
 };
 
+/**
+ * The monster groups of an overmap, indexed by their position.
+ * Groups live in stable nodes and the index only refers to them, so moving a
+ * group (and the monsters of a horde with it) just updates the index.
+ * The position of a stored group must only be changed through @ref move.
+ */
+class mongroup_map
+{
+    public:
+        using iterator = std::list<mongroup>::iterator;
+        using const_iterator = std::list<mongroup>::const_iterator;
+
+        mongroup_map() = default;
+        mongroup_map( const mongroup_map &other );
+        mongroup_map( mongroup_map && ) = default;
+        mongroup_map &operator=( const mongroup_map &other );
+        mongroup_map &operator=( mongroup_map && ) = default;
+
+        iterator begin() {
+            return groups.begin();
+        }
+        iterator end() {
+            return groups.end();
+        }
+        const_iterator begin() const {
+            return groups.begin();
+        }
+        const_iterator end() const {
+            return groups.end();
+        }
+        size_t size() const {
+            return groups.size();
+        }
+        bool empty() const {
+            return groups.empty();
+        }
+
+        mongroup &insert( mongroup group );
+        /** Removes a group, returns the iterator following it. */
+        iterator erase( iterator it );
+        void clear();
+        /** Changes the position of a stored group without copying it. */
+        void move( mongroup &group, const tripoint_om_sm &p );
+        /** The groups at @p p, in no particular order. */
+        const std::vector<mongroup *> &at( const tripoint_om_sm &p ) const;
+
+    private:
+        void unlink( const mongroup &group );
+
+        std::list<mongroup> groups;
+        std::unordered_map<tripoint_om_sm, std::vector<mongroup *>> index;
+};
+
 class MonsterGroupManager
 {
     public:
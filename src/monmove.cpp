@@ -815,7 +815,9 @@ void monster::move()
             if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
                 ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
                 // We need a new path
-                path = g->m.route( pos(), goal, pf_settings, get_path_avoid() );
+                const std::set<tripoint> path_avoid = get_path_avoid();
+                path = path_avoid.empty() ? g->m.crowd_route( pos(), goal, pf_settings ) :
+                       g->m.route( pos(), goal, pf_settings, path_avoid );
             }
 
             // Try to respect old paths, even if we can't pathfind at the moment
@@ -24,13 +24,13 @@
 #include "cursesdef.h"
 #include "enums.h"
 #include "faction.h"
+#include "fixed_cache.h"
 #include "game_constants.h"
 #include "int_id.h"
 #include "inventory.h"
 #include "item.h"
 #include "item_location.h"
 #include "line.h"
-#include "lru_cache.h"
 #include "optional.h"
 #include "pimpl.h"
 #include "player.h"
@@ -559,8 +559,9 @@ struct npc_short_term_cache {
     std::vector<weak_ptr_fast<Creature>> friends;
     std::vector<sphere> dangerous_explosives;
     std::map<direction, float> threat_map;
-    // Cache of locations the NPC has searched recently in npc::find_item()
-    lru_cache<tripoint, int> searched_tiles;
+    // Cache of locations the NPC has searched recently in npc::find_item(),
+    // keyed on the packed absolute position
+    fixed_cache<int> searched_tiles{ 10 };
 };
 
 // DO NOT USE! This is old, use strings as talk topic instead, e.g. "TALK_AGREE_FOLLOW" instead of
@@ -4,6 +4,7 @@
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iterator>
 #include <memory>
@@ -51,6 +52,7 @@
 #include "overmap.h"
 #include "overmap_location.h"
 #include "overmapbuffer.h"
+#include "pathfinding.h"
 #include "player_activity.h"
 #include "pldata.h"
 #include "projectile.h"
@@ -2886,7 +2888,11 @@ void npc::find_item()
         }
 
         const tripoint abs_p = global_square_location() - pos() + p;
-        const int prev_num_items = ai_cache.searched_tiles.get( abs_p, -1 );
+        // 28 bits are plenty for any absolute position in the world
+        const std::uint64_t abs_key = ( static_cast<std::uint64_t>( abs_p.x ) & 0xFFFFFFF ) << 36 |
+                                      ( static_cast<std::uint64_t>( abs_p.y ) & 0xFFFFFFF ) << 8 |
+                                      static_cast<std::uint8_t>( abs_p.z );
+        const int prev_num_items = ai_cache.searched_tiles.get( abs_key, -1 );
         // Prefetch the number of items present so we can bail out if we already checked here.
         const map_stack m_stack = here.i_at( p );
         int num_items = m_stack.size();
@@ -2901,9 +2907,9 @@ void npc::find_item()
         if( prev_num_items == num_items ) {
             continue;
         }
-        auto cache_tile = [this, &abs_p, num_items, &wanted]() {
+        auto cache_tile = [this, abs_key, num_items, &wanted]() {
             if( wanted == nullptr ) {
-                ai_cache.searched_tiles.insert( 1000, abs_p, num_items );
+                ai_cache.searched_tiles.insert( abs_key, num_items );
             }
         };
         bool can_see = false;
@@ -4255,7 +4261,10 @@ void npc::go_to_omt_destination()
             }
         }
     }
-    path = here.route( pos(), centre_sub, get_pathfinding_settings(), get_path_avoid() );
+    // The center of the next overmap tile can be far away
+    pathfinding_settings travel_settings = get_pathfinding_settings();
+    travel_settings.guide_by_portals = true;
+    path = here.route( pos(), centre_sub, travel_settings, get_path_avoid() );
     add_msg( m_debug, "%s going %s->%s", name, omt_pos.to_string(), goal.to_string() );
 
     if( !path.empty() ) {
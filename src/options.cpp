@@ -1357,6 +1357,17 @@ void options_manager::add_options_general()
 
     get_option( "AUTOSAVE_MINUTES" ).setPrerequisite( "AUTOSAVE" );
 
+    add( "AUTOSAVE_BACKGROUND", "general", translate_marker( "Write saved maps in background" ),
+         translate_marker( "If true, autosaves and quicksaves write the map files on a background thread while the game continues.  Saving on quit always waits for all writes to finish." ),
+         false
+       );
+
+    add( "MAP_SAVE_FORMAT", "general", translate_marker( "Map save format" ),
+         translate_marker( "Format of newly saved map files.  JSON: Human-readable text.  Binary: Smaller and faster to save and load.  Compressed binary: Smallest on disk.  Files in any format can always be loaded." ),
+    { { "json", translate_marker( "JSON" ) }, { "binary", translate_marker( "Binary" ) }, { "binary_compressed", translate_marker( "Compressed binary" ) } },
+    "json"
+       );
+
     add_empty_line();
 
     add( "AUTO_NOTES", "general", translate_marker( "Auto notes" ),
@@ -1906,6 +1917,11 @@ void options_manager::add_options_graphics()
     }, "color_pixel_sepia", COPT_CURSES_HIDE
        );
 
+    add( "CACHE_MAP_LAYER", "graphics", translate_marker( "Cache map layer" ),
+         translate_marker( "If true, terrain, furniture and graffiti are kept between frames and only redrawn where they change.  Not used in isometric mode or with tilesets whose sprites are larger than their tiles." ),
+         false, COPT_CURSES_HIDE
+       );
+
     add_empty_line();
 
     add( "PIXEL_MINIMAP", "graphics", translate_marker( "Pixel minimap" ),
@@ -2159,6 +2175,31 @@ void options_manager::add_options_debug()
 
     get_option( "FOV_3D_Z_RANGE" ).setPrerequisite( "FOV_3D" );
 
+    add( "PARALLEL_MAP_CACHE", "debug", translate_marker( "Parallel map cache building" ),
+         translate_marker( "If true, the lighting and transparency caches of different z-levels are built on several threads.  Only helps when z-levels are enabled." ),
+         false
+       );
+
+    add( "PARALLEL_FIELDS", "debug", translate_marker( "Parallel field processing" ),
+         translate_marker( "If true, where gas fields spread is decided for several submaps at once on different threads.  The fields still change one submap after another, so the result only depends on the world seed, but it differs from the normal mode." ),
+         false
+       );
+
+    add( "PERCEPTION_PASS", "debug", translate_marker( "Shared perception pass" ),
+         translate_marker( "If true, what can see each NPC is worked out once per turn, and monsters look it up instead of checking the line to the NPC each time.  Lines passing close to a corner are still checked one by one." ),
+         false
+       );
+
+    add( "PREGENERATE_OVERMAPS", "debug", translate_marker( "Pregenerate overmaps" ),
+         translate_marker( "If true, the overmaps next to the one you are in are generated together as soon as you enter it, partly on several threads, instead of one at a time when they are first needed.  Their layout then depends only on the world seed and their position, so it differs from the layout they would get without this option." ),
+         false
+       );
+
+    add( "PREFETCH_SUBMAPS", "debug", translate_marker( "Prefetch submaps" ),
+         translate_marker( "If true, the saved parts of the map you are heading towards are read from disk in the background before you get there, and parts that were never generated are generated a little at a time." ),
+         false
+       );
+
     add( "ENABLE_EVENTS", "debug", translate_marker( "Event bus system" ),
          translate_marker( "If false, achievements and some Magiclysm functionality won't work, but performance will be better." ),
          true
@@ -3289,6 +3330,9 @@ void options_manager::cache_to_globals()
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    parallel_map_cache = ::get_option<bool>( "PARALLEL_MAP_CACHE" );
+    parallel_fields = ::get_option<bool>( "PARALLEL_FIELDS" );
+    perception_pass = ::get_option<bool>( "PERCEPTION_PASS" );
     PICKUP_RANGE = ::get_option<int>( "PICKUP_RANGE" );
 #if defined(SDL_SOUND)
     sounds::sound_enabled = ::get_option<bool>( "SOUND_ENABLED" );
@@ -24,6 +24,7 @@
 #include "fstream_utils.h"
 #include "game.h"
 #include "generic_factory.h"
+#include "hash_utils.h"
 #include "json.h"
 #include "line.h"
 #include "map.h"
@@ -1121,9 +1122,15 @@ void overmap::populate( overmap_special_batch &enabled_specials )
 }
 
 void overmap::populate()
+{
+    overmap_special_batch enabled_specials = default_specials();
+    populate( enabled_specials );
+}
+
+overmap_special_batch overmap::default_specials() const
 {
     overmap_special_batch enabled_specials = overmap_specials::get_default_batch( loc );
-    overmap_feature_flag_settings &overmap_feature_flag = settings->overmap_feature_flag;
+    const overmap_feature_flag_settings &overmap_feature_flag = settings->overmap_feature_flag;
 
     const bool should_blacklist = !overmap_feature_flag.blacklist.empty();
     const bool should_whitelist = !overmap_feature_flag.whitelist.empty();
@@ -1165,7 +1172,7 @@ void overmap::populate()
         }
     }
 
-    populate( enabled_specials );
+    return enabled_specials;
 }
 
 oter_id overmap::get_default_terrain( int z ) const
@@ -1252,19 +1259,19 @@ bool overmap::is_explored( const tripoint_om_omt &p ) const
 
 bool overmap::mongroup_check( const mongroup &candidate ) const
 {
-    const auto matching_range = zg.equal_range( candidate.pos );
-    return std::find_if( matching_range.first, matching_range.second,
-    [candidate]( const std::pair<tripoint_om_sm, mongroup> &match ) {
+    const std::vector<mongroup *> &matching = zg.at( candidate.pos );
+    return std::find_if( matching.begin(), matching.end(),
+    [&candidate]( const mongroup * match ) {
         // This is extra strict since we're using it to test serialization.
-        return candidate.type == match.second.type && candidate.pos == match.second.pos &&
-               candidate.radius == match.second.radius &&
-               candidate.population == match.second.population &&
-               candidate.target == match.second.target &&
-               candidate.interest == match.second.interest &&
-               candidate.dying == match.second.dying &&
-               candidate.horde == match.second.horde &&
-               candidate.diffuse == match.second.diffuse;
-    } ) != matching_range.second;
+        return candidate.type == match->type && candidate.pos == match->pos &&
+               candidate.radius == match->radius &&
+               candidate.population == match->population &&
+               candidate.target == match->target &&
+               candidate.interest == match->interest &&
+               candidate.dying == match->dying &&
+               candidate.horde == match->horde &&
+               candidate.diffuse == match->diffuse;
+    } ) != matching.end();
 }
 
 bool overmap::monster_check( const std::pair<tripoint_om_sm, monster> &candidate ) const
@@ -1584,13 +1591,25 @@ void overmap::generate( const overmap *north, const overmap *east,
     }
 
     dbg( DL::Info ) << "overmap::generate start";
+    generate_terrain( north, east, south, west );
+    generate_settlements( north, east, south, west );
+    generate_features( enabled_specials );
+    dbg( DL::Info ) << "overmap::generate done";
+}
 
-    clear_labs();
+size_t overmap::generation_seed( const int phase ) const
+{
+    size_t seed = g->get_seed();
+    cata::hash_combine( seed, loc.x() );
+    cata::hash_combine( seed, loc.y() );
+    cata::hash_combine( seed, phase );
+    return seed;
+}
 
-    bool needs_endgame = std::any_of( enabled_specials.begin(),
-    enabled_specials.end(), []( const overmap_special_placement & pl ) {
-        return pl.special_details->flags.count( "ENDGAME" );
-    } );
+void overmap::generate_terrain( const overmap *north, const overmap *east,
+                                const overmap *south, const overmap *west )
+{
+    clear_labs();
 
     populate_connections_out_from_neighbors( north, east, south, west );
 
@@ -1598,9 +1617,23 @@ void overmap::generate( const overmap *north, const overmap *east,
     place_lakes();
     place_forests();
     place_swamps();
+}
+
+void overmap::generate_settlements( const overmap *north, const overmap *east,
+                                    const overmap *south, const overmap *west )
+{
     place_cities();
     place_forest_trails();
     place_roads( north, east, south, west );
+}
+
+void overmap::generate_features( overmap_special_batch &enabled_specials )
+{
+    bool needs_endgame = std::any_of( enabled_specials.begin(),
+    enabled_specials.end(), []( const overmap_special_placement & pl ) {
+        return pl.special_details->flags.count( "ENDGAME" );
+    } );
+
     place_specials( enabled_specials );
     place_forest_trailheads();
 
@@ -1624,7 +1657,6 @@ void overmap::generate( const overmap *north, const overmap *east,
     // Place the monsters, now that the terrain is laid out
     place_mongroups();
     place_radios();
-    dbg( DL::Info ) << "overmap::generate done";
 }
 
 bool overmap::generate_sub( const int z )
@@ -1960,13 +1992,13 @@ const
 void overmap::process_mongroups()
 {
     for( auto it = zg.begin(); it != zg.end(); ) {
-        mongroup &mg = it->second;
+        mongroup &mg = *it;
         if( mg.dying ) {
             mg.population = ( mg.population * 4 ) / 5;
             mg.radius = ( mg.radius * 9 ) / 10;
         }
         if( mg.empty() ) {
-            zg.erase( it++ );
+            it = zg.erase( it );
         } else {
             ++it;
         }
@@ -2036,13 +2068,11 @@ void mongroup::wander( const overmap &om )
 
 void overmap::move_hordes()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype( zg ) tmpzg;
+    // Moving a group only updates the position index, so every group is
+    // visited exactly once and none of them is copied.
     //MOVE ZOMBIE GROUPS
-    for( auto it = zg.begin(); it != zg.end(); ) {
-        mongroup &mg = it->second;
+    for( mongroup &mg : zg ) {
         if( !mg.horde ) {
-            ++it;
             continue;
         }
 
@@ -2078,28 +2108,22 @@ void overmap::move_hordes()
         // or one space per 5 minutes.
         if( one_in( movement_chance ) && rng( 0, 100 ) < mg.interest && rng( 0, 200 ) < mg.avg_speed() ) {
             // TODO: Handle moving to adjacent overmaps.
-            if( mg.pos.x() > mg.target.x() ) {
-                mg.pos.x()--;
+            tripoint_om_sm dest = mg.pos;
+            if( dest.x() > mg.target.x() ) {
+                dest.x()--;
             }
-            if( mg.pos.x() < mg.target.x() ) {
-                mg.pos.x()++;
+            if( dest.x() < mg.target.x() ) {
+                dest.x()++;
             }
-            if( mg.pos.y() > mg.target.y() ) {
-                mg.pos.y()--;
+            if( dest.y() > mg.target.y() ) {
+                dest.y()--;
             }
-            if( mg.pos.y() < mg.target.y() ) {
-                mg.pos.y()++;
+            if( dest.y() < mg.target.y() ) {
+                dest.y()++;
             }
-
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
-            zg.erase( it++ );
-        } else {
-            ++it;
+            zg.move( mg, dest );
         }
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
 
     if( get_option<bool>( "WANDER_SPAWNS" ) ) {
 
@@ -2133,19 +2157,15 @@ void overmap::move_hordes()
 
             // Scan for compatible hordes in this area, selecting the largest.
             mongroup *add_to_group = nullptr;
-            auto group_bucket = zg.equal_range( p );
             std::vector<monster>::size_type add_to_horde_size = 0;
-            std::for_each( group_bucket.first, group_bucket.second,
-            [&]( std::pair<const tripoint_om_sm, mongroup> &horde_entry ) {
-                mongroup &horde = horde_entry.second;
-
+            for( mongroup *horde : zg.at( p ) ) {
                 // We only absorb zombies into GROUP_ZOMBIE hordes
-                if( horde.horde && !horde.monsters.empty() && horde.type == GROUP_ZOMBIE &&
-                    horde.monsters.size() > add_to_horde_size ) {
-                    add_to_group = &horde;
-                    add_to_horde_size = horde.monsters.size();
+                if( horde->horde && !horde->monsters.empty() && horde->type == GROUP_ZOMBIE &&
+                    horde->monsters.size() > add_to_horde_size ) {
+                    add_to_group = horde;
+                    add_to_horde_size = horde->monsters.size();
                 }
-            } );
+            }
 
             // Check again if the zombie will join the largest horde, now that we know the accurate size.
             if( this_monster.will_join_horde( add_to_horde_size ) ) {
@@ -2178,8 +2198,7 @@ void overmap::move_hordes()
 void overmap::signal_hordes( const tripoint_rel_sm &p_rel, const int sig_power )
 {
     tripoint_om_sm p( p_rel.raw() );
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    for( mongroup &mg : zg ) {
         if( !mg.horde ) {
             continue;
         }
@@ -4649,7 +4668,7 @@ void overmap::add_mon_group( const mongroup &group )
     // makes the diffuse setting obsolete (as it only controls how the radius
     // is interpreted) - it's only used when adding monster groups with function.
     if( group.radius == 1 ) {
-        zg.insert( std::pair<tripoint_om_sm, mongroup>( group.pos, group ) );
+        zg.insert( group );
         return;
     }
     // diffuse groups use a circular area, non-diffuse groups use a rectangular area
@@ -343,7 +343,7 @@ class overmap
         void place_special_forced( const overmap_special_id &special_id, const tripoint_om_omt &p,
                                    om_direction::type dir );
     private:
-        std::multimap<tripoint_om_sm, mongroup> zg;
+        mongroup_map zg;
     public:
         /** Unit test enablers to check if a given mongroup is present. */
         bool mongroup_check( const mongroup &candidate ) const;
@@ -407,6 +407,8 @@ class overmap
         void init_layers();
         // open existing overmap, or generate a new one
         void open( overmap_special_batch &enabled_specials );
+        // The default specials, filtered by the feature flags of the region settings
+        overmap_special_batch default_specials() const;
     public:
 
         /**
@@ -429,6 +431,31 @@ class overmap
         void generate( const overmap *north, const overmap *east,
                        const overmap *south, const overmap *west,
                        overmap_special_batch &enabled_specials );
+        /**
+         * First part of @ref generate: rivers, lakes, forests and swamps.
+         * Only reads the given neighbors and only writes to this overmap, so different
+         * overmaps can be laid out on different threads.
+         */
+        void generate_terrain( const overmap *north, const overmap *east,
+                               const overmap *south, const overmap *west );
+        /**
+         * Second part of @ref generate: cities, forest trails and roads. Looks up
+         * buildings, specials and connections from the global tables, which caches
+         * into their ids, so this has to run on the main thread.
+         */
+        void generate_settlements( const overmap *north, const overmap *east,
+                                   const overmap *south, const overmap *west );
+        /**
+         * Rest of @ref generate: specials, underground levels, monster groups and radios.
+         * Might create other overmaps, so this has to run on the main thread.
+         */
+        void generate_features( overmap_special_batch &enabled_specials );
+        /**
+         * Seed for one part of generating this overmap when it is pregenerated, from the
+         * world seed and the position, so the result does not depend on when or on which
+         * thread it is generated.
+         */
+        size_t generation_seed( int phase ) const;
         bool generate_sub( int z );
 
         const city &get_nearest_city( const tripoint_om_omt &p ) const;
@@ -6,6 +6,7 @@
 #include <iterator>
 #include <list>
 #include <map>
+#include <thread>
 
 #include "avatar.h"
 #include "basecamp.h"
@@ -39,6 +40,7 @@
 #include "string_utils.h"
 #include "translations.h"
 #include "vehicle.h"
+#include "worker_pool.h"
 
 class map_extra;
 
@@ -100,6 +102,71 @@ overmap &overmapbuffer::get( const point_abs_om &p )
     return new_om;
 }
 
+static worker_pool &overmap_generation_workers()
+{
+    // The calling thread takes part too, up to 4 overmaps of a pass are adjacent to one
+    static worker_pool pool( std::min<int>( 4,
+                                            std::max<int>( 1, std::thread::hardware_concurrency() ) ) - 1 );
+    return pool;
+}
+
+void overmapbuffer::generate_around( const point_abs_om &center, const int radius )
+{
+    if( g->gametype() == SGAME_DEFENSE ) {
+        // overmap::generate leaves them empty, nothing to gain
+        return;
+    }
+    for( int parity = 0; parity < 2; ++parity ) {
+        // Checked again for each pass, generating the specials of an overmap can
+        // create another one.
+        std::vector<point_abs_om> batch;
+        for( const point_abs_om &p : closest_points_first( center, radius ) ) {
+            if( ( ( p.x() + p.y() ) & 1 ) == parity && !has( p ) ) {
+                batch.push_back( p );
+            }
+        }
+        if( batch.empty() ) {
+            continue;
+        }
+        std::vector<std::unique_ptr<overmap>> generated;
+        // north, east, south, west, all of them from an earlier pass or already existing
+        std::vector<std::array<const overmap *, 4>> neighbors;
+        for( const point_abs_om &p : batch ) {
+            generated.push_back( std::make_unique<overmap>( p ) );
+            neighbors.push_back( {{
+                    get_existing( p + point_north ), get_existing( p + point_east ),
+                    get_existing( p + point_south ), get_existing( p + point_west )
+                }
+            } );
+        }
+        // Each part is seeded on its own, so the order the workers pick the
+        // overmaps up in does not matter.
+        overmap_generation_workers().run( batch.size(), [&]( int i ) {
+            const std::array<const overmap *, 4> &n = neighbors[i];
+            const scoped_rng_seed seed( generated[i]->generation_seed( 0 ) );
+            generated[i]->generate_terrain( n[0], n[1], n[2], n[3] );
+        } );
+        for( size_t i = 0; i < batch.size(); ++i ) {
+            const std::array<const overmap *, 4> &n = neighbors[i];
+            const scoped_rng_seed seed( generated[i]->generation_seed( 1 ) );
+            generated[i]->generate_settlements( n[0], n[1], n[2], n[3] );
+        }
+        // All of them are added first, so placing the specials of one does not
+        // create another one of the batch in the meantime.
+        for( size_t i = 0; i < batch.size(); ++i ) {
+            overmaps[batch[i]] = std::move( generated[i] );
+        }
+        for( const point_abs_om &p : batch ) {
+            overmap &new_om = *overmaps[p];
+            overmap_special_batch enabled_specials = new_om.default_specials();
+            const scoped_rng_seed seed( new_om.generation_seed( 2 ) );
+            new_om.generate_features( enabled_specials );
+            fix_mongroups( new_om );
+            fix_npcs( new_om );
+        }
+    }
+}
+
 void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_special_batch &specials )
 {
     if( last_requested_overmap != nullptr ) {
@@ -115,11 +182,11 @@ void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_specia
 void overmapbuffer::fix_mongroups( overmap &new_overmap )
 {
     for( auto it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
-        auto &mg = it->second;
+        auto &mg = *it;
         // spawn related code simply sets population to 0 when they have been
         // transformed into spawn points on a submap, the group can then be removed
         if( mg.empty() ) {
-            new_overmap.zg.erase( it++ );
+            it = new_overmap.zg.erase( it );
             continue;
         }
         // Inside the bounds of the overmap?
@@ -139,9 +206,10 @@ void overmapbuffer::fix_mongroups( overmap &new_overmap )
             continue;
         }
         overmap &om = get( omp );
-        mg.pos = tripoint_om_sm( sm_rem, mg.pos.z() );
-        om.add_mon_group( mg );
-        new_overmap.zg.erase( it++ );
+        mongroup moved = std::move( mg );
+        moved.pos = tripoint_om_sm( sm_rem, moved.pos.z() );
+        it = new_overmap.zg.erase( it );
+        om.add_mon_group( moved );
     }
 }
 
@@ -525,13 +593,11 @@ std::vector<mongroup *> overmapbuffer::groups_at( const tripoint_abs_sm &p )
         return result;
     }
     overmap &om = get( omp );
-    auto groups_range = om.zg.equal_range( tripoint_om_sm( sm_within_om, p.z() ) );
-    for( auto it = groups_range.first; it != groups_range.second; ++it ) {
-        mongroup &mg = it->second;
-        if( mg.empty() ) {
+    for( mongroup *mg : om.zg.at( tripoint_om_sm( sm_within_om, p.z() ) ) ) {
+        if( mg->empty() ) {
             continue;
         }
-        result.push_back( &mg );
+        result.push_back( mg );
     }
     return result;
 }
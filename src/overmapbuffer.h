@@ -158,6 +158,15 @@ class overmapbuffer
         void save();
         void clear();
         void create_custom_overmap( const point_abs_om &, overmap_special_batch &specials );
+        /**
+         * Generates the overmaps within @p radius of @p center that do not exist yet.
+         * Their terrain is laid out on several threads, the rest is generated on the
+         * calling thread. Overmaps are generated in two passes, with no two neighbors in
+         * the same pass, so the result does not depend on how the work was scheduled.
+         * Unlike overmaps generated when first needed, each one is seeded from the world
+         * seed and its position, and the random sequence of the caller is left alone.
+         */
+        void generate_around( const point_abs_om &center, int radius = 1 );
 
         /**
          * Uses global overmap terrain coordinates, creates the
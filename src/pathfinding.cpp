@@ -1,14 +1,18 @@
 #include "pathfinding.h"
 
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include <array>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
@@ -17,6 +21,7 @@
 #include "optional.h"
 #include "submap.h"
 #include "trap.h"
+#include "turn_profiler.h"
 #include "veh_type.h"
 #include "vehicle.h"
 #include "vpart_position.h"
@@ -24,94 +29,174 @@
 #include "type_id.h"
 #include "point.h"
 
-enum astar_state {
+enum astar_state : uint8_t {
     ASL_NONE,
     ASL_OPEN,
     ASL_CLOSED
 };
 
+static constexpr int layer_size = MAPSIZE_X * MAPSIZE_Y;
+
 // Turns two indexed to a 2D array into an index to equivalent 1D array
 constexpr int flat_index( const tripoint &p )
 {
     return ( p.x * MAPSIZE_Y ) + p.y;
 }
 
-// Flattened 2D array representing a single z-level worth of pathfinding data
+// Index of a point among all z-levels, used to store parents compactly
+constexpr int packed_index( const tripoint &p )
+{
+    return ( p.z + OVERMAP_DEPTH ) * layer_size + flat_index( p );
+}
+
+static tripoint unpack_index( const int packed )
+{
+    const int flat = packed % layer_size;
+    return tripoint( flat / MAPSIZE_Y, flat % MAPSIZE_Y, packed / layer_size - OVERMAP_DEPTH );
+}
+
+// Flattened 2D array representing a single z-level worth of pathfinding data.
+// Layers outlive a single search: instead of clearing them, each search gets a
+// new generation and cells stamped with an older one read as unvisited.
 struct path_data_layer {
+    uint32_t current_generation = 0;
+
     // State is accessed way more often than all other values here
-    std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > state;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
-    std::array< tripoint, MAPSIZE_X *MAPSIZE_Y > parent;
-
-    void init( const point &min, const point &max ) {
-        tripoint p;
-        for( p.x = min.x; p.x <= max.x; p.x++ ) {
-            for( p.y = min.y; p.y <= max.y; p.y++ ) {
-                const int ind = flat_index( p );
-                state[ind] = ASL_NONE; // Mark as unvisited
-            }
+    std::array< uint32_t, layer_size > generation;
+    std::array< astar_state, layer_size > state_;
+    std::array< int, layer_size > score_;
+    std::array< int, layer_size > gscore_;
+    std::array< int, layer_size > parent_;
+
+    bool fresh( const int index ) const {
+        return generation[index] == current_generation;
+    }
+
+    // Claims a cell for the current search, resetting it to unvisited
+    void touch( const int index ) {
+        if( !fresh( index ) ) {
+            generation[index] = current_generation;
+            state_[index] = ASL_NONE;
+            score_[index] = 0;
+            gscore_[index] = 0;
+            parent_[index] = packed_index( tripoint_zero );
         }
     }
-};
 
-struct pathfinder {
-    point min;
-    point max;
-    pathfinder( const point &_min, const point &_max ) :
-        min( _min ), max( _max ) {
+    astar_state state( const int index ) const {
+        return fresh( index ) ? state_[index] : ASL_NONE;
+    }
+    int score( const int index ) const {
+        return fresh( index ) ? score_[index] : 0;
     }
+    int gscore( const int index ) const {
+        return fresh( index ) ? gscore_[index] : 0;
+    }
+    tripoint parent( const int index ) const {
+        return fresh( index ) ? unpack_index( parent_[index] ) : tripoint_zero;
+    }
+
+    void set_state( const int index, const astar_state s ) {
+        touch( index );
+        state_[index] = s;
+    }
+
+    void open( const int index, const int gscore, const int score, const tripoint &from ) {
+        touch( index );
+        state_[index] = ASL_OPEN;
+        gscore_[index] = gscore;
+        parent_[index] = packed_index( from );
+        score_[index] = score;
+    }
+};
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
-    open;
+using open_entry = std::pair<int, tripoint>;
+
+// Scratch memory reused by all searches of a thread, so that a search neither
+// allocates layers nor clears them.
+struct pathfinder_workspace {
+    uint32_t generation = 0;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+    // Binary heap ordered by pair_greater_cmp_first, keeps its capacity between searches
+    std::vector< open_entry > open;
+
+    void begin_search() {
+        open.clear();
+        generation++;
+        if( generation == 0 ) {
+            // Wrapped around, stale stamps could now look current
+            for( std::unique_ptr< path_data_layer > &layer : path_data ) {
+                if( layer != nullptr ) {
+                    layer->generation.fill( 0 );
+                }
+            }
+            generation = 1;
+        }
+        for( std::unique_ptr< path_data_layer > &layer : path_data ) {
+            if( layer != nullptr ) {
+                layer->current_generation = generation;
+            }
+        }
+    }
 
     path_data_layer &get_layer( const int z ) {
         std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
-            return *ptr;
+        if( ptr == nullptr ) {
+            // Value-initialized, so every stamp is 0 and no cell is current
+            ptr = std::make_unique<path_data_layer>();
+            ptr->current_generation = generation;
         }
-
-        ptr = std::make_unique<path_data_layer>();
-        ptr->init( min, max );
         return *ptr;
     }
 
+    static pathfinder_workspace &get() {
+        static thread_local pathfinder_workspace instance;
+        return instance;
+    }
+};
+
+struct pathfinder {
+    pathfinder_workspace &ws;
+
+    pathfinder() : ws( pathfinder_workspace::get() ) {
+        ws.begin_search();
+    }
+
+    path_data_layer &get_layer( const int z ) {
+        return ws.get_layer( z );
+    }
+
     bool empty() const {
-        return open.empty();
+        return ws.open.empty();
     }
 
     tripoint get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        std::pop_heap( ws.open.begin(), ws.open.end(), pair_greater_cmp_first() );
+        const tripoint pt = ws.open.back().second;
+        ws.open.pop_back();
+        return pt;
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
         auto &layer = get_layer( to.z );
         const int index = flat_index( to );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
+        const astar_state state = layer.state( index );
+        if( ( state == ASL_OPEN && gscore >= layer.gscore( index ) ) ||
+            state == ASL_CLOSED ) {
             return;
         }
 
-        layer.state [index] = ASL_OPEN;
-        layer.gscore[index] = gscore;
-        layer.parent[index] = from;
-        layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
+        layer.open( index, gscore, score, from );
+        ws.open.emplace_back( score, to );
+        std::push_heap( ws.open.begin(), ws.open.end(), pair_greater_cmp_first() );
     }
 
     void close_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p );
-        layer.state[index] = ASL_CLOSED;
+        get_layer( p.z ).set_state( flat_index( p ), ASL_CLOSED );
     }
 
     void unclose_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p );
-        layer.state[index] = ASL_NONE;
+        get_layer( p.z ).set_state( flat_index( p ), ASL_NONE );
     }
 };
 
@@ -191,6 +276,368 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+static constexpr int non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+
+// A straight line on flat ground, or an empty route if any point of it needs
+// special handling (including just hard terrain) or is pre-closed.
+static std::vector<tripoint> clear_line_route( const map &m, const tripoint &f,
+        const tripoint &t, const std::set<tripoint> &pre_closed )
+{
+    std::vector<tripoint> line_path = line_to( f, t );
+    const auto &pf_cache = m.get_pathfinding_cache_ref( f.z );
+    if( std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
+    return !( pf_cache.special[p.x][p.y] & non_normal );
+    } ) ) {
+        const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
+
+        if( is_disjoint( sorted_line, pre_closed ) ) {
+            return line_path;
+        }
+    }
+    return std::vector<tripoint>();
+}
+
+// Portal graph cells are addressed by their flat index on a single z-level.
+static int flat_index( const point &p )
+{
+    return ( p.x * MAPSIZE_Y ) + p.y;
+}
+
+static point unflat_index( const int flat )
+{
+    return point( flat / MAPSIZE_Y, flat % MAPSIZE_Y );
+}
+
+static point cluster_of( const point &p )
+{
+    return point( p.x / SEEX, p.y / SEEY );
+}
+
+static int local_index( const point &p )
+{
+    return ( p.x % SEEX ) * SEEY + p.y % SEEY;
+}
+
+static constexpr int unreachable_cost = INT_MAX;
+
+pathfinding_portal_graph::cluster &pathfinding_portal_graph::cluster_at( const point &c )
+{
+    return clusters[c.x * MAPSIZE + c.y];
+}
+
+const pathfinding_portal_graph::cluster &pathfinding_portal_graph::cluster_at(
+    const point &c ) const
+{
+    return clusters[c.x * MAPSIZE + c.y];
+}
+
+bool pathfinding_portal_graph::walkable_at( const point &p ) const
+{
+    return cluster_at( cluster_of( p ) ).walkable[local_index( p )];
+}
+
+void pathfinding_portal_graph::refresh( const pathfinding_cache &cache, const int map_size )
+{
+    if( cache.generation == last_generation && map_size == size ) {
+        return;
+    }
+    if( map_size != size ) {
+        for( cluster &cl : clusters ) {
+            cl.built = false;
+        }
+        size = std::min( map_size, MAPSIZE );
+    }
+    last_generation = cache.generation;
+
+    std::array<bool, MAPSIZE *MAPSIZE> changed{};
+    for( int cx = 0; cx < size; cx++ ) {
+        for( int cy = 0; cy < size; cy++ ) {
+            cluster &cl = cluster_at( point( cx, cy ) );
+            std::bitset<SEEX *SEEY> walkable;
+            std::bitset<SEEX *SEEY> slow;
+            for( int sx = 0; sx < SEEX; sx++ ) {
+                for( int sy = 0; sy < SEEY; sy++ ) {
+                    const pf_special special = cache.special[cx * SEEX + sx][cy * SEEY + sy];
+                    walkable[sx * SEEY + sy] = !( special & PF_WALL );
+                    slow[sx * SEEY + sy] = special & PF_SLOW;
+                }
+            }
+            if( !cl.built || walkable != cl.walkable || slow != cl.slow ) {
+                cl.walkable = walkable;
+                cl.slow = slow;
+                changed[cx * MAPSIZE + cy] = true;
+            }
+        }
+    }
+
+    // Portals on a border depend on both sides of it, so neighbors of a
+    // changed cluster are rebuilt as well.
+    std::array<bool, MAPSIZE *MAPSIZE> rebuild{};
+    for( int cx = 0; cx < size; cx++ ) {
+        for( int cy = 0; cy < size; cy++ ) {
+            if( !changed[cx * MAPSIZE + cy] ) {
+                continue;
+            }
+            for( const point &d : four_adjacent_offsets ) {
+                const point n = point( cx, cy ) + d;
+                if( n.x >= 0 && n.x < size && n.y >= 0 && n.y < size ) {
+                    rebuild[n.x * MAPSIZE + n.y] = true;
+                }
+            }
+            rebuild[cx * MAPSIZE + cy] = true;
+        }
+    }
+
+    rebuilt_clusters = 0;
+    for( int cx = 0; cx < size; cx++ ) {
+        for( int cy = 0; cy < size; cy++ ) {
+            if( rebuild[cx * MAPSIZE + cy] ) {
+                build_cluster( point( cx, cy ) );
+                rebuilt_clusters++;
+            }
+        }
+    }
+}
+
+void pathfinding_portal_graph::build_cluster( const point &c )
+{
+    cluster &cl = cluster_at( c );
+    cl.portals.clear();
+    cl.edges.clear();
+    cl.built = true;
+
+    const point origin( c.x * SEEX, c.y * SEEY );
+    const auto add_portal = [&cl]( const point & p, const point & partner ) {
+        const int flat = flat_index( p );
+        auto iter = std::find( cl.portals.begin(), cl.portals.end(), flat );
+        if( iter == cl.portals.end() ) {
+            cl.portals.push_back( flat );
+            cl.edges.emplace_back();
+            iter = cl.portals.end() - 1;
+        }
+        cl.edges[iter - cl.portals.begin()].push_back( { flat_index( partner ), 2 } );
+    };
+
+    for( const point &d : four_adjacent_offsets ) {
+        const point n = c + d;
+        if( n.x < 0 || n.x >= size || n.y < 0 || n.y >= size ) {
+            continue;
+        }
+        // Border cells of this cluster facing `d`, walked along the border
+        const point first = origin + point( d.x > 0 ? SEEX - 1 : 0, d.y > 0 ? SEEY - 1 : 0 );
+        const point step = d.x != 0 ? point_south : point_east;
+        const int length = d.x != 0 ? SEEY : SEEX;
+        int run_start = -1;
+        for( int i = 0; i <= length; i++ ) {
+            const point p = first + step * i;
+            const bool open = i < length && walkable_at( p ) && walkable_at( p + d );
+            if( open && run_start < 0 ) {
+                run_start = i;
+            } else if( !open && run_start >= 0 ) {
+                const point mid = first + step * ( ( run_start + i - 1 ) / 2 );
+                add_portal( mid, mid + d );
+                run_start = -1;
+            }
+        }
+    }
+
+    for( size_t i = 0; i < cl.portals.size(); i++ ) {
+        const std::vector<int> costs = cluster_costs( c, unflat_index( cl.portals[i] ) );
+        for( size_t j = 0; j < cl.portals.size(); j++ ) {
+            const int cost = costs[local_index( unflat_index( cl.portals[j] ) )];
+            if( i != j && cost != unreachable_cost ) {
+                cl.edges[i].push_back( { cl.portals[j], cost } );
+            }
+        }
+    }
+}
+
+std::vector<int> pathfinding_portal_graph::cluster_costs( const point &c, const point &from ) const
+{
+    const cluster &cl = cluster_at( c );
+    std::vector<int> costs( SEEX * SEEY, unreachable_cost );
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, pair_greater_cmp_first>
+            open;
+    costs[local_index( from )] = 0;
+    open.emplace( 0, local_index( from ) );
+    while( !open.empty() ) {
+        const std::pair<int, int> cur = open.top();
+        open.pop();
+        if( cur.first > costs[cur.second] ) {
+            continue;
+        }
+        const point cur_p( cur.second / SEEY, cur.second % SEEY );
+        for( const point &d : eight_adjacent_offsets ) {
+            const point p = cur_p + d;
+            if( p.x < 0 || p.x >= SEEX || p.y < 0 || p.y >= SEEY ) {
+                continue;
+            }
+            const int idx = p.x * SEEY + p.y;
+            if( !cl.walkable[idx] ) {
+                continue;
+            }
+            // Same weights as the tile A*: diagonals are penalized, slow tiles cost more
+            const int cost = cur.first + 2 + ( d.x != 0 && d.y != 0 ? 1 : 0 ) + ( cl.slow[idx] ? 2 : 0 );
+            if( cost < costs[idx] ) {
+                costs[idx] = cost;
+                open.emplace( cost, idx );
+            }
+        }
+    }
+    return costs;
+}
+
+const std::vector<pathfinding_portal_graph::portal_edge> *pathfinding_portal_graph::edges_of(
+    const int flat ) const
+{
+    const cluster &cl = cluster_at( cluster_of( unflat_index( flat ) ) );
+    const auto iter = std::find( cl.portals.begin(), cl.portals.end(), flat );
+    if( iter == cl.portals.end() ) {
+        return nullptr;
+    }
+    return &cl.edges[iter - cl.portals.begin()];
+}
+
+int pathfinding_portal_graph::portal_count() const
+{
+    int ret = 0;
+    for( int cx = 0; cx < size; cx++ ) {
+        for( int cy = 0; cy < size; cy++ ) {
+            ret += cluster_at( point( cx, cy ) ).portals.size();
+        }
+    }
+    return ret;
+}
+
+std::vector<point> pathfinding_portal_graph::find_waypoints( const point &from,
+        const point &to ) const
+{
+    std::vector<point> ret;
+    const point from_c = cluster_of( from );
+    const point to_c = cluster_of( to );
+    const auto in_graph = [this]( const point & c ) {
+        return c.x >= 0 && c.x < size && c.y >= 0 && c.y < size;
+    };
+    if( from_c == to_c || !in_graph( from_c ) || !in_graph( to_c ) ||
+        !walkable_at( to ) ) {
+        return ret;
+    }
+
+    // A* over portals. The start connects to the portals of its own cluster
+    // and the portals of the goal cluster connect to the goal.
+    constexpr int start_node = -2;
+    constexpr int goal_node = -1;
+    const std::vector<int> from_costs = cluster_costs( from_c, from );
+    const std::vector<int> to_costs = cluster_costs( to_c, to );
+    std::unordered_map<int, int> gscore;
+    std::unordered_map<int, int> parent;
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, pair_greater_cmp_first>
+            open;
+    const auto heuristic = [&to]( const int node ) {
+        return node == goal_node ? 0 : 2 * square_dist( unflat_index( node ), to );
+    };
+    const auto relax = [&]( const int node, const int prev, const int cost ) {
+        const auto iter = gscore.find( node );
+        if( iter == gscore.end() || cost < iter->second ) {
+            gscore[node] = cost;
+            parent[node] = prev;
+            open.emplace( cost + heuristic( node ), node );
+        }
+    };
+
+    for( const int portal : cluster_at( from_c ).portals ) {
+        const int cost = from_costs[local_index( unflat_index( portal ) )];
+        if( cost != unreachable_cost ) {
+            relax( portal, start_node, cost );
+        }
+    }
+
+    bool found = false;
+    while( !open.empty() ) {
+        const std::pair<int, int> cur = open.top();
+        open.pop();
+        const int node = cur.second;
+        const int g = gscore[node];
+        if( cur.first > g + heuristic( node ) ) {
+            // Stale entry
+            continue;
+        }
+        if( node == goal_node ) {
+            found = true;
+            break;
+        }
+        const point node_p = unflat_index( node );
+        if( cluster_of( node_p ) == to_c ) {
+            const int cost = to_costs[local_index( node_p )];
+            if( cost != unreachable_cost ) {
+                relax( goal_node, node, g + cost );
+            }
+        }
+        const std::vector<portal_edge> *edges = edges_of( node );
+        if( edges == nullptr ) {
+            continue;
+        }
+        for( const portal_edge &e : *edges ) {
+            relax( e.to, node, g + e.cost );
+        }
+    }
+
+    if( !found ) {
+        return ret;
+    }
+    for( int node = parent[goal_node]; node != start_node; node = parent[node] ) {
+        ret.push_back( unflat_index( node ) );
+    }
+    std::reverse( ret.begin(), ret.end() );
+    return ret;
+}
+
+// Routes long same-level paths along the portal graph, one short A* per pair
+// of consecutive waypoints. Returns an empty route when the graph does not
+// know a way or a leg cannot be walked with the given settings, in which case
+// the caller falls back to a single A* search.
+static std::vector<tripoint> route_via_portals( const map &m, const tripoint &f,
+        const tripoint &t, const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed )
+{
+    std::vector<tripoint> ret;
+    const std::vector<point> waypoints = m.get_portal_graph_ref( f.z ).find_waypoints( f.xy(),
+                                         t.xy() );
+    if( waypoints.empty() ) {
+        return ret;
+    }
+
+    pathfinding_settings leg_settings = settings;
+    leg_settings.guide_by_portals = false;
+    tripoint cur = f;
+    const auto walk_to = [&]( const tripoint & next ) {
+        if( next == cur ) {
+            return true;
+        }
+        if( pre_closed.count( next ) != 0 ) {
+            return false;
+        }
+        const std::vector<tripoint> leg = m.route( cur, next, leg_settings, pre_closed );
+        if( leg.empty() ) {
+            return false;
+        }
+        ret.insert( ret.end(), leg.begin(), leg.end() );
+        cur = next;
+        // Every step costs at least 2, same as in the regular search
+        return static_cast<int>( ret.size() ) * 2 <= settings.max_length;
+    };
+
+    for( const point &w : waypoints ) {
+        if( !walk_to( tripoint( w, f.z ) ) ) {
+            return std::vector<tripoint>();
+        }
+    }
+    if( !walk_to( t ) ) {
+        return std::vector<tripoint>();
+    }
+    return ret;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -209,21 +656,12 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         clip_to_bounds( clipped );
         return route( f, clipped, settings, pre_closed );
     }
+    turn_profiler::scoped_timer timer( turn_profiler::phase::route );
     // First, check for a simple straight line on flat ground
-    // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
     if( f.z == t.z ) {
-        const auto line_path = line_to( f, t );
-        const auto &pf_cache = get_pathfinding_cache_ref( f.z );
-        // Check all points for any special case (including just hard terrain)
-        if( std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
-        return !( pf_cache.special[p.x][p.y] & non_normal );
-        } ) ) {
-            const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
-
-            if( is_disjoint( sorted_line, pre_closed ) ) {
-                return line_path;
-            }
+        ret = clear_line_route( *this, f, t, pre_closed );
+        if( !ret.empty() ) {
+            return ret;
         }
     }
 
@@ -232,6 +670,15 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    // Long routes on one level can be guided by the portal graph, otherwise the
+    // padded search box below is too small to find a way around obstacles.
+    if( settings.guide_by_portals && f.z == t.z && rl_dist( f, t ) > 2 * SEEX ) {
+        ret = route_via_portals( *this, f, t, settings, pre_closed );
+        if( !ret.empty() ) {
+            return ret;
+        }
+    }
+
     int max_length = settings.max_length;
     int bash = settings.bash_strength;
     int climb_cost = settings.climb_cost;
@@ -252,7 +699,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( point( minx, miny ), point( maxx, maxy ) );
+    pathfinder pf;
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -273,12 +720,11 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
-        if( cur_state == ASL_CLOSED ) {
+        if( layer.state( parent_index ) == ASL_CLOSED ) {
             continue;
         }
 
-        if( layer.gscore[parent_index] > max_length ) {
+        if( layer.gscore( parent_index ) > max_length ) {
             // Shortest path would be too long, return empty vector
             return std::vector<tripoint>();
         }
@@ -288,7 +734,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             break;
         }
 
-        cur_state = ASL_CLOSED;
+        layer.set_state( parent_index, ASL_CLOSED );
 
         const auto &pf_cache = get_pathfinding_cache_ref( cur.z );
         const auto cur_special = pf_cache.special[cur.x][cur.y];
@@ -307,12 +753,12 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
+            if( layer.state( index ) == ASL_CLOSED ) {
                 continue;
             }
 
             // Penalize for diagonals or the path will look "unnatural"
-            int newg = layer.gscore[parent_index] + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
+            int newg = layer.gscore( parent_index ) + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
 
             const auto p_special = pf_cache.special[p.x][p.y];
             // TODO: De-uglify, de-huge-n
@@ -321,7 +767,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 newg += 2;
             } else {
                 if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
+                    layer.set_state( index, ASL_CLOSED ); // Close all rough terrain tiles
                     continue;
                 }
 
@@ -338,7 +784,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
                 if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
                     climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
+                    layer.set_state( index, ASL_CLOSED ); // Close it so that next time we won't try to calculate costs
                     continue;
                 }
 
@@ -368,7 +814,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                             int hp = veh->parts[part].hp();
                             if( hp / 20 > bash ) {
                                 // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
+                                layer.set_state( index, ASL_CLOSED );
                                 continue;
                             } else if( hp / 10 > bash ) {
                                 // Threshold damage thing means we will fail to deal damage pretty often
@@ -379,7 +825,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                         } else if( part >= 0 ) {
                             if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
                                 // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
+                                layer.set_state( index, ASL_CLOSED );
                             }
 
                             continue;
@@ -395,7 +841,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                         // Unbashable and unopenable from here
                         if( !doors || !terrain.open || !furniture.open ) {
                             // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
+                            layer.set_state( index, ASL_CLOSED );
                         }
 
                         continue;
@@ -416,13 +862,13 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                     // Otherwise this would have been a huge fall
                                     auto &layer = pf.get_layer( p.z - 1 );
                                     // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
+                                    pf.add_point( layer.gscore( parent_index ) + 10,
+                                                  layer.score( parent_index ) + 10 + 2 * rl_dist( below, t ),
                                                   cur, below );
                                 }
 
                                 // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
+                                layer.set_state( index, ASL_CLOSED );
                                 continue;
                             }
                         } else if( trapavoid ) {
@@ -433,14 +879,14 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 }
 
                 if( sharpavoid && p_special & PF_SHARP ) {
-                    layer.state[index] = ASL_CLOSED; // Avoid sharp things
+                    layer.set_state( index, ASL_CLOSED ); // Avoid sharp things
                 }
 
             }
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
-            if( layer.state[index] == ASL_NONE || newg < layer.gscore[index] ) {
+            if( layer.state( index ) == ASL_NONE || newg < layer.gscore( index ) ) {
                 pf.add_point( newg, newg + 2 * rl_dist( p, t ), cur, p );
             }
         }
@@ -456,8 +902,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z - 1 );
             if( vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.gscore( parent_index ) + 2,
+                              layer.score( parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -465,8 +911,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z + 1 );
             if( vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.gscore( parent_index ) + 2,
+                              layer.score( parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -475,8 +921,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( layer.gscore( parent_index ) + 4,
+                              layer.score( parent_index ) + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -489,7 +935,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         for( int fdist = max_length; fdist != 0; fdist-- ) {
             const int cur_index = flat_index( cur );
             const auto &layer = pf.get_layer( cur.z );
-            const tripoint &par = layer.parent[cur_index];
+            const tripoint par = layer.parent( cur_index );
             if( cur == f ) {
                 break;
             }
@@ -511,3 +957,137 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+bool pathfinding_settings::operator==( const pathfinding_settings &rhs ) const
+{
+    return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+           max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+           allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+           allow_climb_stairs == rhs.allow_climb_stairs &&
+           avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp &&
+           guide_by_portals == rhs.guide_by_portals;
+}
+
+pathfinding_flow_field::pathfinding_flow_field( const tripoint &target,
+        const pathfinding_settings &settings ) : target( target ), settings( settings )
+{
+}
+
+void pathfinding_flow_field::build( const map &m )
+{
+    const pathfinding_cache &pf_cache = m.get_pathfinding_cache_ref( target.z );
+    generation = pf_cache.generation;
+    built = true;
+    cost.assign( layer_size, INT_MAX );
+    next_step.assign( layer_size, -1 );
+
+    // Cells the field does not cover, the rest are plain or slow
+    const int excluded = settings.avoid_rough_terrain ? non_normal : non_normal & ~PF_SLOW;
+    const auto is_excluded = [&]( const point & p ) {
+        return ( pf_cache.special[p.x][p.y] & excluded ) != 0;
+    };
+    if( is_excluded( target.xy() ) ) {
+        return;
+    }
+
+    // Same area the regular search would look at when starting within max_dist
+    const int pad = settings.max_dist + 16;
+    const int map_limit = m.getmapsize() * SEEX;
+    const point min( std::max( 0, target.x - pad ), std::max( 0, target.y - pad ) );
+    const point max( std::min( map_limit, target.x + pad + 1 ),
+                     std::min( map_limit, target.y + pad + 1 ) );
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, pair_greater_cmp_first>
+            open;
+    cost[flat_index( target.xy() )] = 0;
+    open.emplace( 0, flat_index( target.xy() ) );
+    while( !open.empty() ) {
+        const std::pair<int, int> cur = open.top();
+        open.pop();
+        if( cur.first > cost[cur.second] ) {
+            continue;
+        }
+        const point cur_p = unflat_index( cur.second );
+        // Cost of stepping onto the current cell, as in map::route
+        const int enter_cost = pf_cache.special[cur_p.x][cur_p.y] & PF_SLOW ?
+                               m.move_cost( tripoint( cur_p, target.z ) ) : 2;
+        for( size_t i = 0; i < eight_adjacent_offsets.size(); i++ ) {
+            const point &d = eight_adjacent_offsets[i];
+            const point p = cur_p + d;
+            if( p.x < min.x || p.x >= max.x || p.y < min.y || p.y >= max.y || is_excluded( p ) ) {
+                continue;
+            }
+            const int new_cost = cur.first + enter_cost + ( d.x != 0 && d.y != 0 ? 1 : 0 );
+            if( new_cost > settings.max_length ) {
+                continue;
+            }
+            const int index = flat_index( p );
+            if( new_cost < cost[index] ) {
+                cost[index] = new_cost;
+                // Offsets come in opposite pairs, step back towards the current cell
+                next_step[index] = static_cast<int8_t>( ( i + 4 ) % 8 );
+                open.emplace( new_cost, index );
+            }
+        }
+    }
+}
+
+std::vector<tripoint> pathfinding_flow_field::route_from( const tripoint &from ) const
+{
+    std::vector<tripoint> ret;
+    if( !built || from.z != target.z || cost[flat_index( from.xy() )] == INT_MAX ) {
+        return ret;
+    }
+    point cur = from.xy();
+    while( cur != target.xy() ) {
+        cur += eight_adjacent_offsets[next_step[flat_index( cur )]];
+        ret.emplace_back( cur, target.z );
+    }
+    return ret;
+}
+
+std::vector<tripoint> map::crowd_route( const tripoint &f, const tripoint &t,
+                                        const pathfinding_settings &settings ) const
+{
+    // A small number keeps the lookup cheap, crowds rarely chase more targets
+    static constexpr size_t max_flow_fields = 8;
+
+    if( f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        return route( f, t, settings );
+    }
+    turn_profiler::scoped_timer timer( turn_profiler::phase::route );
+    std::vector<tripoint> ret = clear_line_route( *this, f, t, std::set<tripoint>() );
+    if( !ret.empty() ) {
+        return ret;
+    }
+
+    if( flow_fields_turn != calendar::turn ) {
+        flow_fields.clear();
+        flow_fields_turn = calendar::turn;
+    }
+    auto field = std::find_if( flow_fields.begin(), flow_fields.end(),
+    [&]( const pathfinding_flow_field & ff ) {
+        return ff.serves( t, settings );
+    } );
+    if( field == flow_fields.end() ) {
+        if( flow_fields.size() >= max_flow_fields ) {
+            return route( f, t, settings );
+        }
+        flow_fields.emplace_back( t, settings );
+        field = flow_fields.end() - 1;
+    }
+    // A lone pursuer is served faster by a single search
+    if( field->add_request() < 2 ) {
+        return route( f, t, settings );
+    }
+    if( !field->is_built() ||
+        field->cache_generation() != get_pathfinding_cache_ref( t.z ).generation ) {
+        field->build( *this );
+    }
+    ret = field->route_from( f );
+    if( ret.empty() ) {
+        return route( f, t, settings );
+    }
+    return ret;
+}
@@ -2,7 +2,13 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -43,10 +49,78 @@ struct pathfinding_cache {
     ~pathfinding_cache();
 
     bool dirty;
+    // Incremented on every rebuild, lets derived caches notice changes
+    int generation = 0;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
 };
 
+/**
+ * Abstract graph over the submaps of one z-level of the reality bubble, used
+ * to guide long routes.
+ *
+ * Every submap is a cluster. Each maximal run of walkable cells along the
+ * border of two adjacent clusters gets one portal on each side, and portals of
+ * a cluster are connected by their in-cluster walking cost. Walkability and
+ * costs are approximations derived from @ref pathfinding_cache alone (no
+ * doors, bashing or climbing), so a path found here is refined tile by tile
+ * with the regular A*.
+ */
+class pathfinding_portal_graph
+{
+    public:
+        /**
+         * Brings the graph up to date with the cache. Only clusters whose cells
+         * changed, and their neighbors, are rebuilt.
+         */
+        void refresh( const pathfinding_cache &cache, int map_size );
+
+        /**
+         * Portal cells to pass through on the way from @p from to @p to, not
+         * including either of them. Empty if both are in the same cluster or
+         * no connection is known.
+         */
+        std::vector<point> find_waypoints( const point &from, const point &to ) const;
+
+        int cache_generation() const {
+            return last_generation;
+        }
+        /** Number of clusters rebuilt by the last @ref refresh that changed anything. */
+        int last_rebuilt_clusters() const {
+            return rebuilt_clusters;
+        }
+        int portal_count() const;
+
+    private:
+        struct portal_edge {
+            // Flat cell index of the other portal
+            int to;
+            int cost;
+        };
+        struct cluster {
+            std::bitset<SEEX * SEEY> walkable;
+            std::bitset<SEEX * SEEY> slow;
+            bool built = false;
+            // Flat cell indices of portals and, in the same order, their edges
+            std::vector<int> portals;
+            std::vector<std::vector<portal_edge>> edges;
+        };
+
+        cluster &cluster_at( const point &c );
+        const cluster &cluster_at( const point &c ) const;
+        bool walkable_at( const point &p ) const;
+        // Recomputes portals and edges of a cluster from the walkable cells of it and its neighbors
+        void build_cluster( const point &c );
+        // In-cluster walking costs from a cell to every cell of its cluster
+        std::vector<int> cluster_costs( const point &c, const point &from ) const;
+        const std::vector<portal_edge> *edges_of( int flat ) const;
+
+        std::array<cluster, MAPSIZE *MAPSIZE> clusters;
+        int size = 0;
+        int last_generation = -1;
+        int rebuilt_clusters = 0;
+};
+
 struct pathfinding_settings {
     int bash_strength = 0;
     int max_dist = 0;
@@ -63,6 +137,14 @@ struct pathfinding_settings {
     bool avoid_rough_terrain = false;
     bool avoid_sharp = false;
 
+    // Long routes on one level follow the submap portal graph. Much faster across the
+    // reality bubble, but the graph only knows walls, so the route may take a detour
+    // where a door, bashing or climbing would be shorter.
+    // Monsters, hordes entering the bubble included, leave it off: they only search
+    // for goals within their max_dist (10 tiles for zombies, well under the two
+    // submaps where guidance starts) and walk straight at anything farther.
+    bool guide_by_portals = false;
+
     pathfinding_settings() = default;
     pathfinding_settings( const pathfinding_settings & ) = default;
     pathfinding_settings( int bs, int md, int ml, int cc, bool aod, bool at, bool acs, bool art,
@@ -70,6 +152,55 @@ struct pathfinding_settings {
         : bash_strength( bs ), max_dist( md ), max_length( ml ), climb_cost( cc ),
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ),
           avoid_sharp( as ) {}
+
+        bool operator==( const pathfinding_settings &rhs ) const;
+};
+
+class map;
+
+/**
+ * Walking costs from every cell of a z-level to one target, shared by all
+ * creatures heading there with the same settings.
+ *
+ * Built by a single Dijkstra search outwards from the target over the plain
+ * and slow cells of @ref pathfinding_cache, using the same step costs as
+ * @ref map::route. Cells that need a closer look (walls, vehicles, traps and
+ * sharp terrain) are left out, so creatures the field does not reach fall
+ * back to a regular route.
+ */
+class pathfinding_flow_field
+{
+    public:
+        pathfinding_flow_field( const tripoint &target, const pathfinding_settings &settings );
+
+        bool serves( const tripoint &t, const pathfinding_settings &s ) const {
+            return t == target && s == settings;
+        }
+        /** Counts a creature asking for a route, returns the number of requests so far. */
+        int add_request() {
+            return ++requests;
+        }
+        bool is_built() const {
+            return built;
+        }
+        /** Generation of the pathfinding cache the field was built from. */
+        int cache_generation() const {
+            return generation;
+        }
+
+        void build( const map &m );
+        /** Route from @p from to the target, empty if the field does not reach @p from. */
+        std::vector<tripoint> route_from( const tripoint &from ) const;
+
+    private:
+        tripoint target;
+        pathfinding_settings settings;
+        int requests = 0;
+        bool built = false;
+        int generation = -1;
+        // Per cell cost to the target and the offset index of the first step there
+        std::vector<int> cost;
+        std::vector<int8_t> next_step;
 };
 
 #endif // CATA_SRC_PATHFINDING_H
@@ -108,7 +108,7 @@ std::string relic::name() const
     return item_name_override.translated();
 }
 
-std::vector<enchantment> relic::get_enchantments() const
+const std::vector<enchantment> &relic::get_enchantments() const
 {
     return passive_effects;
 }
@@ -42,7 +42,7 @@ class relic
         void add_passive_effect( const enchantment &ench );
         void add_active_effect( const fake_spell &sp );
 
-        std::vector<enchantment> get_enchantments() const;
+        const std::vector<enchantment> &get_enchantments() const;
 
         void check() const;
 };
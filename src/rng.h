@@ -3,6 +3,7 @@
 #define CATA_SRC_RNG_H
 
 #include <array>
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <random>
@@ -17,13 +18,42 @@ class tripoint_range;
 struct tripoint;
 
 // All PRNG functions use an engine, see the C++11 <random> header
+// Every thread has its own engine, so worker threads neither race with nor
+// disturb the sequence of the main thread.
 // By default, that engine is seeded by time on first call to such a function.
-// If this function is called with a non-zero seed then the engine will be
-// seeded (or re-seeded) with the given seed.
+// If this function is called with a non-zero seed then the engine of the calling
+// thread will be seeded (or re-seeded) with the given seed.
 void rng_set_engine_seed( unsigned int seed );
 
 using cata_default_random_engine = std::minstd_rand0;
 cata_default_random_engine &rng_get_engine();
+// The distribution behind normal_roll, it keeps a value from the engine between calls
+std::normal_distribution<double> &rng_get_normal_distribution();
+
+/**
+ * Seeds the engine of the calling thread for as long as it exists and restores
+ * the engine's previous state afterwards. Work that is split across threads
+ * draws the same numbers no matter which thread does it or when.
+ */
+class scoped_rng_seed
+{
+    public:
+        explicit scoped_rng_seed( size_t seed ) : saved( rng_get_engine() ),
+            saved_normal( rng_get_normal_distribution() ) {
+            rng_get_engine().seed( static_cast<cata_default_random_engine::result_type>( seed ) );
+            rng_get_normal_distribution().reset();
+        }
+        scoped_rng_seed( const scoped_rng_seed & ) = delete;
+        scoped_rng_seed &operator=( const scoped_rng_seed & ) = delete;
+        ~scoped_rng_seed() {
+            rng_get_engine() = saved;
+            rng_get_normal_distribution() = saved_normal;
+        }
+
+    private:
+        cata_default_random_engine saved;
+        std::normal_distribution<double> saved_normal;
+};
 unsigned int rng_bits();
 
 int rng( int lo, int hi );
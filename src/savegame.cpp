@@ -904,11 +904,11 @@ void overmap::save_monster_groups( JsonOut &jout ) const
     std::unordered_map<mongroup, std::list<tripoint_om_sm>, mongroup_hash, mongroup_bin_eq>
     binned_groups;
     binned_groups.reserve( zg.size() );
-    for( const auto &pos_group : zg ) {
+    for( const mongroup &group : zg ) {
         // Each group in bin adds only position
         // so that 100 identical groups are 1 group data and 100 tripoints
-        std::list<tripoint_om_sm> &positions = binned_groups[pos_group.second];
-        positions.emplace_back( pos_group.first );
+        std::list<tripoint_om_sm> &positions = binned_groups[group];
+        positions.emplace_back( group.pos );
     }
 
     for( auto &group_bin : binned_groups ) {
@@ -1329,6 +1329,7 @@ void Creature_tracker::deserialize( JsonIn &jsin )
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_bucket.clear();
     jsin.start_array();
     while( !jsin.end_array() ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
@@ -3687,95 +3687,14 @@ void stats_tracker::deserialize( JsonIn &jsin )
     jo.read( "initial_scores", initial_scores );
 }
 
-void submap::store( JsonOut &jsout ) const
+void submap::store( JsonOut &jsout, bool with_grids ) const
 {
     jsout.member( "turn_last_touched", last_touched );
     jsout.member( "temperature", temperature );
 
-    // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
-    // this feature but the algorithm is backward compatible.
-    jsout.member( "terrain" );
-    jsout.start_array();
-    std::string last_id;
-    int num_same = 1;
-    for( int j = 0; j < SEEY; j++ ) {
-        // NOLINTNEXTLINE(modernize-loop-convert)
-        for( int i = 0; i < SEEX; i++ ) {
-            const std::string this_id = ter[i][j].obj().id.str();
-            if( !last_id.empty() ) {
-                if( this_id == last_id ) {
-                    num_same++;
-                } else {
-                    if( num_same == 1 ) {
-                        // if there's only one element don't write as an array
-                        jsout.write( last_id );
-                    } else {
-                        jsout.start_array();
-                        jsout.write( last_id );
-                        jsout.write( num_same );
-                        jsout.end_array();
-                        num_same = 1;
-                    }
-                    last_id = this_id;
-                }
-            } else {
-                last_id = this_id;
-            }
-        }
-    }
-    // Because of the RLE scheme we have to do one last pass
-    if( num_same == 1 ) {
-        jsout.write( last_id );
-    } else {
-        jsout.start_array();
-        jsout.write( last_id );
-        jsout.write( num_same );
-        jsout.end_array();
+    if( with_grids ) {
+        store_grids( jsout );
     }
-    jsout.end_array();
-
-    // Write out the radiation array in a simple RLE scheme.
-    // written in intensity, count pairs
-    jsout.member( "radiation" );
-    jsout.start_array();
-    int lastrad = -1;
-    int count = 0;
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point p( i, j );
-            // Save radiation, re-examine this because it doesn't look like it works right
-            int r = get_radiation( p );
-            if( r == lastrad ) {
-                count++;
-            } else {
-                if( count ) {
-                    jsout.write( count );
-                }
-                jsout.write( r );
-                lastrad = r;
-                count = 1;
-            }
-        }
-    }
-    jsout.write( count );
-    jsout.end_array();
-
-    jsout.member( "furniture" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point p( i, j );
-            // Save furniture
-            if( get_furn( p ) ) {
-                jsout.start_array();
-                jsout.write( p.x );
-                jsout.write( p.y );
-                jsout.write( get_furn( p ).obj().id );
-                jsout.end_array();
-            }
-        }
-    }
-    jsout.end_array();
 
     jsout.member( "items" );
     jsout.start_array();
@@ -3791,24 +3710,6 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    jsout.member( "traps" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point p( i, j );
-            // Save traps
-            if( get_trap( p ) ) {
-                jsout.start_array();
-                jsout.write( p.x );
-                jsout.write( p.y );
-                // TODO: jsout should support writing an id like jsout.write( trap_id )
-                jsout.write( get_trap( p ).id().str() );
-                jsout.end_array();
-            }
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "fields" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -3914,8 +3815,115 @@ void submap::store( JsonOut &jsout ) const
     jsout.end_array();
 }
 
+void submap::store_grids( JsonOut &jsout ) const
+{
+    // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
+    // this feature but the algorithm is backward compatible.
+    jsout.member( "terrain" );
+    jsout.start_array();
+    std::string last_id;
+    int num_same = 1;
+    for( int j = 0; j < SEEY; j++ ) {
+        // NOLINTNEXTLINE(modernize-loop-convert)
+        for( int i = 0; i < SEEX; i++ ) {
+            const std::string this_id = ter[i][j].obj().id.str();
+            if( !last_id.empty() ) {
+                if( this_id == last_id ) {
+                    num_same++;
+                } else {
+                    if( num_same == 1 ) {
+                        // if there's only one element don't write as an array
+                        jsout.write( last_id );
+                    } else {
+                        jsout.start_array();
+                        jsout.write( last_id );
+                        jsout.write( num_same );
+                        jsout.end_array();
+                        num_same = 1;
+                    }
+                    last_id = this_id;
+                }
+            } else {
+                last_id = this_id;
+            }
+        }
+    }
+    // Because of the RLE scheme we have to do one last pass
+    if( num_same == 1 ) {
+        jsout.write( last_id );
+    } else {
+        jsout.start_array();
+        jsout.write( last_id );
+        jsout.write( num_same );
+        jsout.end_array();
+    }
+    jsout.end_array();
+
+    // Write out the radiation array in a simple RLE scheme.
+    // written in intensity, count pairs
+    jsout.member( "radiation" );
+    jsout.start_array();
+    int lastrad = -1;
+    int count = 0;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            // Save radiation, re-examine this because it doesn't look like it works right
+            int r = get_radiation( p );
+            if( r == lastrad ) {
+                count++;
+            } else {
+                if( count ) {
+                    jsout.write( count );
+                }
+                jsout.write( r );
+                lastrad = r;
+                count = 1;
+            }
+        }
+    }
+    jsout.write( count );
+    jsout.end_array();
+
+    jsout.member( "furniture" );
+    jsout.start_array();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            // Save furniture
+            if( get_furn( p ) ) {
+                jsout.start_array();
+                jsout.write( p.x );
+                jsout.write( p.y );
+                jsout.write( get_furn( p ).obj().id );
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+
+    jsout.member( "traps" );
+    jsout.start_array();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            // Save traps
+            if( get_trap( p ) ) {
+                jsout.start_array();
+                jsout.write( p.x );
+                jsout.write( p.y );
+                // TODO: jsout should support writing an id like jsout.write( trap_id )
+                jsout.write( get_trap( p ).id().str() );
+                jsout.end_array();
+            }
+        }
+    }
+    jsout.end_array();
+}
+
 void submap::load( JsonIn &jsin, const std::string &member_name, int version )
 {
+    display_stamp++;
     if( member_name == "turn_last_touched" ) {
         last_touched = calendar::turn_zero + time_duration::from_turns( jsin.get_int() );
     } else if( member_name == "temperature" ) {
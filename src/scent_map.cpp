@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <memory>
 
 #include "assign.h"
 #include "calendar.h"
@@ -159,91 +160,129 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
+    // for loop constants
+    const point scentmap_min( center.x - SCENT_RADIUS, center.y - SCENT_RADIUS );
+    const point scentmap_max( center.x + SCENT_RADIUS, center.y + SCENT_RADIUS );
 
-    // these are for caching flag lookups
+    // these are for caching flag lookups, they need to be one square larger
+    // on each side than the updated area
     scent_array<bool> blocks_scent; // currently only TFLAG_NO_SCENT blocks scent
     scent_array<bool> reduces_scent;
+    m.scent_blockers( blocks_scent, reduces_scent, scentmap_min - point_south_east,
+                      scentmap_max + point_south_east );
 
-    // for loop constants
-    const int scentmap_minx = center.x - SCENT_RADIUS;
-    const int scentmap_maxx = center.x + SCENT_RADIUS;
-    const int scentmap_miny = center.y - SCENT_RADIUS;
-    const int scentmap_maxy = center.y + SCENT_RADIUS;
+    diffuse( grscent, blocks_scent, reduces_scent, scentmap_min, scentmap_max );
+}
+
+namespace
+{
+
+// Intermediate values of scent_map::diffuse, indexed [x][y] like the scent itself,
+// so the kernels run over contiguous memory in y.
+struct diffusion_buffers {
+    template<typename T>
+    using grid = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
+
+    // how much of the scent of a square diffuses, 0 if it blocks scent
+    grid<int> weight;
+    // 1000 times the share of scent that moves per neighboring square
+    grid<int> diffusivity;
+    // 0 if the square blocks scent, 1 otherwise
+    grid<int> keep;
+    // weighted scent and weights of the square and its neighbors in y
+    grid<int> sum_3_scent_y;
+    grid<int> squares_used_y;
+    // whether a column has any scent, and whether it needs the sums above
+    std::array<bool, MAPSIZE_X> has_scent;
+    std::array<bool, MAPSIZE_X> summed;
+};
+
+} // namespace
 
+void scent_map::diffuse( scent_array<int> &scent, const scent_array<bool> &blocks_scent,
+                         const scent_array<bool> &reduces_scent, const point &min, const point &max )
+{
     // decrease this to reduce gas spread. Keep it under 125 for
     // stability. This is essentially a decimal number * 1000.
-    const int diffusivity = 100;
+    constexpr int diffusivity = 100;
+
+    // Too large for the stack of some platforms
+    auto buffers = std::make_unique<diffusion_buffers>();
+    diffusion_buffers &b = *buffers;
+
+    // Turn the flags into factors, so the kernels below have no branches. A square that
+    // blocks scent diffuses nothing, only 20% of scent can diffuse on REDUCE_SCENT squares
+    // and there is less air movement on them.
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        bool has_scent = false;
+        for( int y = min.y - 1; y <= max.y + 1; ++y ) {
+            const int blocks = blocks_scent[x][y];
+            const int reduces = reduces_scent[x][y];
+            b.weight[x][y] = ( 1 - blocks ) * ( 10 - 8 * reduces );
+            b.diffusivity[x][y] = diffusivity - ( diffusivity - diffusivity / 5 ) * reduces;
+            b.keep[x][y] = 1 - blocks;
+            has_scent |= scent[x][y] != 0;
+        }
+        b.has_scent[x] = has_scent;
+        b.summed[x] = false;
+    }
+    // A column without scent next to columns without scent stays without scent
+    const auto column_changes = [&]( int x ) {
+        return b.has_scent[x - 1] || b.has_scent[x] || b.has_scent[x + 1];
+    };
+    for( int x = min.x; x <= max.x; ++x ) {
+        if( column_changes( x ) ) {
+            b.summed[x - 1] = true;
+            b.summed[x] = true;
+            b.summed[x + 1] = true;
+        }
+    }
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent, point( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
-    // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
-    // MAPSIZE_X, but if that changes, this may need tweaking.
-    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+    // times.
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        if( !b.summed[x] ) {
+            continue;
+        }
+        const int *const s = scent[x].data();
+        const int *const w = b.weight[x].data();
+        int *const sum = b.sum_3_scent_y[x].data();
+        int *const used = b.squares_used_y[x].data();
+        for( int y = min.y; y <= max.y; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum[y] = w[y - 1] * s[y - 1] + w[y] * s[y] + w[y + 1] * s[y + 1];
+            used[y] = w[y - 1] + w[y] + w[y + 1];
         }
     }
 
     // Rest of the scent map
-    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            int &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring REDUCE_SCENT squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent via NO_SCENT (in json)
-                scent_here = 0;
-            }
+    for( int x = min.x; x <= max.x; ++x ) {
+        if( !column_changes( x ) ) {
+            continue;
+        }
+        int *const s = scent[x].data();
+        const int *const d = b.diffusivity[x].data();
+        const int *const keep = b.keep[x].data();
+        const int *const sum_left = b.sum_3_scent_y[x - 1].data();
+        const int *const sum = b.sum_3_scent_y[x].data();
+        const int *const sum_right = b.sum_3_scent_y[x + 1].data();
+        const int *const used_left = b.squares_used_y[x - 1].data();
+        const int *const used = b.squares_used_y[x].data();
+        const int *const used_right = b.squares_used_y[x + 1].data();
+        for( int y = min.y; y <= max.y; ++y ) {
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = used_left[y] + used[y] + used_right[y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = s[y] * ( 10 * 1000 - squares_used * d[y] );
+            // neighboring REDUCE_SCENT squares absorb some scent
+            temp_scent -= s[y] * d[y] * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square. Squares that block scent via NO_SCENT (in json)
+            // lose all of it.
+            s[y] = keep[y] * ( ( temp_scent + d[y] * ( sum_left[y] + sum[y] + sum_right[y] ) ) /
+                               ( 1000 * 10 ) );
         }
     }
 }
@@ -41,10 +41,11 @@ class scent_type
 
 class scent_map
 {
-    protected:
+    public:
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
+    protected:
         scent_array<int> grscent;
         scenttype_id typescent;
         cata::optional<tripoint> player_last_position;
@@ -61,6 +62,12 @@ class scent_map
         void draw( const catacurses::window &win, int div, const tripoint &center ) const;
 
         void update( const tripoint &center, map &m );
+        /**
+         * Diffuses @p scent for one turn within the rectangle from @p min to @p max
+         * (inclusive). The flag arrays have to be filled one square beyond it.
+         */
+        static void diffuse( scent_array<int> &scent, const scent_array<bool> &blocks_scent,
+                             const scent_array<bool> &reduces_scent, const point &min, const point &max );
         void reset();
         void decay();
         void shift( const point &sm_shift );
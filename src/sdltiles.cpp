@@ -3036,6 +3036,10 @@ static void CheckMessages()
                 }
                 break;
             case SDL_RENDER_TARGETS_RESET:
+                // The contents of the render targets are gone
+                if( tilecontext ) {
+                    tilecontext->invalidate_map_layer();
+                }
                 need_redraw = true;
                 needupdate = true;
                 break;
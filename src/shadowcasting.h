@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -103,6 +104,45 @@ inline float accumulate_transparency( const float &cumulative_transparency,
     return ( ( distance - 1 ) * cumulative_transparency + current_transparency ) / distance;
 }
 
+/**
+ * Bit-packed summary of a transparency grid for the shadowcasting kernels.
+ *
+ * A cell is opaque when its transparency is exactly LIGHT_TRANSPARENCY_SOLID
+ * and clear when it is exactly LIGHT_TRANSPARENCY_OPEN_AIR. Each cell is
+ * stored both in its column and in its row, so the cells of any row an octant
+ * walks form one contiguous bit range, and a row that is entirely opaque or
+ * entirely clear can be recognized with a few word operations.
+ *
+ * The planes must be updated together with the grid they describe.
+ */
+class transparency_bitplanes
+{
+    public:
+        transparency_bitplanes();
+
+        void build( const float ( &transparency )[MAPSIZE_X][MAPSIZE_Y] );
+        void set( const point &p, float transparency );
+
+        /** Whether cells ( x, y_lo ) to ( x, y_hi ) are all opaque or all clear. */
+        bool column_is_uniform( int x, int y_lo, int y_hi ) const;
+        /** Whether cells ( x_lo, y ) to ( x_hi, y ) are all opaque or all clear. */
+        bool row_is_uniform( int y, int x_lo, int x_hi ) const;
+
+    private:
+        static_assert( MAPSIZE_X == MAPSIZE_Y, "rows and columns share one line layout" );
+        using line = std::array<std::uint64_t, ( MAPSIZE_X + 63 ) / 64>;
+
+        static bool all_set( const line &bits, int lo, int hi );
+
+        // Indexed by [is_clear]: bit y of columns[][x] and bit x of rows[][y]
+        // describe cell ( x, y ).
+        line columns[2][MAPSIZE_X];
+        line rows[2][MAPSIZE_Y];
+};
+
+// If @p planes describes @p input_array, rows that are entirely opaque or
+// entirely clear skip the per-cell slope and transition checks. The output is
+// the same with or without it.
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
@@ -110,7 +150,7 @@ template<typename T, typename Out, T( *calc )( const T &, const T &, const int &
 void castLightAll( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                    const T( &input_array )[MAPSIZE_X][MAPSIZE_Y],
                    const point &offset, int offsetDistance = 0,
-                   T numerator = 1.0 );
+                   T numerator = 1.0, const transparency_bitplanes *planes = nullptr );
 
 template<typename T>
 using array_of_grids_of = std::array<T( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS>;
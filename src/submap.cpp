@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <utility>
@@ -37,7 +38,14 @@ void maptile_soa<sx, sy>::swap_soa_tile( const point &p, maptile_soa<1, 1> &othe
     std::swap( rad[p.x][p.y], **other.rad );
 }
 
-submap::submap()
+// Starts a new range of display stamps, the changes of one submap stay within it
+static std::uint64_t new_display_stamp()
+{
+    static std::atomic<std::uint64_t> next_stamp{ 0 };
+    return next_stamp.fetch_add( std::uint64_t( 1 ) << 32 );
+}
+
+submap::submap() : display_stamp( new_display_stamp() )
 {
     std::uninitialized_fill_n( &ter[0][0], elements, t_null );
     std::uninitialized_fill_n( &frn[0][0], elements, f_null );
@@ -97,6 +105,7 @@ const std::string &submap::get_graffiti( const point &p ) const
 void submap::set_graffiti( const point &p, const std::string &new_graffiti )
 {
     is_uniform = false;
+    display_stamp++;
     // Find signage at p if available
     const auto fresult = find_cosmetic( cosmetics, p, COSMETICS_GRAFFITI );
     if( fresult.result ) {
@@ -109,6 +118,7 @@ void submap::set_graffiti( const point &p, const std::string &new_graffiti )
 void submap::delete_graffiti( const point &p )
 {
     is_uniform = false;
+    display_stamp++;
     const auto fresult = find_cosmetic( cosmetics, p, COSMETICS_GRAFFITI );
     if( fresult.result ) {
         cosmetics[ fresult.ndx ] = cosmetics.back();
@@ -234,6 +244,7 @@ void submap::rotate( int turns )
     if( turns == 0 ) {
         return;
     }
+    display_stamp++;
 
     const auto rotate_point = [turns]( const point & p ) {
         return p.rotate( turns, { SEEX, SEEY } );
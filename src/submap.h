@@ -89,10 +89,12 @@ class submap : maptile_soa<SEEX, SEEY>
 
         void set_furn( const point &p, furn_id furn ) {
             is_uniform = false;
+            display_stamp++;
             frn[p.x][p.y] = furn;
         }
 
         void set_all_furn( const furn_id &furn ) {
+            display_stamp++;
             std::uninitialized_fill_n( &frn[0][0], elements, furn );
         }
 
@@ -102,10 +104,12 @@ class submap : maptile_soa<SEEX, SEEY>
 
         void set_ter( const point &p, ter_id terr ) {
             is_uniform = false;
+            display_stamp++;
             ter[p.x][p.y] = terr;
         }
 
         void set_all_ter( const ter_id &terr ) {
+            display_stamp++;
             std::uninitialized_fill_n( &ter[0][0], elements, terr );
         }
 
@@ -225,13 +229,21 @@ class submap : maptile_soa<SEEX, SEEY>
 
         void rotate( int turns );
 
-        void store( JsonOut &jsout ) const;
+        /**
+         * Writes the submap as JSON object members. @p with_grids false leaves out terrain,
+         * furniture, traps and radiation, for formats that store those separately.
+         */
+        void store( JsonOut &jsout, bool with_grids = true ) const;
         void load( JsonIn &jsin, const std::string &member_name, int version );
 
         // If is_uniform is true, this submap is a solid block of terrain
         // Uniform submaps aren't saved/loaded, because regenerating them is faster
         bool is_uniform;
 
+        // Changes whenever terrain, furniture or graffiti change. No two submaps ever
+        // share one, so drawings of the submap can tell from it whether they are outdated.
+        std::uint64_t display_stamp;
+
         std::vector<cosmetic_t> cosmetics; // Textual "visuals" for squares
 
         active_item_cache active_items;
@@ -255,6 +267,7 @@ class submap : maptile_soa<SEEX, SEEY>
         int temperature = 0;
 
         void update_legacy_computer();
+        void store_grids( JsonOut &jsout ) const;
 
         static constexpr size_t elements = SEEX * SEEY;
 };
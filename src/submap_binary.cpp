@@ -0,0 +1,427 @@
+#include "submap_binary.h"
+
+#include <array>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "game.h"
+#include "game_constants.h"
+#include "json.h"
+#include "mapdata.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "trap.h"
+
+namespace submap_binary
+{
+
+namespace
+{
+
+constexpr std::array<char, 4> magic = {{ 'C', 'B', 'N', 'Q' }};
+
+class writer
+{
+    public:
+        std::string data;
+
+        void byte( uint8_t b ) {
+            data.push_back( static_cast<char>( b ) );
+        }
+        void varint( uint64_t v ) {
+            while( v >= 0x80 ) {
+                byte( static_cast<uint8_t>( v | 0x80 ) );
+                v >>= 7;
+            }
+            byte( static_cast<uint8_t>( v ) );
+        }
+        // Zigzag encoding keeps small negative numbers short
+        void svarint( int64_t v ) {
+            varint( ( static_cast<uint64_t>( v ) << 1 ) ^ static_cast<uint64_t>( v >> 63 ) );
+        }
+        void string( const std::string &s ) {
+            varint( s.size() );
+            data += s;
+        }
+};
+
+class reader
+{
+    public:
+        explicit reader( const std::string &data, size_t pos = 0 ) : data( data ), pos( pos ) {}
+
+        uint8_t byte() {
+            need( 1 );
+            return static_cast<uint8_t>( data[pos++] );
+        }
+        uint64_t varint() {
+            uint64_t ret = 0;
+            for( int shift = 0; shift < 64; shift += 7 ) {
+                const uint8_t b = byte();
+                ret |= static_cast<uint64_t>( b & 0x7f ) << shift;
+                if( !( b & 0x80 ) ) {
+                    return ret;
+                }
+            }
+            throw std::runtime_error( "malformed varint" );
+        }
+        int64_t svarint() {
+            const uint64_t v = varint();
+            return static_cast<int64_t>( v >> 1 ) ^ -static_cast<int64_t>( v & 1 );
+        }
+        // A count of things that each take at least a byte, checked against the remaining data
+        size_t count() {
+            const uint64_t v = varint();
+            if( v > data.size() - pos ) {
+                throw std::runtime_error( "count exceeds data size" );
+            }
+            return static_cast<size_t>( v );
+        }
+        std::string string() {
+            const size_t size = count();
+            std::string ret = data.substr( pos, size );
+            pos += size;
+            return ret;
+        }
+        bool at_end() const {
+            return pos == data.size();
+        }
+        size_t position() const {
+            return pos;
+        }
+
+    private:
+        void need( size_t bytes ) const {
+            if( data.size() - pos < bytes ) {
+                throw std::runtime_error( "unexpected end of data" );
+            }
+        }
+
+        const std::string &data;
+        size_t pos;
+};
+
+// Grids are walked row by row, the same order the JSON format uses.
+template<typename F>
+void for_each_cell( F func )
+{
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            func( point( i, j ) );
+        }
+    }
+}
+
+// Writes an id grid as a table of the string ids it uses followed by
+// (table index, run length) pairs.
+template<typename Getter>
+void write_id_grid( writer &w, Getter get_id )
+{
+    std::vector<std::string> table;
+    std::map<int, int> index_of;
+    std::vector<std::pair<int, int>> runs;
+    for_each_cell( [&]( const point & p ) {
+        const auto id = get_id( p );
+        auto iter = index_of.find( id.to_i() );
+        if( iter == index_of.end() ) {
+            iter = index_of.emplace( id.to_i(), static_cast<int>( table.size() ) ).first;
+            table.push_back( id.id().str() );
+        }
+        if( !runs.empty() && runs.back().first == iter->second ) {
+            runs.back().second++;
+        } else {
+            runs.emplace_back( iter->second, 1 );
+        }
+    } );
+    w.varint( table.size() );
+    for( const std::string &id : table ) {
+        w.string( id );
+    }
+    w.varint( runs.size() );
+    for( const std::pair<int, int> &run : runs ) {
+        w.varint( run.first );
+        w.varint( run.second );
+    }
+}
+
+// Reads what write_id_grid() wrote, @p resolve turns the string ids of the
+// table into the ids handed to @p set_id.
+template<typename Resolve, typename Setter>
+void read_id_grid( reader &r, Resolve resolve, Setter set_id )
+{
+    std::vector<decltype( resolve( std::string() ) )> table;
+    const size_t table_size = r.count();
+    table.reserve( table_size );
+    for( size_t i = 0; i < table_size; i++ ) {
+        table.push_back( resolve( r.string() ) );
+    }
+    size_t cell = 0;
+    const size_t runs = r.count();
+    for( size_t i = 0; i < runs; i++ ) {
+        const size_t index = r.varint();
+        const size_t length = r.varint();
+        if( index >= table.size() || length > SEEX * SEEY - cell ) {
+            throw std::runtime_error( "malformed grid" );
+        }
+        for( size_t end = cell + length; cell < end; cell++ ) {
+            set_id( point( cell % SEEX, cell / SEEX ), table[index] );
+        }
+    }
+    if( cell != SEEX * SEEY ) {
+        throw std::runtime_error( "grid does not cover the submap" );
+    }
+}
+
+void write_submap( writer &w, const tripoint &pos, const submap &sm )
+{
+    w.varint( savegame_version );
+    w.svarint( pos.x );
+    w.svarint( pos.y );
+    w.svarint( pos.z );
+
+    write_id_grid( w, [&sm]( const point & p ) {
+        return sm.get_ter( p );
+    } );
+    write_id_grid( w, [&sm]( const point & p ) {
+        return sm.get_furn( p );
+    } );
+    write_id_grid( w, [&sm]( const point & p ) {
+        return sm.get_trap( p );
+    } );
+
+    std::vector<std::pair<int, int>> radiation;
+    for_each_cell( [&]( const point & p ) {
+        const int rad = sm.get_radiation( p );
+        if( !radiation.empty() && radiation.back().first == rad ) {
+            radiation.back().second++;
+        } else {
+            radiation.emplace_back( rad, 1 );
+        }
+    } );
+    w.varint( radiation.size() );
+    for( const std::pair<int, int> &run : radiation ) {
+        w.svarint( run.first );
+        w.varint( run.second );
+    }
+
+    std::ostringstream contents;
+    JsonOut jsout( contents );
+    jsout.start_object();
+    sm.store( jsout, false );
+    jsout.end_object();
+    w.string( contents.str() );
+}
+
+std::pair<tripoint, std::unique_ptr<submap>> read_submap( reader &r )
+{
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    const int version = static_cast<int>( r.varint() );
+    tripoint pos;
+    pos.x = static_cast<int>( r.svarint() );
+    pos.y = static_cast<int>( r.svarint() );
+    pos.z = static_cast<int>( r.svarint() );
+
+    read_id_grid( r, []( const std::string & id ) {
+        return ter_str_id( id ).id();
+    }, [&sm]( const point & p, const ter_id & id ) {
+        sm->set_ter( p, id );
+    } );
+    read_id_grid( r, []( const std::string & id ) {
+        return furn_str_id( id ).id();
+    }, [&sm]( const point & p, const furn_id & id ) {
+        sm->set_furn( p, id );
+    } );
+    read_id_grid( r, []( const std::string & id ) {
+        return trap_str_id( id ).id();
+    }, [&sm]( const point & p, const trap_id & id ) {
+        sm->set_trap( p, id );
+    } );
+
+    size_t cell = 0;
+    const size_t runs = r.count();
+    for( size_t i = 0; i < runs; i++ ) {
+        const int rad = static_cast<int>( r.svarint() );
+        const size_t length = r.varint();
+        if( length > SEEX * SEEY - cell ) {
+            throw std::runtime_error( "malformed radiation grid" );
+        }
+        for( size_t end = cell + length; cell < end; cell++ ) {
+            sm->set_radiation( point( cell % SEEX, cell / SEEX ), rad );
+        }
+    }
+
+    std::istringstream contents( r.string() );
+    JsonIn jsin( contents );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        sm->load( jsin, member_name, version );
+    }
+    return std::make_pair( pos, std::move( sm ) );
+}
+
+constexpr int min_match = 4;
+constexpr int max_match = min_match + 255;
+constexpr int max_offset = 0xffff;
+constexpr int hash_bits = 15;
+
+uint32_t hash4( const char *p )
+{
+    uint32_t v;
+    std::memcpy( &v, p, sizeof( v ) );
+    return ( v * 2654435761u ) >> ( 32 - hash_bits );
+}
+
+} // namespace
+
+bool is_binary( const std::string &data )
+{
+    return data.size() >= magic.size() &&
+           std::equal( magic.begin(), magic.end(), data.begin() );
+}
+
+std::string encode_quad( const std::vector<std::pair<tripoint, const submap *>> &submaps,
+                         compression comp )
+{
+    writer payload;
+    payload.varint( submaps.size() );
+    for( const std::pair<tripoint, const submap *> &entry : submaps ) {
+        write_submap( payload, entry.first, *entry.second );
+    }
+
+    writer w;
+    w.data.assign( magic.begin(), magic.end() );
+    w.varint( format_version );
+    w.byte( static_cast<uint8_t>( comp ) );
+    w.varint( payload.data.size() );
+    if( comp == compression::lz ) {
+        w.data += compress( payload.data );
+    } else {
+        w.data += payload.data;
+    }
+    return w.data;
+}
+
+std::vector<std::pair<tripoint, std::unique_ptr<submap>>> decode_quad( const std::string &data )
+{
+    if( !is_binary( data ) ) {
+        throw std::runtime_error( "not a binary map quad" );
+    }
+    reader header( data, magic.size() );
+    const uint64_t version = header.varint();
+    if( version > format_version ) {
+        throw std::runtime_error( string_format( "unsupported map quad format version %d",
+                                  static_cast<int>( version ) ) );
+    }
+    const uint8_t comp = header.byte();
+    const size_t size = header.varint();
+
+    std::string payload_data;
+    const size_t payload_start = header.position();
+    if( comp == static_cast<uint8_t>( compression::lz ) ) {
+        payload_data = decompress( data.substr( payload_start ), size );
+    } else if( comp == static_cast<uint8_t>( compression::none ) ) {
+        payload_data = data.substr( payload_start );
+        if( payload_data.size() != size ) {
+            throw std::runtime_error( "map quad size mismatch" );
+        }
+    } else {
+        throw std::runtime_error( "unknown map quad compression" );
+    }
+
+    reader payload( payload_data );
+    std::vector<std::pair<tripoint, std::unique_ptr<submap>>> ret;
+    const size_t count = payload.count();
+    for( size_t i = 0; i < count; i++ ) {
+        ret.push_back( read_submap( payload ) );
+    }
+    if( !payload.at_end() ) {
+        throw std::runtime_error( "trailing data after map quad" );
+    }
+    return ret;
+}
+
+// Output is a sequence of groups: a flag byte followed by up to 8 tokens, one
+// per bit from the lowest. A clear bit is a literal byte, a set bit a match of
+// 2 bytes offset back into the output and 1 byte length - min_match.
+std::string compress( const std::string &data )
+{
+    std::string out;
+    out.reserve( data.size() / 2 );
+    std::vector<int> head( 1 << hash_bits, -1 );
+    const int size = static_cast<int>( data.size() );
+    size_t flag_pos = 0;
+    int token = 8;
+    int pos = 0;
+    while( pos < size ) {
+        if( token == 8 ) {
+            flag_pos = out.size();
+            out.push_back( 0 );
+            token = 0;
+        }
+        int match_len = 0;
+        int match_offset = 0;
+        if( pos + min_match <= size ) {
+            const uint32_t h = hash4( &data[pos] );
+            const int candidate = head[h];
+            head[h] = pos;
+            if( candidate >= 0 && pos - candidate <= max_offset ) {
+                const int limit = std::min( max_match, size - pos );
+                while( match_len < limit && data[candidate + match_len] == data[pos + match_len] ) {
+                    match_len++;
+                }
+                match_offset = pos - candidate;
+            }
+        }
+        if( match_len >= min_match ) {
+            out[flag_pos] = static_cast<char>( out[flag_pos] | ( 1 << token ) );
+            out.push_back( static_cast<char>( match_offset & 0xff ) );
+            out.push_back( static_cast<char>( match_offset >> 8 ) );
+            out.push_back( static_cast<char>( match_len - min_match ) );
+            // Index the skipped positions too, they are likely to repeat
+            for( int i = pos + 1; i < pos + match_len && i + min_match <= size; i++ ) {
+                head[hash4( &data[i] )] = i;
+            }
+            pos += match_len;
+        } else {
+            out.push_back( data[pos] );
+            pos++;
+        }
+        token++;
+    }
+    return out;
+}
+
+std::string decompress( const std::string &data, size_t size )
+{
+    std::string out;
+    out.reserve( size );
+    reader r( data );
+    while( !r.at_end() ) {
+        const uint8_t flags = r.byte();
+        for( int token = 0; token < 8 && !r.at_end(); token++ ) {
+            if( flags & ( 1 << token ) ) {
+                const size_t offset_low = r.byte();
+                const size_t offset = offset_low | ( static_cast<size_t>( r.byte() ) << 8 );
+                const size_t length = r.byte() + min_match;
+                if( offset == 0 || offset > out.size() || out.size() + length > size ) {
+                    throw std::runtime_error( "malformed compressed data" );
+                }
+                // Byte by byte, matches may overlap their own output
+                for( size_t i = 0; i < length; i++ ) {
+                    out.push_back( out[out.size() - offset] );
+                }
+            } else {
+                out.push_back( static_cast<char>( r.byte() ) );
+            }
+        }
+    }
+    if( out.size() != size ) {
+        throw std::runtime_error( "compressed data size mismatch" );
+    }
+    return out;
+}
+
+} // namespace submap_binary
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef CATA_SRC_SUBMAP_BINARY_H
+#define CATA_SRC_SUBMAP_BINARY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+
+class submap;
+
+/**
+ * Versioned binary encoding of the submap quads saved by @ref mapbuffer.
+ *
+ * A file starts with a magic string, the format version and the compression
+ * used for the rest of it. Terrain, furniture, traps and radiation are stored
+ * as run-length encoded grids over a per-submap table of string ids. Everything
+ * else a submap holds (items, vehicles, fields, ...) is rare enough that it is
+ * kept as the same JSON @ref submap::store writes, embedded as a string.
+ *
+ * Quad files that do not start with the magic string are the legacy JSON
+ * format, which @ref mapbuffer keeps reading.
+ */
+namespace submap_binary
+{
+
+/** Incremented whenever the layout changes, older versions must stay readable. */
+constexpr int format_version = 1;
+
+enum class compression : uint8_t {
+    none = 0,
+    // Byte-oriented LZ77, see compress()
+    lz = 1,
+};
+
+/** Whether @p data starts like a binary quad (as opposed to legacy JSON). */
+bool is_binary( const std::string &data );
+
+std::string encode_quad( const std::vector<std::pair<tripoint, const submap *>> &submaps,
+                         compression comp );
+
+/** @throw std::runtime_error if @p data is malformed. */
+std::vector<std::pair<tripoint, std::unique_ptr<submap>>> decode_quad( const std::string &data );
+
+/**
+ * A small LZ77 compressor: no dependencies, fast, and good enough for the
+ * long repeated runs of JSON keys and ids found in saved maps.
+ */
+std::string compress( const std::string &data );
+/** @throw std::runtime_error if @p data is malformed or does not decode to @p size bytes. */
+std::string decompress( const std::string &data, size_t size );
+
+} // namespace submap_binary
+
+#endif // CATA_SRC_SUBMAP_BINARY_H
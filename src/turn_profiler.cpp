@@ -0,0 +1,301 @@
+#include "turn_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "fstream_utils.h"
+#include "json.h"
+#include "string_formatter.h"
+
+namespace turn_profiler
+{
+
+namespace
+{
+
+struct turn_sample {
+    std::array<clock::duration::rep, num_phases> time{};
+    std::array<int, num_phases> calls{};
+
+    void add( int idx, clock::duration::rep ticks ) {
+        time[idx] += ticks;
+        calls[idx]++;
+    }
+    void merge( const turn_sample &other ) {
+        for( int i = 0; i < num_phases; i++ ) {
+            time[i] += other.time[i];
+            calls[i] += other.calls[i];
+        }
+    }
+};
+
+struct profiler_state {
+    std::atomic<bool> enabled{ false };
+    bool overlay = false;
+    // The thread that enabled the profiler owns `current` and the history.
+    std::thread::id owner;
+    turn_sample current;
+    // Time recorded by other threads (e.g. pathfinding and lighting workers),
+    // folded into `current` by the owner at the end of the turn.
+    std::mutex workers_mutex;
+    turn_sample from_workers;
+    // Ring buffer of finished turns, `next` is the slot to be written next.
+    std::vector<turn_sample> history;
+    int next = 0;
+};
+
+profiler_state &state()
+{
+    static profiler_state instance;
+    return instance;
+}
+
+// Timers of the same phase nest per thread, so each thread tracks its own.
+std::array<bool, num_phases> &entered()
+{
+    static thread_local std::array<bool, num_phases> instance{};
+    return instance;
+}
+
+void clear_worker_time( profiler_state &st )
+{
+    std::lock_guard<std::mutex> lock( st.workers_mutex );
+    st.from_workers = turn_sample();
+}
+
+double to_ms( clock::duration::rep ticks )
+{
+    return std::chrono::duration<double, std::milli>( clock::duration( ticks ) ).count();
+}
+
+// Nearest-rank percentile of an unsorted sample, reorders the sample.
+double percentile( std::vector<clock::duration::rep> &samples, double fraction )
+{
+    if( samples.empty() ) {
+        return 0.0;
+    }
+    const size_t rank = std::min( samples.size() - 1,
+                                  static_cast<size_t>( fraction * samples.size() ) );
+    std::nth_element( samples.begin(), samples.begin() + rank, samples.end() );
+    return to_ms( samples[rank] );
+}
+
+// Visits finished turns from the oldest to the newest.
+template<typename F>
+void for_each_turn( F func )
+{
+    const profiler_state &st = state();
+    const int count = static_cast<int>( st.history.size() );
+    const int first = count < history_size ? 0 : st.next;
+    for( int i = 0; i < count; i++ ) {
+        func( st.history[( first + i ) % count] );
+    }
+}
+
+} // namespace
+
+bool is_enabled()
+{
+    return state().enabled;
+}
+
+void set_enabled( bool enable )
+{
+    profiler_state &st = state();
+    st.owner = std::this_thread::get_id();
+    st.current = turn_sample();
+    clear_worker_time( st );
+    st.enabled = enable;
+}
+
+void reset()
+{
+    profiler_state &st = state();
+    st.current = turn_sample();
+    clear_worker_time( st );
+    st.history.clear();
+    st.next = 0;
+}
+
+bool overlay_enabled()
+{
+    return state().overlay;
+}
+
+void set_overlay_enabled( bool enable )
+{
+    state().overlay = enable;
+}
+
+void begin_turn()
+{
+    profiler_state &st = state();
+    st.current = turn_sample();
+    clear_worker_time( st );
+}
+
+void end_turn()
+{
+    profiler_state &st = state();
+    if( !st.enabled ) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( st.workers_mutex );
+        st.current.merge( st.from_workers );
+        st.from_workers = turn_sample();
+    }
+    if( static_cast<int>( st.history.size() ) < history_size ) {
+        st.history.push_back( st.current );
+    } else {
+        st.history[st.next] = st.current;
+    }
+    st.next = ( st.next + 1 ) % history_size;
+    st.current = turn_sample();
+}
+
+void record( phase p, clock::duration elapsed )
+{
+    profiler_state &st = state();
+    const int idx = static_cast<int>( p );
+    if( std::this_thread::get_id() == st.owner ) {
+        st.current.add( idx, elapsed.count() );
+        return;
+    }
+    std::lock_guard<std::mutex> lock( st.workers_mutex );
+    st.from_workers.add( idx, elapsed.count() );
+}
+
+bool try_enter( phase p )
+{
+    bool &is_entered = entered()[static_cast<int>( p )];
+    if( is_entered ) {
+        return false;
+    }
+    is_entered = true;
+    return true;
+}
+
+void leave( phase p )
+{
+    entered()[static_cast<int>( p )] = false;
+}
+
+int recorded_turns()
+{
+    return static_cast<int>( state().history.size() );
+}
+
+const char *phase_name( phase p )
+{
+    switch( p ) {
+        // *INDENT-OFF*
+        case phase::weather: return "weather";
+        case phase::activity: return "activity";
+        case phase::scent: return "scent";
+        case phase::vehmove: return "vehmove";
+        case phase::fields: return "fields";
+        case phase::items: return "items";
+        case phase::grid: return "grid";
+        case phase::sounds: return "sounds";
+        case phase::map_cache: return "map_cache";
+        case phase::monmove: return "monmove";
+        case phase::stair_monsters: return "stair_monsters";
+        case phase::mon_info: return "mon_info";
+        case phase::route: return "route";
+        case phase::cast_light: return "cast_light";
+        // *INDENT-ON*
+        case phase::num_phases:
+            break;
+    }
+    return "unknown";
+}
+
+phase_stats get_stats( phase p )
+{
+    const int idx = static_cast<int>( p );
+    phase_stats ret;
+    std::vector<clock::duration::rep> samples;
+    samples.reserve( state().history.size() );
+    clock::duration::rep total = 0;
+    for_each_turn( [&]( const turn_sample & turn ) {
+        samples.push_back( turn.time[idx] );
+        total += turn.time[idx];
+        ret.calls += turn.calls[idx];
+        ret.last_ms = to_ms( turn.time[idx] );
+    } );
+    ret.total_ms = to_ms( total );
+    if( !samples.empty() ) {
+        ret.max_ms = to_ms( *std::max_element( samples.begin(), samples.end() ) );
+    }
+    ret.p99_ms = percentile( samples, 0.99 );
+    ret.p50_ms = percentile( samples, 0.50 );
+    return ret;
+}
+
+std::vector<std::string> summary_lines()
+{
+    std::vector<std::string> ret;
+    ret.push_back( string_format( "turns: %d%s", recorded_turns(),
+                                  is_enabled() ? "" : " (paused)" ) );
+    ret.push_back( string_format( "%-14s %7s %7s %7s %7s", "phase", "last", "p50", "p99", "max" ) );
+    for( int i = 0; i < num_phases; i++ ) {
+        const phase p = static_cast<phase>( i );
+        const phase_stats stats = get_stats( p );
+        if( stats.calls == 0 ) {
+            continue;
+        }
+        ret.push_back( string_format( "%-14s %7.2f %7.2f %7.2f %7.2f", phase_name( p ),
+                                      stats.last_ms, stats.p50_ms, stats.p99_ms, stats.max_ms ) );
+    }
+    return ret;
+}
+
+bool write_report( const std::string &json_path, const std::string &csv_path )
+{
+    const bool json_ok = write_to_file( json_path, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout, true );
+        jsout.start_object();
+        jsout.member( "turns", recorded_turns() );
+        jsout.member( "phases" );
+        jsout.start_array();
+        for( int i = 0; i < num_phases; i++ ) {
+            const phase p = static_cast<phase>( i );
+            const phase_stats stats = get_stats( p );
+            jsout.start_object();
+            jsout.member( "name", std::string( phase_name( p ) ) );
+            jsout.member( "calls", stats.calls );
+            jsout.member( "total_ms", stats.total_ms );
+            jsout.member( "p50_ms", stats.p50_ms );
+            jsout.member( "p99_ms", stats.p99_ms );
+            jsout.member( "max_ms", stats.max_ms );
+            jsout.end_object();
+        }
+        jsout.end_array();
+        jsout.end_object();
+    }, "turn profile" );
+
+    const bool csv_ok = write_to_file( csv_path, [&]( std::ostream & fout ) {
+        fout << "turn";
+        for( int i = 0; i < num_phases; i++ ) {
+            fout << ',' << phase_name( static_cast<phase>( i ) ) << "_ms";
+        }
+        fout << '\n';
+        int turn_index = 0;
+        for_each_turn( [&]( const turn_sample & turn ) {
+            fout << turn_index++;
+            for( int i = 0; i < num_phases; i++ ) {
+                fout << ',' << to_ms( turn.time[i] );
+            }
+            fout << '\n';
+        } );
+    }, "turn profile" );
+
+    return json_ok && csv_ok;
+}
+
+} // namespace turn_profiler
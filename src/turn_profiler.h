@@ -0,0 +1,128 @@
+#pragma once
+#ifndef CATA_SRC_TURN_PROFILER_H
+#define CATA_SRC_TURN_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Lightweight wall-clock instrumentation of the phases of @ref game::do_turn.
+ *
+ * Always compiled in. While disabled, a @ref turn_profiler::scoped_timer costs
+ * a single flag check. While enabled, every phase accumulates wall time and
+ * call count for the current turn, and finished turns are kept in a ring
+ * buffer from which percentiles are computed on demand.
+ *
+ * Timers may run on worker threads. Their time is collected under a lock and
+ * added to the turn by @ref end_turn, so a phase split across threads reports
+ * the summed time of all threads rather than wall time. Everything else must
+ * be called from the thread that enabled the profiler.
+ */
+namespace turn_profiler
+{
+
+using clock = std::chrono::steady_clock;
+
+enum class phase : int {
+    weather = 0,
+    activity,
+    scent,
+    vehmove,
+    fields,
+    items,
+    grid,
+    sounds,
+    map_cache,
+    monmove,
+    stair_monsters,
+    mon_info,
+    // Nested hot spots. Their time is also included in the enclosing phase.
+    route,
+    cast_light,
+    num_phases
+};
+
+constexpr int num_phases = static_cast<int>( phase::num_phases );
+
+/** Number of finished turns kept for percentile computation. */
+constexpr int history_size = 1024;
+
+struct phase_stats {
+    /** Total calls and time over the recorded history. */
+    int64_t calls = 0;
+    double total_ms = 0.0;
+    /** Per-turn time percentiles, in milliseconds. */
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    /** Time spent in the last finished turn. */
+    double last_ms = 0.0;
+};
+
+bool is_enabled();
+void set_enabled( bool enable );
+/** Drops all recorded turns. */
+void reset();
+
+/** Whether the live summary should be drawn over the terrain window. */
+bool overlay_enabled();
+void set_overlay_enabled( bool enable );
+
+void begin_turn();
+void end_turn();
+/** Thread-safe. */
+void record( phase p, clock::duration elapsed );
+/**
+ * Marks a phase as being timed on the calling thread. Returns false if it
+ * already is, so that recursive code (e.g. a route built from shorter routes)
+ * is only counted once.
+ */
+bool try_enter( phase p );
+void leave( phase p );
+
+/** Number of finished turns currently held in the history. */
+int recorded_turns();
+
+const char *phase_name( phase p );
+phase_stats get_stats( phase p );
+
+/** Lines for the live overlay, one per phase with recorded activity. */
+std::vector<std::string> summary_lines();
+
+/**
+ * Writes a JSON summary (per-phase calls and p50/p99/max) to @p json_path,
+ * and one CSV row of per-phase milliseconds per recorded turn to @p csv_path.
+ */
+bool write_report( const std::string &json_path, const std::string &csv_path );
+
+/**
+ * Records the time between construction and destruction against a phase.
+ * Timers nested in another timer of the same phase record nothing.
+ */
+class scoped_timer
+{
+    public:
+        explicit scoped_timer( phase p ) : p( p ), active( is_enabled() && try_enter( p ) ) {
+            if( active ) {
+                start = clock::now();
+            }
+        }
+        scoped_timer( const scoped_timer & ) = delete;
+        scoped_timer &operator=( const scoped_timer & ) = delete;
+        ~scoped_timer() {
+            if( active ) {
+                record( p, clock::now() - start );
+                leave( p );
+            }
+        }
+    private:
+        phase p;
+        bool active;
+        clock::time_point start;
+};
+
+} // namespace turn_profiler
+
+#endif // CATA_SRC_TURN_PROFILER_H
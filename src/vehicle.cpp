@@ -1685,7 +1685,21 @@ int vehicle::install_part( const point &dp, const vehicle_part &new_part )
 
     pt.mount = dp;
 
-    refresh();
+    if( no_refresh || relative_parts.empty() ) {
+        refresh();
+    } else {
+        // The new part comes last, so adding it on its own gives the same
+        // caches as a full refresh. Only its own position needs calculating.
+        coord_translate( tileray( pivot_rotation[0] ), pivot_anchor[0], pt.mount, pt.precalc[0] );
+        cache_part( parts.size() - 1 );
+        front_left.x = mount_max.x;
+        front_left.y = mount_min.y;
+        front_right = mount_max;
+        check_environmental_effects = true;
+        insides_dirty = true;
+        zones_dirty = true;
+        invalidate_mass();
+    }
     coeff_air_changed = true;
     return parts.size() - 1;
 }
@@ -2475,6 +2489,18 @@ item_group::ItemList vehicle_part::pieces_for_broken_part() const
     return item_group::items_from( group, calendar::turn );
 }
 
+const vehicle::mount_parts *vehicle::find_mount( const point &mount ) const
+{
+    const auto it = std::lower_bound( relative_parts.begin(), relative_parts.end(), mount,
+    []( const mount_parts & mp, const point & pt ) {
+        return mp.mount < pt;
+    } );
+    if( it == relative_parts.end() || it->mount != mount ) {
+        return nullptr;
+    }
+    return &*it;
+}
+
 std::vector<int> vehicle::parts_at_relative( const point &dp,
         const bool use_cache ) const
 {
@@ -2487,9 +2513,9 @@ std::vector<int> vehicle::parts_at_relative( const point &dp,
         }
         return res;
     } else {
-        const auto &iter = relative_parts.find( dp );
-        if( iter != relative_parts.end() ) {
-            return iter->second;
+        const mount_parts *here = find_mount( dp );
+        if( here != nullptr ) {
+            return here->parts;
         } else {
             std::vector<int> res;
             return res;
@@ -2567,9 +2593,9 @@ int vehicle::part_with_feature( int part, vpart_bitflags const flag, bool unbrok
     if( part_flag( part, flag ) && ( !unbroken || !parts[part].is_broken() ) ) {
         return part;
     }
-    const auto it = relative_parts.find( parts[part].mount );
-    if( it != relative_parts.end() ) {
-        const std::vector<int> &parts_here = it->second;
+    const mount_parts *here = find_mount( parts[part].mount );
+    if( here != nullptr ) {
+        const std::vector<int> &parts_here = here->parts;
         for( auto &i : parts_here ) {
             if( part_flag( i, flag ) && ( !unbroken || !parts[i].is_broken() ) ) {
                 return i;
@@ -3097,17 +3123,28 @@ void vehicle::precalc_mounts( int idir, int dir, const point &pivot )
         idir = 0;
     }
     tileray tdir( dir );
-    std::unordered_map<point, point> mount_to_precalc;
-    for( auto &p : parts ) {
-        if( p.removed ) {
-            continue;
+    if( no_refresh ) {
+        // relative_parts may be outdated
+        std::unordered_map<point, point> mount_to_precalc;
+        for( auto &p : parts ) {
+            if( p.removed ) {
+                continue;
+            }
+            auto q = mount_to_precalc.find( p.mount );
+            if( q == mount_to_precalc.end() ) {
+                coord_translate( tdir, pivot, p.mount, p.precalc[idir] );
+                mount_to_precalc.insert( { p.mount, p.precalc[idir] } );
+            } else {
+                p.precalc[idir] = q->second;
+            }
         }
-        auto q = mount_to_precalc.find( p.mount );
-        if( q == mount_to_precalc.end() ) {
-            coord_translate( tdir, pivot, p.mount, p.precalc[idir] );
-            mount_to_precalc.insert( { p.mount, p.precalc[idir] } );
-        } else {
-            p.precalc[idir] = q->second;
+    } else {
+        for( const mount_parts &mp : relative_parts ) {
+            point q;
+            coord_translate( tdir, pivot, mp.mount, q );
+            for( const int p : mp.parts ) {
+                parts[p].precalc[idir] = q;
+            }
         }
     }
     pivot_anchor[idir] = pivot;
@@ -3703,7 +3740,7 @@ void vehicle::spew_field( double joules, int part, field_type_id type, int inten
     point p = parts[part].mount;
     intensity = std::max( joules / 10000, static_cast<double>( intensity ) );
     // Move back from engine/muffler until we find an open space
-    while( relative_parts.find( p ) != relative_parts.end() ) {
+    while( find_mount( p ) != nullptr ) {
         p.x += ( velocity < 0 ? 1 : -1 );
     }
     point q = coord_translate( p );
@@ -4810,17 +4847,25 @@ vehicle *vehicle::find_vehicle( const tripoint &where )
     return nullptr;
 }
 
-void vehicle::enumerate_vehicles( std::map<vehicle *, bool> &connected_vehicles,
+void vehicle::enumerate_vehicles( std::vector<std::pair<vehicle *, bool>> &connected_vehicles,
+                                  std::unordered_map<const vehicle *, size_t> &indices,
                                   const std::set<vehicle *> &vehicle_list )
 {
-    auto enumerate_visitor = [&connected_vehicles]( vehicle * veh, int amount ) {
-        // Only emplaces if element is not present already.
-        connected_vehicles.emplace( veh, false );
+    auto enumerate_visitor = [&connected_vehicles, &indices]( vehicle * veh, int amount ) {
+        // Only adds the vehicle if it is not present already.
+        if( indices.emplace( veh, connected_vehicles.size() ).second ) {
+            connected_vehicles.emplace_back( veh, false );
+        }
         return amount;
     };
     for( vehicle *veh : vehicle_list ) {
-        // This autovivifies, and also overwrites the value if already present.
-        connected_vehicles[veh] = true;
+        // Also overwrites the value if already present.
+        const auto inserted = indices.emplace( veh, connected_vehicles.size() );
+        if( inserted.second ) {
+            connected_vehicles.emplace_back( veh, true );
+        } else {
+            connected_vehicles[inserted.first->second].second = true;
+        }
         traverse_vehicle_graph( veh, 1, enumerate_visitor );
     }
 }
@@ -5550,142 +5595,43 @@ void vehicle::refresh()
     alternator_load = 0;
     extra_drag = 0;
     all_wheels_on_one_axis = true;
-    int first_wheel_y_mount = INT_MAX;
-
-    // Used to sort part list so it displays properly when examining
-    struct sort_veh_part_vector {
-        vehicle *veh;
-        inline bool operator()( const int p1, const int p2 ) {
-            return veh->part_info( p1 ).list_order < veh->part_info( p2 ).list_order;
-        }
-    } svpv = { this };
 
     mount_min.x = 123;
     mount_min.y = 123;
     mount_max.x = -123;
     mount_max.y = -123;
 
-    int railwheel_xmin = INT_MAX;
-    int railwheel_ymin = INT_MAX;
-    int railwheel_xmax = INT_MIN;
-    int railwheel_ymax = INT_MIN;
-
-    bool refresh_done = false;
-
-    // Main loop over all vehicle parts.
-    for( const vpart_reference &vp : get_all_parts() ) {
-        const size_t p = vp.part_index();
-        const vpart_info &vpi = vp.info();
-        if( vp.part().removed ) {
-            continue;
-        }
-        refresh_done = true;
-
-        // Build map of point -> all parts in that point
-        const point pt = vp.mount();
-        mount_min.x = std::min( mount_min.x, pt.x );
-        mount_min.y = std::min( mount_min.y, pt.y );
-        mount_max.x = std::max( mount_max.x, pt.x );
-        mount_max.y = std::max( mount_max.y, pt.y );
-
-        // This will keep the parts at point pt sorted
-        std::vector<int>::iterator vii = std::lower_bound( relative_parts[pt].begin(),
-                                         relative_parts[pt].end(),
-                                         static_cast<int>( p ), svpv );
-        relative_parts[pt].insert( vii, p );
+    rail_wheel_bounding_box.p1 = point( INT_MAX, INT_MAX );
+    rail_wheel_bounding_box.p2 = point( INT_MIN, INT_MIN );
 
-        if( vpi.has_flag( VPFLAG_FLOATS ) ) {
-            floating.push_back( p );
-        }
-
-        if( vp.part().is_unavailable() ) {
-            continue;
-        }
-        if( vpi.has_flag( VPFLAG_ALTERNATOR ) ) {
-            alternators.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_ENGINE ) ) {
-            engines.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_REACTOR ) ) {
-            reactors.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_SOLAR_PANEL ) ) {
-            solar_panels.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_ROTOR ) ) {
-            rotors.push_back( p );
-        }
-        if( vpi.has_flag( "WIND_TURBINE" ) ) {
-            wind_turbines.push_back( p );
-        }
-        if( vpi.has_flag( "WIND_POWERED" ) ) {
-            sails.push_back( p );
-        }
-        if( vpi.has_flag( "WATER_WHEEL" ) ) {
-            water_wheels.push_back( p );
-        }
-        if( vpi.has_flag( "FUNNEL" ) ) {
-            funnels.push_back( p );
+    // Lay out the mount points first, so adding the parts doesn't have to
+    // shift the table around.
+    std::vector<point> mounts;
+    mounts.reserve( parts.size() );
+    for( const vehicle_part &part : parts ) {
+        if( !part.removed ) {
+            mounts.push_back( part.mount );
         }
-        if( vpi.has_flag( "UNMOUNT_ON_MOVE" ) ) {
-            loose_parts.push_back( p );
-        }
-        if( vpi.has_flag( "EMITTER" ) ) {
-            emitters.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_WHEEL ) ) {
-            wheelcache.push_back( p );
-        }
-        if( vpi.has_flag( VPFLAG_WHEEL ) && vpi.has_flag( VPFLAG_RAIL ) ) {
-            rail_wheelcache.push_back( p );
-            if( first_wheel_y_mount == INT_MAX ) {
-                first_wheel_y_mount = vp.part().mount.y;
-            }
-            if( first_wheel_y_mount != vp.part().mount.y ) {
-                // vehicle have wheels on different axis
-                all_wheels_on_one_axis = false;
-            }
+    }
+    std::sort( mounts.begin(), mounts.end() );
+    mounts.erase( std::unique( mounts.begin(), mounts.end() ), mounts.end() );
+    relative_parts.reserve( mounts.size() );
+    for( const point &mount : mounts ) {
+        relative_parts.push_back( mount_parts{ mount, {} } );
+    }
 
-            railwheel_xmin = std::min( railwheel_xmin, pt.x );
-            railwheel_ymin = std::min( railwheel_ymin, pt.y );
-            railwheel_xmax = std::max( railwheel_xmax, pt.x );
-            railwheel_ymax = std::max( railwheel_ymax, pt.y );
-        }
-        if( ( vpi.has_flag( "STEERABLE" ) && part_with_feature( pt, "STEERABLE", true ) != -1 ) ||
-            vpi.has_flag( "TRACKED" ) ) {
-            // TRACKED contributes to steering effectiveness but
-            //  (a) doesn't count as a steering axle for install difficulty
-            //  (b) still contributes to drag for the center of steering calculation
-            steering.push_back( p );
-        }
-        if( vpi.has_flag( "SECURITY" ) ) {
-            speciality.push_back( p );
-        }
-        if( vp.part().enabled && vpi.has_flag( "EXTRA_DRAG" ) ) {
-            extra_drag += vpi.power;
-        }
-        if( vpi.has_flag( "EXTRA_DRAG" ) && ( vpi.has_flag( "WIND_TURBINE" ) ||
-                                              vpi.has_flag( "WATER_WHEEL" ) ) ) {
-            extra_drag += vpi.power;
-        }
-        if( camera_on && vpi.has_flag( "CAMERA" ) ) {
-            vp.part().enabled = true;
-        } else if( !camera_on && vpi.has_flag( "CAMERA" ) ) {
-            vp.part().enabled = false;
-        }
-        if( vpi.has_flag( "TURRET" ) && !has_part( global_part_pos3( vp.part() ), "TURRET_CONTROLS" ) ) {
-            vp.part().enabled = false;
+    // Main loop over all vehicle parts.
+    for( size_t p = 0; p < parts.size(); p++ ) {
+        if( !parts[p].removed ) {
+            cache_part( p );
         }
     }
 
-    rail_wheel_bounding_box.p1 = point( railwheel_xmin, railwheel_ymin );
-    rail_wheel_bounding_box.p2 = point( railwheel_xmax, railwheel_ymax );
     front_left.x = mount_max.x;
     front_left.y = mount_min.y;
     front_right = mount_max;
 
-    if( !refresh_done ) {
+    if( relative_parts.empty() ) {
         mount_min = mount_max = point_zero;
         rail_wheel_bounding_box.p1 = point_zero;
         rail_wheel_bounding_box.p2 = point_zero;
@@ -5699,6 +5645,114 @@ void vehicle::refresh()
     invalidate_mass();
 }
 
+void vehicle::cache_part( const int p )
+{
+    const vpart_reference vp( *this, p );
+    const vpart_info &vpi = vp.info();
+
+    // Build map of point -> all parts in that point
+    const point pt = vp.mount();
+    mount_min.x = std::min( mount_min.x, pt.x );
+    mount_min.y = std::min( mount_min.y, pt.y );
+    mount_max.x = std::max( mount_max.x, pt.x );
+    mount_max.y = std::max( mount_max.y, pt.y );
+
+    auto mount_it = std::lower_bound( relative_parts.begin(), relative_parts.end(), pt,
+    []( const mount_parts & mp, const point & mount ) {
+        return mp.mount < mount;
+    } );
+    if( mount_it == relative_parts.end() || mount_it->mount != pt ) {
+        mount_it = relative_parts.insert( mount_it, mount_parts{ pt, {} } );
+    }
+    // This will keep the parts at point pt sorted, so they display properly when examining
+    std::vector<int> &parts_here = mount_it->parts;
+    parts_here.insert( std::lower_bound( parts_here.begin(), parts_here.end(), p,
+    [this]( const int p1, const int p2 ) {
+        return part_info( p1 ).list_order < part_info( p2 ).list_order;
+    } ), p );
+
+    if( vpi.has_flag( VPFLAG_FLOATS ) ) {
+        floating.push_back( p );
+    }
+
+    if( vp.part().is_unavailable() ) {
+        return;
+    }
+    if( vpi.has_flag( VPFLAG_ALTERNATOR ) ) {
+        alternators.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_ENGINE ) ) {
+        engines.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_REACTOR ) ) {
+        reactors.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_SOLAR_PANEL ) ) {
+        solar_panels.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_ROTOR ) ) {
+        rotors.push_back( p );
+    }
+    if( vpi.has_flag( "WIND_TURBINE" ) ) {
+        wind_turbines.push_back( p );
+    }
+    if( vpi.has_flag( "WIND_POWERED" ) ) {
+        sails.push_back( p );
+    }
+    if( vpi.has_flag( "WATER_WHEEL" ) ) {
+        water_wheels.push_back( p );
+    }
+    if( vpi.has_flag( "FUNNEL" ) ) {
+        funnels.push_back( p );
+    }
+    if( vpi.has_flag( "UNMOUNT_ON_MOVE" ) ) {
+        loose_parts.push_back( p );
+    }
+    if( vpi.has_flag( "EMITTER" ) ) {
+        emitters.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_WHEEL ) ) {
+        wheelcache.push_back( p );
+    }
+    if( vpi.has_flag( VPFLAG_WHEEL ) && vpi.has_flag( VPFLAG_RAIL ) ) {
+        rail_wheelcache.push_back( p );
+        if( parts[rail_wheelcache.front()].mount.y != vp.part().mount.y ) {
+            // vehicle have wheels on different axis
+            all_wheels_on_one_axis = false;
+        }
+
+        rail_wheel_bounding_box.p1.x = std::min( rail_wheel_bounding_box.p1.x, pt.x );
+        rail_wheel_bounding_box.p1.y = std::min( rail_wheel_bounding_box.p1.y, pt.y );
+        rail_wheel_bounding_box.p2.x = std::max( rail_wheel_bounding_box.p2.x, pt.x );
+        rail_wheel_bounding_box.p2.y = std::max( rail_wheel_bounding_box.p2.y, pt.y );
+    }
+    if( ( vpi.has_flag( "STEERABLE" ) && part_with_feature( pt, "STEERABLE", true ) != -1 ) ||
+        vpi.has_flag( "TRACKED" ) ) {
+        // TRACKED contributes to steering effectiveness but
+        //  (a) doesn't count as a steering axle for install difficulty
+        //  (b) still contributes to drag for the center of steering calculation
+        steering.push_back( p );
+    }
+    if( vpi.has_flag( "SECURITY" ) ) {
+        speciality.push_back( p );
+    }
+    if( vp.part().enabled && vpi.has_flag( "EXTRA_DRAG" ) ) {
+        extra_drag += vpi.power;
+    }
+    if( vpi.has_flag( "EXTRA_DRAG" ) && ( vpi.has_flag( "WIND_TURBINE" ) ||
+                                          vpi.has_flag( "WATER_WHEEL" ) ) ) {
+        extra_drag += vpi.power;
+    }
+    if( camera_on && vpi.has_flag( "CAMERA" ) ) {
+        vp.part().enabled = true;
+    } else if( !camera_on && vpi.has_flag( "CAMERA" ) ) {
+        vp.part().enabled = false;
+    }
+    if( vpi.has_flag( "TURRET" ) && !has_part( global_part_pos3( vp.part() ), "TURRET_CONTROLS" ) ) {
+        vp.part().enabled = false;
+    }
+}
+
 const point &vehicle::pivot_point() const
 {
     if( pivot_dirty ) {
@@ -692,6 +692,8 @@ class vehicle
 
         //Refresh all caches and re-locate all parts
         void refresh();
+        // Adds a part that isn't removed to relative_parts and the caches refresh builds
+        void cache_part( int p );
 
         // Do stuff like clean up blood and produce smoke from broken parts. Returns false if nothing needs doing.
         bool do_environmental_effects();
@@ -1377,11 +1379,14 @@ class vehicle
 
         /**
          * Use grid traversal to enumerate all connected vehicles.
-         * @param connected_vehicles is an output map from vehicle pointers to
+         * @param connected_vehicles is an output list of vehicle pointers and
          * a bool that is true if the vehicle is in the reality bubble.
+         * @param indices is the index of each vehicle in connected_vehicles,
+         * for calling this several times with the same output.
          * @param vehicle_list is a set of pointers to vehicles present in the reality bubble.
          */
-        static void enumerate_vehicles( std::map<vehicle *, bool> &connected_vehicles,
+        static void enumerate_vehicles( std::vector<std::pair<vehicle *, bool>> &connected_vehicles,
+                                        std::unordered_map<const vehicle *, size_t> &indices,
                                         const std::set<vehicle *> &vehicle_list );
         // idle fuel consumption
         void idle( bool on_map = true );
@@ -1770,8 +1775,15 @@ class vehicle
          * spawned with the default constructor).
          */
         vproto_id type;
-        // parts_at_relative(dp) is used a lot (to put it mildly)
-        std::map<point, std::vector<int>> relative_parts;
+        struct mount_parts {
+            point mount;
+            // Sorted by list order
+            std::vector<int> parts;
+        };
+        // parts_at_relative(dp) is used a lot (to put it mildly), sorted by mount point
+        std::vector<mount_parts> relative_parts;
+        // The parts at the mount point, nullptr if there are none
+        const mount_parts *find_mount( const point &mount ) const;
         std::set<label> labels;            // stores labels
         std::set<std::string> tags;        // Properties of the vehicle
         // After fuel consumption, this tracks the remainder of fuel < 1, and applies it the next time.
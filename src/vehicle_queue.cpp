@@ -0,0 +1,142 @@
+#include "vehicle_queue.h"
+
+#include "vehicle.h"
+
+bool vehicle_queue::before( const entry &a, const entry &b )
+{
+    if( a.of_turn != b.of_turn ) {
+        return a.of_turn > b.of_turn;
+    }
+    return a.order < b.order;
+}
+
+void vehicle_queue::place( size_t index, const entry &e )
+{
+    heap[index] = e;
+    positions[e.veh] = index;
+}
+
+void vehicle_queue::sift_up( size_t index )
+{
+    const entry e = heap[index];
+    while( index > 0 ) {
+        const size_t parent = ( index - 1 ) / 2;
+        if( !before( e, heap[parent] ) ) {
+            break;
+        }
+        place( index, heap[parent] );
+        index = parent;
+    }
+    place( index, e );
+}
+
+void vehicle_queue::sift_down( size_t index )
+{
+    const entry e = heap[index];
+    while( true ) {
+        size_t child = index * 2 + 1;
+        if( child >= heap.size() ) {
+            break;
+        }
+        if( child + 1 < heap.size() && before( heap[child + 1], heap[child] ) ) {
+            child++;
+        }
+        if( !before( heap[child], e ) ) {
+            break;
+        }
+        place( index, heap[child] );
+        index = child;
+    }
+    place( index, e );
+}
+
+void vehicle_queue::push( vehicle *veh )
+{
+    if( contains( veh ) ) {
+        return;
+    }
+    heap.push_back( entry{ veh, veh->of_turn, next_order++ } );
+    positions[veh] = heap.size() - 1;
+    sift_up( heap.size() - 1 );
+}
+
+void vehicle_queue::erase( const vehicle *veh )
+{
+    const auto found = positions.find( veh );
+    if( found == positions.end() ) {
+        return;
+    }
+    const size_t index = found->second;
+    positions.erase( found );
+    if( index + 1 == heap.size() ) {
+        heap.pop_back();
+        return;
+    }
+    place( index, heap.back() );
+    heap.pop_back();
+    const vehicle *moved = heap[index].veh;
+    sift_up( index );
+    sift_down( positions[moved] );
+}
+
+void vehicle_queue::update( const vehicle *veh )
+{
+    const auto found = positions.find( veh );
+    if( found == positions.end() ) {
+        return;
+    }
+    const size_t index = found->second;
+    heap[index].of_turn = veh->of_turn;
+    sift_up( index );
+    sift_down( positions[veh] );
+}
+
+void vehicle_queue::replace( const vehicle *old_veh, vehicle *new_veh )
+{
+    if( old_veh == new_veh ) {
+        update( new_veh );
+        return;
+    }
+    if( !contains( old_veh ) ) {
+        push( new_veh );
+        return;
+    }
+    // The new vehicle might have been waiting on its own
+    erase( new_veh );
+    const auto found = positions.find( old_veh );
+    const size_t index = found->second;
+    positions.erase( found );
+    heap[index].veh = new_veh;
+    heap[index].of_turn = new_veh->of_turn;
+    positions[new_veh] = index;
+    sift_up( index );
+    sift_down( positions[new_veh] );
+}
+
+void vehicle_queue::clear()
+{
+    heap.clear();
+    positions.clear();
+    next_order = 0;
+}
+
+vehicle *vehicle_queue::top() const
+{
+    return heap.empty() ? nullptr : heap.front().veh;
+}
+
+vehicle *vehicle_queue::first_added( const std::function<bool( const vehicle & )> &pred ) const
+{
+    const entry *first = nullptr;
+    for( const entry &e : heap ) {
+        if( ( first == nullptr || e.order < first->order ) && pred( *e.veh ) ) {
+            first = &e;
+        }
+    }
+    return first == nullptr ? nullptr : first->veh;
+}
+
+bool vehicle_queue::contains( const vehicle *veh ) const
+{
+    return positions.count( veh ) > 0;
+}
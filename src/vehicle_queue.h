@@ -0,0 +1,63 @@
+#pragma once
+#ifndef CATA_SRC_VEHICLE_QUEUE_H
+#define CATA_SRC_VEHICLE_QUEUE_H
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class vehicle;
+
+/**
+ * Vehicles taking turns to move during map::vehmove, ordered by the movement
+ * they have left (vehicle::of_turn). Of vehicles with equal movement the one
+ * added first goes first.
+ *
+ * The queue remembers the movement of each vehicle, so it must be told with
+ * @ref update whenever that changes.
+ */
+class vehicle_queue
+{
+    public:
+        void push( vehicle *veh );
+        /** Does nothing if the vehicle is not in the queue. */
+        void erase( const vehicle *veh );
+        /** Moves the vehicle to its place after its movement changed, if it is in the queue. */
+        void update( const vehicle *veh );
+        /** The new vehicle takes the place of the old one, e.g. after vehicle::act_on_map. */
+        void replace( const vehicle *old_veh, vehicle *new_veh );
+        void clear();
+
+        /** The vehicle with the most movement left, nullptr if the queue is empty. */
+        vehicle *top() const;
+        /** Of the vehicles matching the predicate, the one added first. */
+        vehicle *first_added( const std::function<bool( const vehicle & )> &pred ) const;
+        bool contains( const vehicle *veh ) const;
+        bool empty() const {
+            return heap.empty();
+        }
+        size_t size() const {
+            return heap.size();
+        }
+
+    private:
+        struct entry {
+            vehicle *veh;
+            float of_turn;
+            size_t order;
+        };
+
+        // Whether a has to move before b
+        static bool before( const entry &a, const entry &b );
+        void place( size_t index, const entry &e );
+        void sift_up( size_t index );
+        void sift_down( size_t index );
+
+        std::vector<entry> heap;
+        // Index in the heap of each vehicle
+        std::unordered_map<const vehicle *, size_t> positions;
+        size_t next_order = 0;
+};
+
+#endif // CATA_SRC_VEHICLE_QUEUE_H
@@ -173,9 +173,15 @@ bool visitable<T>::has_quality( const quality_id &qual, int level, int qty ) con
 template <>
 bool visitable<inventory>::has_quality( const quality_id &qual, int level, int qty ) const
 {
+    const quality_bin &bins = static_cast<const inventory *>( this )->get_quality_bins();
+    const auto iter = bins.find( qual );
+    if( iter == bins.end() ) {
+        return false;
+    }
+
     int res = 0;
-    for( const auto &stack : static_cast<const inventory *>( this )->items ) {
-        res += stack.size() * has_quality_internal( stack.front(), qual, level, qty );
+    for( const std::list<item> *stack : iter->second ) {
+        res += stack->size() * has_quality_internal( stack->front(), qual, level, qty );
         if( res >= qty ) {
             return true;
         }
@@ -263,6 +269,25 @@ int visitable<T>::max_quality( const quality_id &qual ) const
     return max_quality_internal( *this, qual );
 }
 
+/** @relates visitable */
+template<>
+int visitable<inventory>::max_quality( const quality_id &qual ) const
+{
+    const quality_bin &bins = static_cast<const inventory *>( this )->get_quality_bins();
+    const auto iter = bins.find( qual );
+    if( iter == bins.end() ) {
+        return INT_MIN;
+    }
+
+    int res = INT_MIN;
+    for( const std::list<item> *stack : iter->second ) {
+        for( const item &it : *stack ) {
+            res = std::max( res, max_quality_internal( it, qual ) );
+        }
+    }
+    return res;
+}
+
 /** @relates visitable */
 template<>
 int visitable<Character>::max_quality( const quality_id &qual ) const
@@ -948,6 +973,9 @@ int visitable<inventory>::amount_of( const itype_id &what, bool pseudo, int limi
     } else {
         for( const item *it : iter->second ) {
             res = sum_no_wrap( res, it->amount_of( what, pseudo, limit, filter ) );
+            if( res >= limit ) {
+                break;
+            }
         }
     }
 
@@ -0,0 +1,94 @@
+#include "worker_pool.h"
+
+worker_pool::worker_pool( int extra_threads )
+{
+    for( int i = 0; i < extra_threads; i++ ) {
+        threads.emplace_back( &worker_pool::work, this );
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    wake.notify_all();
+    for( std::thread &t : threads ) {
+        t.join();
+    }
+}
+
+void worker_pool::run( int count, const std::function<void( int )> &task )
+{
+    if( count <= 0 ) {
+        return;
+    }
+    if( threads.empty() || count == 1 ) {
+        for( int i = 0; i < count; i++ ) {
+            task( i );
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        current_task = &task;
+        task_count = count;
+        next_task = 0;
+        tasks_done = 0;
+        error = nullptr;
+        batch++;
+    }
+    wake.notify_all();
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock( mutex );
+    finished.wait( lock, [this]() {
+        return tasks_done == task_count;
+    } );
+    current_task = nullptr;
+    if( error ) {
+        std::rethrow_exception( error );
+    }
+}
+
+void worker_pool::work()
+{
+    size_t seen_batch = 0;
+    while( true ) {
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            wake.wait( lock, [&]() {
+                return stopping || batch != seen_batch;
+            } );
+            if( stopping ) {
+                return;
+            }
+            seen_batch = batch;
+        }
+        run_tasks();
+    }
+}
+
+void worker_pool::run_tasks()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while( current_task != nullptr && next_task < task_count ) {
+        const int index = next_task++;
+        const std::function<void( int )> &task = *current_task;
+        lock.unlock();
+        std::exception_ptr task_error;
+        try {
+            task( index );
+        } catch( ... ) {
+            task_error = std::current_exception();
+        }
+        lock.lock();
+        if( task_error && !error ) {
+            error = task_error;
+        }
+        if( ++tasks_done == task_count ) {
+            finished.notify_all();
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef CATA_SRC_WORKER_POOL_H
+#define CATA_SRC_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+/**
+ * A fixed set of threads for splitting a batch of independent tasks.
+ *
+ * The calling thread takes part in the work, so a pool with no extra threads
+ * simply runs every task in order. Only one batch runs at a time.
+ */
+class worker_pool
+{
+    public:
+        /** @param extra_threads Number of threads started in addition to the calling one. */
+        explicit worker_pool( int extra_threads );
+        worker_pool( const worker_pool & ) = delete;
+        worker_pool &operator=( const worker_pool & ) = delete;
+        ~worker_pool();
+
+        /**
+         * Calls @p task once for each index in [0, count) and returns when all
+         * calls are done. The first exception thrown by a task is rethrown here.
+         */
+        void run( int count, const std::function<void( int )> &task );
+
+        int thread_count() const {
+            return static_cast<int>( threads.size() ) + 1;
+        }
+
+    private:
+        void work();
+        void run_tasks();
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+
+        // State of the current batch, guarded by mutex
+        const std::function<void( int )> *current_task = nullptr;
+        int task_count = 0;
+        int next_task = 0;
+        int tasks_done = 0;
+        // Incremented for each batch so sleeping workers notice a new one
+        size_t batch = 0;
+        bool stopping = false;
+        std::exception_ptr error;
+};
+
+#endif // CATA_SRC_WORKER_POOL_H
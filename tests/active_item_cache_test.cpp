@@ -1,6 +1,10 @@
+#include <list>
+#include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
+#include "active_item_cache.h"
 #include "calendar.h"
 #include "catch/catch.hpp"
 #include "game.h"
@@ -46,3 +50,80 @@ TEST_CASE( "place_active_item_at_various_coordinates", "[item]" )
         }
     }
 }
+
+TEST_CASE( "active_item_cache_processes_items_round_robin", "[item]" )
+{
+    std::list<item> items;
+    active_item_cache cache;
+    item &firecracker = *items.emplace( items.end(), "firecracker_act", calendar::start_of_cataclysm,
+                                        item::default_charges_tag() );
+    cache.add( firecracker, point_zero );
+    const int food_count = 1200;
+    for( int i = 0; i < food_count; ++i ) {
+        item &apple = *items.emplace( items.end(), "apple" );
+        cache.add( apple, point( i % SEEX, 0 ) );
+        // Adding it again does nothing
+        cache.add( apple, point( i % SEEX, 0 ) );
+    }
+    REQUIRE( firecracker.processing_speed() == 1 );
+    const int food_speed = items.back().processing_speed();
+    REQUIRE( cache.get().size() == items.size() );
+
+    std::map<const item *, int> times_processed;
+    std::vector<item_reference> to_process;
+    // Enough calls to get through every apple once
+    const int calls = food_count / ( food_count / food_speed + 1 );
+    for( int i = 0; i < calls; ++i ) {
+        cache.get_for_processing( to_process );
+        for( const item_reference &ref : to_process ) {
+            times_processed[ref.item_ref.get()]++;
+        }
+    }
+    CHECK( times_processed[&firecracker] == calls );
+    for( const item &it : items ) {
+        if( &it != &firecracker ) {
+            CHECK( times_processed[&it] == 1 );
+        }
+    }
+
+    // Destroyed items drop out of the cache, removed ones too
+    cache.remove( &firecracker );
+    items.erase( items.begin() );
+    for( int i = 0; i < food_count / 2; ++i ) {
+        items.pop_back();
+    }
+    cache.get_for_processing( to_process );
+    for( const item_reference &ref : to_process ) {
+        CHECK( ref.item_ref );
+        CHECK( ref.item_ref.get() != &firecracker );
+    }
+    CHECK( cache.get().size() == items.size() );
+    items.clear();
+    CHECK( cache.get().empty() );
+    CHECK( cache.empty() );
+}
+
+TEST_CASE( "active_item_cache_benchmark", "[.][item][benchmark]" )
+{
+    std::list<item> items;
+    active_item_cache cache;
+    for( int i = 0; i < 200; ++i ) {
+        cache.add( *items.emplace( items.end(), "firecracker_act", calendar::start_of_cataclysm,
+                                   item::default_charges_tag() ), point( i % SEEX, i / SEEX % SEEY ) );
+        for( int j = 0; j < 10; ++j ) {
+            cache.add( *items.emplace( items.end(), "apple" ), point( i % SEEX, i / SEEX % SEEY ) );
+        }
+    }
+    std::vector<item_reference> to_process;
+
+    BENCHMARK( "get items for processing" ) {
+        cache.get_for_processing( to_process );
+        return to_process.size();
+    };
+    BENCHMARK( "remove and add an item" ) {
+        item &it = items.back();
+        cache.remove( &it );
+        cache.add( it, point_zero );
+        return cache.empty();
+    };
+}
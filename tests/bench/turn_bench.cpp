@@ -0,0 +1,232 @@
+// Headless turn-throughput benchmark.
+//
+// Loads either a saved world or a generated fixture (monsters, fires and
+// moving vehicles around the player), then advances game::do_turn a fixed
+// number of times with a fixed RNG seed and reports turns/sec together with
+// the per-phase breakdown collected by the turn profiler.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "avatar.h"
+#include "calendar.h"
+#include "debug.h"
+#include "field_type.h"
+#include "game.h"
+#include "game_init_helpers.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "options.h"
+#include "path_info.h"
+#include "point.h"
+#include "rng.h"
+#include "string_formatter.h"
+#include "turn_profiler.h"
+#include "type_id.h"
+#include "vehicle.h"
+#include "worldfactory.h"
+
+namespace
+{
+
+struct bench_config {
+    int turns = 1000;
+    unsigned int seed = 42;
+    int monsters = 300;
+    int fires = 20;
+    int vehicles = 4;
+    std::string monster_type = "mon_zombie";
+    std::string world;
+    std::string report;
+};
+
+int extract_int( std::vector<const char *> &arg_vec, const std::string &tag, int def )
+{
+    const std::string value = extract_argument( arg_vec, tag );
+    return value.empty() ? def : std::atoi( value.c_str() );
+}
+
+bench_config extract_bench_config( std::vector<const char *> &arg_vec )
+{
+    bench_config cfg;
+    cfg.turns = extract_int( arg_vec, "--turns=", cfg.turns );
+    cfg.seed = static_cast<unsigned int>( extract_int( arg_vec, "--seed=", cfg.seed ) );
+    cfg.monsters = extract_int( arg_vec, "--monsters=", cfg.monsters );
+    cfg.fires = extract_int( arg_vec, "--fires=", cfg.fires );
+    cfg.vehicles = extract_int( arg_vec, "--vehicles=", cfg.vehicles );
+    const std::string monster_type = extract_argument( arg_vec, "--monster=" );
+    if( !monster_type.empty() ) {
+        cfg.monster_type = monster_type;
+    }
+    cfg.world = extract_argument( arg_vec, "--world=" );
+    cfg.report = extract_argument( arg_vec, "--report=" );
+    return cfg;
+}
+
+void print_usage()
+{
+    cata_printf( "Usage: cata_bench [options]\n" );
+    cata_printf( "  --turns=<n>                  Number of turns to simulate (default 1000).\n" );
+    cata_printf( "  --seed=<n>                   RNG seed for fixture and simulation (default 42).\n" );
+    cata_printf( "  --world=<name>               Load the first save of a world from the user dir\n" );
+    cata_printf( "                               instead of generating a fixture.\n" );
+    cata_printf( "  --monsters=<n>               Fixture: monsters around the player (default 300).\n" );
+    cata_printf( "  --monster=<id>               Fixture: monster type (default mon_zombie).\n" );
+    cata_printf( "  --fires=<n>                  Fixture: fires around the player (default 20).\n" );
+    cata_printf( "  --vehicles=<n>               Fixture: moving vehicles (default 4).\n" );
+    cata_printf( "  --report=<prefix>            Write <prefix>.json and <prefix>.csv turn profiles.\n" );
+    cata_printf( "  --mods=<mod1,mod2,…>         Loads the list of mods for the fixture world.\n" );
+    cata_printf( "  --user-dir=<dir>             Set user dir (default ./test_user_dir/).\n" );
+    cata_printf( "  --option_overrides=n:v[,…]   Name-value pairs of game options.\n" );
+}
+
+tripoint random_point_near( const tripoint &center, int radius )
+{
+    return center + point( rng( -radius, radius ), rng( -radius, radius ) );
+}
+
+void build_fixture( const bench_config &cfg )
+{
+    map &here = get_map();
+    avatar &you = get_avatar();
+
+    // Open ground, so that the vehicles have room to drive
+    clear_map();
+    const tripoint center( MAPSIZE_X / 2, MAPSIZE_Y / 2, 0 );
+    you.setpos( center );
+
+    int placed = 0;
+    for( int attempts = 0; placed < cfg.monsters && attempts < cfg.monsters * 20; attempts++ ) {
+        const tripoint p = random_point_near( center, 30 );
+        if( rl_dist( p, center ) < 5 ) {
+            continue;
+        }
+        if( g->place_critter_at( mtype_id( cfg.monster_type ), p ) != nullptr ) {
+            placed++;
+        }
+    }
+
+    for( int i = 0; i < cfg.fires; i++ ) {
+        here.add_field( random_point_near( center, 25 ), fd_fire, 3 );
+    }
+
+    int moving = 0;
+    for( int i = 0; i < cfg.vehicles; i++ ) {
+        const tripoint p = center + point( -40 + 20 * ( i % 5 ), ( i % 2 == 0 ? -15 : 15 ) );
+        vehicle *veh = here.add_vehicle( vproto_id( "car" ), p, 90 * ( i % 4 ), 100, 0, false );
+        if( veh == nullptr ) {
+            continue;
+        }
+        veh->engine_on = true;
+        veh->cruise_velocity = 2000;
+        veh->velocity = 2000;
+        moving++;
+    }
+    here.invalidate_map_cache( center.z );
+
+    cata_printf( "Fixture: %d monsters, %d fires, %d moving vehicles\n", placed, cfg.fires, moving );
+}
+
+void run_turns( const bench_config &cfg )
+{
+    avatar &you = get_avatar();
+
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+    const auto start = std::chrono::steady_clock::now();
+    int done = 0;
+    for( ; done < cfg.turns; done++ ) {
+        // The player only waits, so do_turn never asks for input.
+        you.moves = 0;
+        you.set_all_parts_hp_to_max();
+        if( g->do_turn() ) {
+            break;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    turn_profiler::set_enabled( false );
+
+    const double seconds = std::chrono::duration<double>( end - start ).count();
+    cata_printf( "\n%d turns in %.3f s: %.2f turns/sec\n\n", done, seconds,
+                 seconds > 0 ? done / seconds : 0.0 );
+    cata_printf( "%-14s %8s %10s %8s %8s %8s\n", "phase", "calls", "total_ms", "p50_ms", "p99_ms",
+                 "max_ms" );
+    for( int i = 0; i < turn_profiler::num_phases; i++ ) {
+        const turn_profiler::phase p = static_cast<turn_profiler::phase>( i );
+        const turn_profiler::phase_stats stats = turn_profiler::get_stats( p );
+        cata_printf( "%-14s %8lld %10.2f %8.3f %8.3f %8.3f\n", turn_profiler::phase_name( p ),
+                     static_cast<long long>( stats.calls ), stats.total_ms, stats.p50_ms, stats.p99_ms,
+                     stats.max_ms );
+    }
+    if( done > turn_profiler::history_size ) {
+        cata_printf( "(statistics cover the last %d turns)\n", turn_profiler::history_size );
+    }
+
+    if( !cfg.report.empty() ) {
+        turn_profiler::write_report( cfg.report + ".json", cfg.report + ".csv" );
+    }
+}
+
+} // namespace
+
+int main( int argc, const char *argv[] )
+{
+    std::vector<const char *> arg_vec( argv, argv + argc );
+    if( check_remove_flags( arg_vec, { "-h", "--help" } ) ) {
+        print_usage();
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<mod_id> mods = extract_mod_selection( arg_vec );
+    if( std::find( mods.begin(), mods.end(), mod_id( "dda" ) ) == mods.end() ) {
+        mods.insert( mods.begin(), mod_id( "dda" ) );
+    }
+    option_overrides_t option_overrides = extract_option_overrides( arg_vec );
+    const std::string user_dir = extract_user_dir( arg_vec );
+    const bench_config cfg = extract_bench_config( arg_vec );
+    if( arg_vec.size() > 1 ) {
+        cata_print_stderr( string_format( "Unknown argument: %s\n", arg_vec[1] ) );
+        print_usage();
+        return EXIT_FAILURE;
+    }
+
+    test_mode = true;
+    setupDebug( DebugOutput::std_err );
+    rng_set_engine_seed( cfg.seed );
+
+    std::string fixture_world;
+    try {
+        init_global_game_state( mods, option_overrides, user_dir );
+        fixture_world = world_generator->active_world->world_name;
+        if( !cfg.world.empty() && !g->load( cfg.world ) ) {
+            cata_print_stderr( string_format( "Cannot load world \"%s\"\n", cfg.world ) );
+            return EXIT_FAILURE;
+        }
+    } catch( const std::exception &err ) {
+        cata_print_stderr( string_format( "Terminated: %s\n", err.what() ) );
+        return EXIT_FAILURE;
+    }
+
+    // Autosaving would measure disk speed rather than simulation.
+    get_options().get_option( "AUTOSAVE" ).setValue( "false" );
+
+    // Reseed so the simulation does not depend on how much randomness
+    // loading consumed.
+    rng_set_engine_seed( cfg.seed );
+    if( cfg.world.empty() ) {
+        build_fixture( cfg );
+    }
+    rng_set_engine_seed( cfg.seed );
+
+    run_turns( cfg );
+
+    world_generator->delete_world( fixture_world, true );
+
+    return debug_has_error_been_observed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "avatar.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_utility.h"
 #include "catch/catch.hpp"
@@ -17,6 +18,7 @@
 #include "crafting.h"
 #include "distribution_grid.h"
 #include "game.h"
+#include "inventory.h"
 #include "item.h"
 #include "itype.h"
 #include "map.h"
@@ -30,12 +32,11 @@
 #include "recipe.h"
 #include "recipe_dictionary.h"
 #include "requirements.h"
+#include "rng.h"
 #include "string_id.h"
 #include "type_id.h"
 #include "value_ptr.h"
 
-class inventory;
-
 static const trait_id trait_DEBUG_HS( "DEBUG_HS" );
 static const trait_id trait_DEBUG_STORAGE( "DEBUG_STORAGE" );
 
@@ -699,3 +700,159 @@ TEST_CASE( "tool selection ui", "[crafting][ui]" )
         }
     }
 }
+
+// A well stocked base: lots of items, some of them stacking
+static std::vector<tripoint> stock_nearby_items( const tripoint &origin, int items_per_tile )
+{
+    const std::vector<itype_id> types = {
+        itype_id( "rock" ), itype_id( "2x4" ), itype_id( "nail" ), itype_id( "scrap" ),
+        itype_id( "hammer" ), itype_id( "pot" ), itype_id( "rag" ), itype_id( "pipe" )
+    };
+    map &here = get_map();
+    std::vector<tripoint> pts;
+    for( int dx = -PICKUP_RANGE; dx <= PICKUP_RANGE; dx++ ) {
+        for( int dy = -PICKUP_RANGE; dy <= PICKUP_RANGE; dy++ ) {
+            const tripoint p = origin + point( dx, dy );
+            for( int i = 0; i < items_per_tile; i++ ) {
+                item it( random_entry( types ), calendar::start_of_cataclysm );
+                if( one_in( 4 ) ) {
+                    // Doesn't stack with the others of its type
+                    it.set_var( "test_mark", i );
+                }
+                here.add_item( p, it );
+            }
+            pts.push_back( p );
+        }
+    }
+    return pts;
+}
+
+TEST_CASE( "inventory_from_map_stacks_like_adding_items_one_by_one", "[crafting][inventory]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint origin( 60, 60, 0 );
+    const std::vector<tripoint> pts = stock_nearby_items( origin, 10 );
+
+    inventory from_map;
+    from_map.form_from_map( here, pts, nullptr, false );
+
+    inventory expected;
+    for( const tripoint &p : pts ) {
+        for( const item &it : here.i_at( p ) ) {
+            expected.add_item( it, false, false );
+        }
+    }
+
+    REQUIRE( from_map.size() == expected.size() );
+    for( size_t i = 0; i < expected.size(); i++ ) {
+        const std::list<item> &stack = from_map.const_stack( i );
+        const std::list<item> &expected_stack = expected.const_stack( i );
+        CAPTURE( i );
+        CHECK( stack.front().typeId() == expected_stack.front().typeId() );
+        CHECK( stack.size() == expected_stack.size() );
+        CHECK( stack.front().charges == expected_stack.front().charges );
+    }
+}
+
+// Every stack counts as many times as it has items, as in visitable<inventory>::has_quality
+static int count_with_quality( const inventory &inv, const quality_id &qual, int level )
+{
+    int count = 0;
+    for( size_t i = 0; i < inv.size(); i++ ) {
+        const std::list<item> &stack = inv.const_stack( i );
+        int in_front = 0;
+        stack.front().visit_items( [&]( const item * e ) {
+            if( e->get_quality( qual ) >= level ) {
+                in_front += e->count();
+            }
+            return VisitResponse::NEXT;
+        } );
+        count += stack.size() * in_front;
+    }
+    return count;
+}
+
+TEST_CASE( "inventory_quality_bins_match_visiting_every_item", "[crafting][inventory]" )
+{
+    clear_map();
+    const tripoint origin( 60, 60, 0 );
+    const std::vector<tripoint> pts = stock_nearby_items( origin, 3 );
+    inventory inv;
+    inv.form_from_map( get_map(), pts, nullptr, false );
+
+    const auto check_qualities = [&inv]() {
+        for( const char *name : {
+                 "HAMMER", "HAMMER_FINE", "PRY", "BOIL", "CONTAIN", "SAW_M", "CUT"
+             } ) {
+            const quality_id qual( name );
+            int max_level = INT_MIN;
+            inv.visit_items( [&]( const item * e ) {
+                max_level = std::max( max_level, e->get_quality( qual ) );
+                return VisitResponse::NEXT;
+            } );
+            CAPTURE( qual.str() );
+            CHECK( inv.max_quality( qual ) == max_level );
+            for( int level = 1; level <= 3; level++ ) {
+                const int count = count_with_quality( inv, qual, level );
+                CAPTURE( level, count );
+                if( count > 0 ) {
+                    CHECK( inv.has_quality( qual, level, count ) );
+                }
+                CHECK_FALSE( inv.has_quality( qual, level, count + 1 ) );
+            }
+        }
+    };
+    check_qualities();
+
+    // The bins follow items being added and removed
+    item saw( "hacksaw" );
+    saw.put_in( item( "hammer" ) );
+    inv.add_item( saw );
+    CHECK( inv.has_quality( quality_id( "SAW_M" ) ) );
+    check_qualities();
+    inv.remove_items_with( []( const item & it ) {
+        return it.typeId() == itype_id( "hammer" ) || it.typeId() == itype_id( "hacksaw" );
+    } );
+    CHECK_FALSE( inv.has_quality( quality_id( "SAW_M" ) ) );
+    check_qualities();
+}
+
+TEST_CASE( "inventory_from_map_benchmark", "[.][crafting][inventory][benchmark]" )
+{
+    clear_map();
+    const tripoint origin( 60, 60, 0 );
+    const std::vector<tripoint> pts = stock_nearby_items( origin, 30 );
+
+    BENCHMARK( "form_from_map" ) {
+        inventory inv;
+        inv.form_from_map( get_map(), pts, nullptr, false );
+        return inv.size();
+    };
+    {
+        inventory inv;
+        inv.form_from_map( get_map(), pts, nullptr, false );
+        // What the crafting GUI checks for every recipe it lists
+        BENCHMARK( "can_make_every_recipe" ) {
+            int craftable = 0;
+            for( const auto &e : recipe_dict ) {
+                const recipe &r = e.second;
+                if( !r.result().is_valid() ) {
+                    continue;
+                }
+                craftable += r.deduped_requirements().can_make_with_inventory( inv,
+                             r.get_component_filter(), 1, cost_adjustment::start_only ) ? 1 : 0;
+            }
+            return craftable;
+        };
+    }
+    // The whole rebuild done when the crafting GUI opens
+    avatar &u = get_avatar();
+    clear_avatar();
+    u.setpos( origin );
+    BENCHMARK( "crafting_inventory" ) {
+        u.invalidate_crafting_inventory();
+        return u.crafting_inventory().size();
+    };
+    clear_map();
+}
@@ -1,3 +1,6 @@
+#include <memory>
+#include <vector>
+
 #include "catch/catch.hpp"
 
 #include "magic.h"
@@ -5,6 +8,7 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "item.h"
+#include "npc.h"
 #include "options.h"
 #include "player.h"
 #include "player_helpers.h"
@@ -554,3 +558,74 @@ TEST_CASE( "Mana pool", "[magic][enchantment][mana][bionic]" )
         tests_mana_pool_section( it );
     }
 }
+
+TEST_CASE( "Enchantment cache follows its sources", "[magic][enchantment]" )
+{
+    clear_map();
+    Character &guy = get_player_character();
+    clear_character( *guy.as_player(), true );
+    guy.recalculate_enchantment_cache();
+
+    const auto speed_bonus = [&]() {
+        return guy.bonus_from_enchantments( 100, enchant_vals::mod::SPEED );
+    };
+    REQUIRE( speed_bonus() == 0 );
+
+    give_item( guy, "test_relic_mods_speed" );
+    CHECK( speed_bonus() == -25 );
+    guy.recalculate_enchantment_cache();
+    CHECK( speed_bonus() == -25 );
+
+    // Replaced by an item without enchantments, possibly at the same address
+    guy.inv.clear();
+    guy.i_add( item( "test_relic_base" ) );
+    guy.recalculate_enchantment_cache();
+    CHECK( speed_bonus() == 0 );
+
+    guy.inv.clear();
+    give_item( guy, "test_relic_mods_speed" );
+    give_item( guy, "test_relic_mods_speed" );
+    CHECK( speed_bonus() == -50 );
+
+    // Wielding it keeps it held
+    guy.wield( guy.i_at( guy.inv.position_by_type( itype_id( "test_relic_mods_speed" ) ) ) );
+    guy.recalculate_enchantment_cache();
+    CHECK( speed_bonus() == -50 );
+
+    clear_items( guy );
+    guy.remove_weapon();
+    guy.recalculate_enchantment_cache();
+    CHECK( speed_bonus() == 0 );
+}
+
+TEST_CASE( "Enchantment cache benchmark", "[.][magic][enchantment][benchmark]" )
+{
+    clear_map();
+    std::vector<std::unique_ptr<standard_npc>> party;
+    for( int i = 0; i < 8; ++i ) {
+        party.push_back( std::make_unique<standard_npc>( "packer", tripoint( 10 + i, 10, 0 ) ) );
+        standard_npc &packer = *party.back();
+        for( int j = 0; j < 200; ++j ) {
+            packer.inv.add_item( item( "rock" ) );
+        }
+        packer.inv.add_item( item( "test_relic_mods_speed" ) );
+        packer.inv.add_item( item( "test_relic_mods_stats" ) );
+        packer.recalculate_enchantment_cache();
+    }
+
+    BENCHMARK( "turn without changes" ) {
+        for( std::unique_ptr<standard_npc> &packer : party ) {
+            packer->recalculate_enchantment_cache();
+        }
+        return party.front()->bonus_from_enchantments( 100, enchant_vals::mod::SPEED );
+    };
+    BENCHMARK( "turn with a relic picked up" ) {
+        for( std::unique_ptr<standard_npc> &packer : party ) {
+            packer->inv.add_item( item( "test_relic_mods_speed" ) );
+            packer->recalculate_enchantment_cache();
+            packer->inv.remove_item( &packer->inv.find_item( packer->inv.position_by_type(
+                                         itype_id( "test_relic_mods_speed" ) ) ) );
+        }
+        return party.front()->bonus_from_enchantments( 100, enchant_vals::mod::SPEED );
+    };
+}
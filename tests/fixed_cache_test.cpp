@@ -0,0 +1,99 @@
+#include <cstdint>
+
+#include "catch/catch.hpp"
+#include "fixed_cache.h"
+#include "lru_cache.h"
+#include "point.h"
+
+TEST_CASE( "fixed_cache_stores_and_forgets_values", "[fixed_cache]" )
+{
+    fixed_cache<int> cache( 10 );
+    CHECK( cache.capacity() == 1024 );
+    CHECK( cache.find( 5 ) == nullptr );
+    CHECK( cache.get( 5, -1 ) == -1 );
+
+    cache.insert( 5, 50 );
+    cache.insert( 6, 60 );
+    cache.insert( 5, 55 );
+    CHECK( cache.get( 5, -1 ) == 55 );
+    CHECK( cache.get( 6, -1 ) == 60 );
+    CHECK( cache.get( 7, -1 ) == -1 );
+
+    SECTION( "clearing drops everything" ) {
+        cache.clear();
+        CHECK( cache.get( 5, -1 ) == -1 );
+        CHECK( cache.get( 6, -1 ) == -1 );
+        cache.insert( 6, 61 );
+        CHECK( cache.get( 6, -1 ) == 61 );
+    }
+
+    SECTION( "entries older than a stamp are ignored" ) {
+        const std::uint32_t stamp = cache.advance();
+        cache.insert( 6, 61 );
+        CHECK( cache.get( 5, -1, stamp ) == -1 );
+        CHECK( cache.get( 6, -1, stamp ) == 61 );
+        // Without a stamp the old entries are still there
+        CHECK( cache.get( 5, -1 ) == 55 );
+    }
+
+    SECTION( "a full cache keeps most recent entries" ) {
+        for( std::uint64_t key = 0; key < 100000; ++key ) {
+            cache.insert( key, static_cast<int>( key ) );
+        }
+        int found = 0;
+        for( std::uint64_t key = 0; key < 100000; ++key ) {
+            const int *value = cache.find( key );
+            if( value != nullptr ) {
+                REQUIRE( *value == static_cast<int>( key ) );
+                ++found;
+            }
+        }
+        CHECK( found <= 1024 );
+        CHECK( found > 512 );
+    }
+}
+
+static std::uint64_t pack_line( const point &from, const point &to )
+{
+    return static_cast<std::uint64_t>( from.x << 16 | from.y ) << 32 |
+           static_cast<std::uint32_t>( to.x << 16 | to.y );
+}
+
+TEST_CASE( "fixed_cache_benchmark", "[.][fixed_cache][benchmark]" )
+{
+    // Lines from monsters around the player, like map::sees is asked for
+    lru_cache<point, char> old_cache;
+    fixed_cache<char> new_cache( 17 );
+    const point player( 66, 66 );
+
+    BENCHMARK( "lru_cache" ) {
+        int visible = 0;
+        for( int x = 6; x < 126; x += 2 ) {
+            for( int y = 6; y < 126; y += 2 ) {
+                const point key( x << 16 | y, player.x << 16 | player.y );
+                char cached = old_cache.get( key, -1 );
+                if( cached < 0 ) {
+                    cached = ( x + y ) % 3 != 0;
+                    old_cache.insert( 100000, key, cached );
+                }
+                visible += cached;
+            }
+        }
+        return visible;
+    };
+    BENCHMARK( "fixed_cache" ) {
+        int visible = 0;
+        for( int x = 6; x < 126; x += 2 ) {
+            for( int y = 6; y < 126; y += 2 ) {
+                const std::uint64_t key = pack_line( point( x, y ), player );
+                char cached = new_cache.get( key, -1 );
+                if( cached < 0 ) {
+                    cached = ( x + y ) % 3 != 0;
+                    new_cache.insert( key, cached );
+                }
+                visible += cached;
+            }
+        }
+        return visible;
+    };
+}
@@ -0,0 +1,201 @@
+#include "game_init_helpers.h"
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "avatar.h"
+#include "calendar.h"
+#include "color.h"
+#include "debug.h"
+#include "distribution_grid.h"
+#include "filesystem.h"
+#include "game.h"
+#include "language.h"
+#include "loading_ui.h"
+#include "map.h"
+#include "options.h"
+#include "overmap.h"
+#include "overmapbuffer.h"
+#include "path_info.h"
+#include "pldata.h"
+#include "point.h"
+#include "string_utils.h"
+#include "type_id.h"
+#include "weather.h"
+#include "worldfactory.h"
+
+std::string extract_argument( std::vector<const char *> &arg_vec, const std::string &tag )
+{
+    std::string arg_rest;
+    for( auto iter = arg_vec.begin(); iter != arg_vec.end(); iter++ ) {
+        if( strncmp( *iter, tag.c_str(), tag.length() ) == 0 ) {
+            arg_rest = std::string( &( *iter )[tag.length()] );
+            arg_vec.erase( iter );
+            break;
+        }
+    }
+    return arg_rest;
+}
+
+std::vector<mod_id> extract_mod_selection( std::vector<const char *> &arg_vec )
+{
+    std::string mod_string = extract_argument( arg_vec, "--mods=" );
+
+    std::vector<std::string> mod_names = string_split( mod_string, ',' );
+    std::vector<mod_id> ret;
+    for( const std::string &mod_name : mod_names ) {
+        if( !mod_name.empty() ) {
+            ret.emplace_back( mod_name );
+        }
+    }
+    // Always load test data mod
+    ret.emplace_back( "test_data" );
+
+    return ret;
+}
+
+void init_global_game_state( const std::vector<mod_id> &mods,
+                                    option_overrides_t &option_overrides,
+                                    const std::string &user_dir )
+{
+    if( !assure_dir_exist( user_dir ) ) {
+        assert( !"Unable to make user_dir directory.  Check permissions." );
+    }
+
+    PATH_INFO::init_base_path( "" );
+    PATH_INFO::init_user_dir( user_dir );
+    PATH_INFO::set_standard_filenames();
+
+    if( !assure_dir_exist( PATH_INFO::config_dir() ) ) {
+        assert( !"Unable to make config directory.  Check permissions." );
+    }
+
+    if( !assure_dir_exist( PATH_INFO::savedir() ) ) {
+        assert( !"Unable to make save directory.  Check permissions." );
+    }
+
+    if( !assure_dir_exist( PATH_INFO::templatedir() ) ) {
+        assert( !"Unable to make templates directory.  Check permissions." );
+    }
+
+    if( !init_language_system() ) {
+        DebugLog( DL::Error, DC::Main ) << "Failed to init language system.";
+    }
+
+    get_options().init();
+    get_options().load();
+
+    // Apply command-line option overrides for test suite execution.
+    if( !option_overrides.empty() ) {
+        for( const name_value_pair_t &option : option_overrides ) {
+            if( get_options().has_option( option.first ) ) {
+                options_manager::cOpt &opt = get_options().get_option( option.first );
+                opt.setValue( option.second );
+            }
+        }
+    }
+    init_colors();
+
+    g = std::make_unique<game>( );
+    g->new_game = true;
+    g->load_static_data();
+
+    world_generator->set_active_world( nullptr );
+    world_generator->init();
+    WORLDPTR test_world = world_generator->make_new_world( mods );
+    assert( test_world != nullptr );
+    world_generator->set_active_world( test_world );
+    assert( world_generator->active_world != nullptr );
+
+    calendar::set_eternal_season( get_option<bool>( "ETERNAL_SEASON" ) );
+    calendar::set_season_length( get_option<int>( "SEASON_LENGTH" ) );
+
+    loading_ui ui( false );
+    g->load_core_data( ui );
+    g->load_world_modfiles( ui );
+
+    g->u = avatar();
+    g->u.create( character_type::NOW );
+
+    g->m = map( get_option<bool>( "ZLEVELS" ) );
+
+    overmap_special_batch empty_specials( point_abs_om{} );
+    overmap_buffer.create_custom_overmap( point_abs_om{}, empty_specials );
+
+    g->m.load( tripoint( g->get_levx(), g->get_levy(), g->get_levz() ), false );
+    get_distribution_grid_tracker().load( g->m );
+
+    get_weather().update_weather();
+}
+
+bool check_remove_flags( std::vector<const char *> &cont,
+                                const std::vector<const char *> &flags )
+{
+    bool has_any = false;
+    auto iter = flags.begin();
+    while( iter != flags.end() ) {
+        auto found = std::find_if( cont.begin(), cont.end(),
+        [iter]( const char *c ) {
+            return strcmp( c, *iter ) == 0;
+        } );
+        if( found == cont.end() ) {
+            iter++;
+        } else {
+            cont.erase( found );
+            has_any = true;
+        }
+    }
+
+    return has_any;
+}
+
+// Split s on separator sep, returning parts as a pair. Returns empty string as
+// second value if no separator found.
+static name_value_pair_t split_pair( const std::string &s, const char sep )
+{
+    const size_t pos = s.find( sep );
+    if( pos != std::string::npos ) {
+        return name_value_pair_t( s.substr( 0, pos ), s.substr( pos + 1 ) );
+    } else {
+        return name_value_pair_t( s, "" );
+    }
+}
+
+option_overrides_t extract_option_overrides( std::vector<const char *> &arg_vec )
+{
+    option_overrides_t ret;
+    std::string option_overrides_string = extract_argument( arg_vec, "--option_overrides=" );
+    if( option_overrides_string.empty() ) {
+        return ret;
+    }
+    const char delim = ',';
+    const char sep = ':';
+    size_t i = 0;
+    size_t pos = option_overrides_string.find( delim );
+    while( pos != std::string::npos ) {
+        std::string part = option_overrides_string.substr( i, pos );
+        ret.emplace_back( split_pair( part, sep ) );
+        i = ++pos;
+        pos = option_overrides_string.find( delim, pos );
+    }
+    // Handle last part
+    const std::string part = option_overrides_string.substr( i );
+    ret.emplace_back( split_pair( part, sep ) );
+    return ret;
+}
+
+std::string extract_user_dir( std::vector<const char *> &arg_vec )
+{
+    std::string option_user_dir = extract_argument( arg_vec, "--user-dir=" );
+    if( option_user_dir.empty() ) {
+        return "./test_user_dir/";
+    }
+    if( !string_ends_with( option_user_dir, "/" ) ) {
+        option_user_dir += "/";
+    }
+    return option_user_dir;
+}
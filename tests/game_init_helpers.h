@@ -0,0 +1,34 @@
+#pragma once
+#ifndef CATA_TESTS_GAME_INIT_HELPERS_H
+#define CATA_TESTS_GAME_INIT_HELPERS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "type_id.h"
+
+// Shared start-up code of the executables built from the test tree
+// (cata_test and cata_bench).
+
+using name_value_pair_t = std::pair<std::string, std::string>;
+using option_overrides_t = std::vector<name_value_pair_t>;
+
+// If tag is found as a prefix of any argument in arg_vec, the argument is
+// removed from arg_vec and the argument suffix after tag is returned.
+// Otherwise, an empty string is returned and arg_vec is unchanged.
+std::string extract_argument( std::vector<const char *> &arg_vec, const std::string &tag );
+std::vector<mod_id> extract_mod_selection( std::vector<const char *> &arg_vec );
+option_overrides_t extract_option_overrides( std::vector<const char *> &arg_vec );
+std::string extract_user_dir( std::vector<const char *> &arg_vec );
+// Checks if any of the flags are in container, removes them all
+bool check_remove_flags( std::vector<const char *> &cont,
+                         const std::vector<const char *> &flags );
+
+// Loads game data, creates a fresh world with the given mods and loads the
+// map around the origin of the first overmap.
+void init_global_game_state( const std::vector<mod_id> &mods,
+                             option_overrides_t &option_overrides,
+                             const std::string &user_dir );
+
+#endif // CATA_TESTS_GAME_INIT_HELPERS_H
@@ -0,0 +1,156 @@
+#include <cstdlib>
+#include <vector>
+
+#include "cached_options.h"
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "field.h"
+#include "field_type.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "type_id.h"
+
+// A thick smoke cloud across the corners of four submaps
+static void fill_with_smoke( const point &center, int radius )
+{
+    map &here = get_map();
+    for( int x = center.x - radius; x <= center.x + radius; x++ ) {
+        for( int y = center.y - radius; y <= center.y + radius; y++ ) {
+            here.add_field( tripoint( x, y, 0 ), fd_smoke, 3, 1_turns );
+        }
+    }
+}
+
+static std::vector<int> smoke_intensities()
+{
+    map &here = get_map();
+    std::vector<int> ret;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const field_entry *smoke = here.field_at( tripoint( x, y, 0 ) ).find_field( fd_smoke );
+            ret.push_back( smoke == nullptr ? 0 : smoke->get_field_intensity() );
+        }
+    }
+    return ret;
+}
+
+static std::vector<int> simulate_smoke( bool parallel, int turns )
+{
+    clear_map();
+    // Gas left over on other levels by earlier tests would sink into this one
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        clear_fields( z );
+    }
+    const point center( 5 * SEEX, 5 * SEEY );
+    fill_with_smoke( center, 6 );
+    const bool old_parallel = parallel_fields;
+    parallel_fields = parallel;
+    for( int i = 0; i < turns; i++ ) {
+        get_map().process_fields();
+        calendar::turn += 1_turns;
+    }
+    parallel_fields = old_parallel;
+    return smoke_intensities();
+}
+
+TEST_CASE( "parallel_field_processing_is_reproducible", "[field][worker_pool]" )
+{
+    const time_point start = calendar::turn;
+    const std::vector<int> first = simulate_smoke( true, 10 );
+    calendar::turn = start;
+    const std::vector<int> second = simulate_smoke( true, 10 );
+    calendar::turn = start;
+    CHECK( first == second );
+
+    // The smoke still spreads out of the area it started in
+    int outside = 0;
+    for( int i = 0; i < static_cast<int>( first.size() ); i++ ) {
+        const point p( i / MAPSIZE_Y, i % MAPSIZE_Y );
+        const point offset = p - point( 5 * SEEX, 5 * SEEY );
+        if( first[i] > 0 && ( std::abs( offset.x ) > 6 || std::abs( offset.y ) > 6 ) ) {
+            outside++;
+        }
+    }
+    CHECK( outside > 0 );
+    clear_fields( 0 );
+}
+
+// Fires on a wooden floor across the corners of four submaps
+static std::vector<int> simulate_fire( bool parallel, int turns )
+{
+    clear_map();
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        clear_fields( z );
+    }
+    map &here = get_map();
+    const point center( 5 * SEEX, 5 * SEEY );
+    for( int x = center.x - 8; x <= center.x + 8; x++ ) {
+        for( int y = center.y - 8; y <= center.y + 8; y++ ) {
+            here.ter_set( tripoint( x, y, 0 ), ter_id( "t_floor_primitive" ) );
+        }
+    }
+    for( const point &offset : {
+             point_zero, point( -3, -3 ), point( 3, 3 )
+         } ) {
+        here.add_field( tripoint( center + offset, 0 ), fd_fire, 3, 1_turns );
+    }
+    const bool old_parallel = parallel_fields;
+    parallel_fields = parallel;
+    for( int i = 0; i < turns; i++ ) {
+        here.process_fields();
+        calendar::turn += 1_turns;
+    }
+    parallel_fields = old_parallel;
+    std::vector<int> ret;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const field_entry *fire = here.field_at( tripoint( x, y, 0 ) ).find_field( fd_fire );
+            ret.push_back( fire == nullptr ? 0 : fire->get_field_intensity() );
+        }
+    }
+    return ret;
+}
+
+TEST_CASE( "parallel_fire_spreading_is_reproducible", "[field][worker_pool]" )
+{
+    const time_point start = calendar::turn;
+    const std::vector<int> first = simulate_fire( true, 10 );
+    calendar::turn = start;
+    const std::vector<int> second = simulate_fire( true, 10 );
+    calendar::turn = start;
+    CHECK( first == second );
+
+    // Planned spreading still sets the floor around the fires alight
+    int burning = 0;
+    for( const int intensity : first ) {
+        burning += intensity > 0 ? 1 : 0;
+    }
+    CHECK( burning > 3 );
+    clear_map();
+    clear_fields( 0 );
+}
+
+TEST_CASE( "field_processing_benchmark", "[.][field][benchmark]" )
+{
+    const time_point start = calendar::turn;
+    BENCHMARK( "smoke cloud, serial" ) {
+        calendar::turn = start;
+        return simulate_smoke( false, 5 ).size();
+    };
+    BENCHMARK( "smoke cloud, parallel" ) {
+        calendar::turn = start;
+        return simulate_smoke( true, 5 ).size();
+    };
+    BENCHMARK( "fires, serial" ) {
+        calendar::turn = start;
+        return simulate_fire( false, 5 ).size();
+    };
+    BENCHMARK( "fires, parallel" ) {
+        calendar::turn = start;
+        return simulate_fire( true, 5 ).size();
+    };
+    calendar::turn = start;
+    clear_fields( 0 );
+}
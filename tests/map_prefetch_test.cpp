@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "coordinate_conversions.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_prefetch.h"
+#include "mapbuffer.h"
+#include "point.h"
+
+static bool has_quad( const std::vector<tripoint> &quads, const tripoint &quad )
+{
+    return std::find( quads.begin(), quads.end(), quad ) != quads.end();
+}
+
+TEST_CASE( "map_prefetcher_predicts_quads_ahead", "[map][prefetch]" )
+{
+    const tripoint abs_sub( 100, 200, 0 );
+
+    CHECK( map_prefetcher::predict_quads( abs_sub, point_zero, 0, 0 ).empty() );
+
+    SECTION( "walking east prefetches the next column" ) {
+        const std::vector<tripoint> quads = map_prefetcher::predict_quads( abs_sub, point_east, 0, 0 );
+        // One new column of submaps, at most one quad per two submaps along it
+        CHECK( quads.size() <= MAPSIZE / 2 + 1 );
+        const int next_column = abs_sub.x + MAPSIZE;
+        for( int y = abs_sub.y; y < abs_sub.y + MAPSIZE; ++y ) {
+            CHECK( has_quad( quads, sm_to_omt_copy( tripoint( next_column, y, 0 ) ) ) );
+        }
+        for( const tripoint &quad : quads ) {
+            CHECK( omt_to_sm_copy( quad ).x + 1 >= next_column );
+        }
+    }
+    SECTION( "driving fast prefetches further ahead" ) {
+        const point velocity( 0, -4 * SEEY );
+        const std::vector<tripoint> quads = map_prefetcher::predict_quads( abs_sub, velocity, 0, 0 );
+        CHECK( has_quad( quads, sm_to_omt_copy( abs_sub + tripoint( 0, -MAPSIZE, 0 ) ) ) );
+        CHECK_FALSE( has_quad( quads, sm_to_omt_copy( abs_sub + tripoint( 0, MAPSIZE, 0 ) ) ) );
+    }
+    SECTION( "all requested z-levels are covered" ) {
+        const std::vector<tripoint> quads = map_prefetcher::predict_quads( abs_sub, point_south, -2,
+                                            1 );
+        for( int z = -2; z <= 1; ++z ) {
+            CHECK( has_quad( quads, sm_to_omt_copy( tripoint( abs_sub.x, abs_sub.y + MAPSIZE, z ) ) ) );
+        }
+    }
+}
+
+TEST_CASE( "generating_a_quad_ahead_fills_the_buffer", "[map][prefetch]" )
+{
+    // A quad well outside the reality bubble that is not loaded yet
+    const tripoint quad_sm = omt_to_sm_copy( sm_to_omt_copy( get_map().get_abs_sub() +
+                             tripoint( 4 * MAPSIZE, 4 * MAPSIZE, 0 ) ) );
+    REQUIRE_FALSE( MAPBUFFER.is_submap_loaded( quad_sm ) );
+
+    map::generate_quad( quad_sm + point_south_east );
+
+    for( const point &offset : {
+             point_zero, point_east, point_south, point_south_east
+         } ) {
+        CHECK( MAPBUFFER.is_submap_loaded( quad_sm + offset ) );
+    }
+}
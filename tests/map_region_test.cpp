@@ -0,0 +1,108 @@
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "game.h"
+#include "map_region.h"
+#include "point.h"
+
+static std::string quad_data( char fill, size_t size )
+{
+    std::string ret( size, fill );
+    // Something that differs between positions within a sector
+    for( size_t i = 0; i < size; i += 97 ) {
+        ret[i] = static_cast<char>( i / 97 );
+    }
+    return ret;
+}
+
+TEST_CASE( "map_region_stores_quads", "[map_region]" )
+{
+    const std::string dir = g->get_world_base_save_path() + "/region_test_" + get_pid_string();
+    REQUIRE( assure_dir_exist( dir ) );
+    const std::string path = dir + "/0.0.0.region";
+
+    const point a( 0, 0 );
+    const point b( map_region::size - 1, map_region::size - 1 );
+    const point c( 3, 4 );
+    const std::string data_a = quad_data( 'a', 5000 );
+    const std::string data_b = quad_data( 'b', 10 );
+    {
+        map_region region( path );
+        CHECK_FALSE( region.contains( a ) );
+        CHECK( region.read( a ).empty() );
+        region.write( { { a, data_a }, { b, data_b } } );
+        CHECK( region.read( a ) == data_a );
+        CHECK( region.read( b ) == data_b );
+        CHECK( region.quads().size() == 2 );
+        CHECK_THROWS_AS( region.read( point( map_region::size, 0 ) ), std::runtime_error );
+    }
+
+    map_region reopened( path );
+    CHECK( reopened.contains( a ) );
+    CHECK_FALSE( reopened.contains( c ) );
+    CHECK( reopened.read( b ) == data_b );
+
+    // A grown quad moves to the end of the file, another quad reuses its old sectors
+    const int sectors = reopened.sector_count();
+    const std::string data_a2 = quad_data( 'A', 9000 );
+    reopened.write( { { a, data_a2 } } );
+    const int grown_sectors = reopened.sector_count();
+    CHECK( grown_sectors > sectors );
+    const std::string data_c = quad_data( 'c', 2 * map_region::sector_size );
+    reopened.write( { { c, data_c } } );
+    CHECK( reopened.sector_count() == grown_sectors );
+
+    const map_region last( path );
+    CHECK( last.read( a ) == data_a2 );
+    CHECK( last.read( b ) == data_b );
+    CHECK( last.read( c ) == data_c );
+    CHECK( last.sector_count() == grown_sectors );
+
+    CHECK( remove_file( path ) );
+    CHECK( remove_directory( dir ) );
+}
+
+TEST_CASE( "map_region_survives_a_torn_header", "[map_region]" )
+{
+    const std::string dir = g->get_world_base_save_path() + "/region_test_" + get_pid_string();
+    REQUIRE( assure_dir_exist( dir ) );
+    const std::string path = dir + "/0.0.0.region";
+
+    const point a( 1, 2 );
+    const std::string old_data = quad_data( 'o', 3000 );
+    const std::string new_data = quad_data( 'n', 6000 );
+    map_region( path ).write( { { a, old_data } } );
+    map_region( path ).write( { { a, new_data } } );
+
+    // The two header copies: magic, version, generation, checksum and 8 bytes per quad
+    const size_t header_bytes = 16 + map_region::size * map_region::size * 8;
+    const size_t slot_bytes = ( header_bytes + map_region::sector_size - 1 ) /
+                              map_region::sector_size * map_region::sector_size;
+    std::ifstream in( path, std::ios::binary );
+    const std::string intact( ( std::istreambuf_iterator<char>( in ) ),
+                              std::istreambuf_iterator<char>() );
+    in.close();
+
+    int previous_versions = 0;
+    for( size_t slot = 0; slot < 2; slot++ ) {
+        // As if the save was interrupted while writing this copy
+        std::string torn = intact;
+        torn[slot * slot_bytes + header_bytes - 1] ^= 0x5a;
+        {
+            std::ofstream out( path, std::ios::binary | std::ios::trunc );
+            out.write( torn.data(), torn.size() );
+        }
+        const std::string data = map_region( path ).read( a );
+        CHECK( ( data == new_data || data == old_data ) );
+        previous_versions += data == old_data;
+    }
+    // Only tearing the newer copy falls back to the previous version
+    CHECK( previous_versions == 1 );
+
+    CHECK( remove_file( path ) );
+    CHECK( remove_directory( dir ) );
+}
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -8,6 +9,7 @@
 #include "game_constants.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "mapdata.h"
 #include "point.h"
 #include "type_id.h"
 
@@ -88,3 +90,21 @@ TEST_CASE( "place_player_can_safely_move_multiple_submaps" )
     g->place_player( tripoint_zero );
     CHECK( g->m.check_submap_active_item_consistency().empty() );
 }
+
+TEST_CASE( "display_stamps_follow_edits_through_any_map", "[map]" )
+{
+    clear_map();
+    map &here = get_map();
+    const std::vector<std::uint64_t> before = here.display_stamps( 0 );
+    CHECK( here.display_stamps( 0 ) == before );
+
+    // Another map over the same submaps, like mapgen and activities use
+    tinymap other;
+    other.load( here.get_abs_sub() + tripoint( 5, 5, 0 ), false );
+    other.ter_set( tripoint( 3, 3, 0 ), t_wall );
+    const std::vector<std::uint64_t> after_wall = here.display_stamps( 0 );
+    CHECK( after_wall != before );
+
+    other.set_graffiti( tripoint( 4, 3, 0 ), "here" );
+    CHECK( here.display_stamps( 0 ) != after_wall );
+}
@@ -0,0 +1,94 @@
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "coordinates.h"
+#include "mongroup.h"
+#include "monster.h"
+#include "type_id.h"
+
+static const mongroup_id GROUP_ZOMBIE( "GROUP_ZOMBIE" );
+
+static const mtype_id mon_zombie( "mon_zombie" );
+
+TEST_CASE( "mongroup_map_tracks_moved_groups", "[mongroup]" )
+{
+    mongroup_map groups;
+    const tripoint_om_sm a( 10, 10, 0 );
+    const tripoint_om_sm b( 11, 10, 0 );
+    mongroup &first = groups.insert( mongroup( GROUP_ZOMBIE, a, 1, 5 ) );
+    mongroup &second = groups.insert( mongroup( GROUP_ZOMBIE, a, 1, 7 ) );
+    first.monsters.emplace_back( mon_zombie );
+    REQUIRE( groups.size() == 2 );
+    CHECK( groups.at( a ).size() == 2 );
+    CHECK( groups.at( b ).empty() );
+
+    const monster *const horde_monster = &first.monsters.front();
+    groups.move( first, b );
+    CHECK( first.pos == b );
+    CHECK( &first.monsters.front() == horde_monster );
+    REQUIRE( groups.at( a ).size() == 1 );
+    CHECK( groups.at( a ).front() == &second );
+    REQUIRE( groups.at( b ).size() == 1 );
+    CHECK( groups.at( b ).front() == &first );
+
+    const mongroup_map copy = groups;
+    REQUIRE( copy.at( b ).size() == 1 );
+    CHECK( copy.at( b ).front() != &first );
+    CHECK( copy.at( b ).front()->population == 5 );
+
+    groups.erase( groups.begin() );
+    CHECK( groups.size() == 1 );
+    CHECK( groups.at( b ).empty() );
+    CHECK( copy.at( b ).size() == 1 );
+}
+
+// One step towards the target and back, like move_hordes does every 2.5 minutes
+static tripoint_om_sm horde_step( const tripoint_om_sm &pos, int turn )
+{
+    return pos + tripoint( turn % 2 == 0 ? 1 : -1, 0, 0 );
+}
+
+TEST_CASE( "horde_relocation_benchmark", "[.][mongroup][benchmark]" )
+{
+    const int horde_count = 10000;
+    std::vector<mongroup> hordes;
+    for( int i = 0; i < horde_count; ++i ) {
+        mongroup horde( GROUP_ZOMBIE, tripoint_om_sm( i % 200, i / 200, 0 ), 1, 0 );
+        horde.horde = true;
+        // Some of them absorbed wandering zombies
+        if( i % 10 == 0 ) {
+            horde.monsters.assign( 10, monster( mon_zombie ) );
+        }
+        hordes.push_back( std::move( horde ) );
+    }
+
+    std::multimap<tripoint_om_sm, mongroup> old_zg;
+    mongroup_map zg;
+    for( const mongroup &horde : hordes ) {
+        old_zg.emplace( horde.pos, horde );
+        zg.insert( horde );
+    }
+    hordes.clear();
+
+    int old_turn = 0;
+    BENCHMARK( "copy into a temporary multimap" ) {
+        std::multimap<tripoint_om_sm, mongroup> tmpzg;
+        for( auto it = old_zg.begin(); it != old_zg.end(); ) {
+            mongroup &mg = it->second;
+            mg.pos = horde_step( mg.pos, old_turn );
+            tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
+            old_zg.erase( it++ );
+        }
+        old_zg.insert( tmpzg.begin(), tmpzg.end() );
+        return ++old_turn;
+    };
+    int turn = 0;
+    BENCHMARK( "move in place" ) {
+        for( mongroup &mg : zg ) {
+            zg.move( mg, horde_step( mg.pos, turn ) );
+        }
+        return ++turn;
+    };
+}
@@ -12,6 +12,7 @@
 #include "overmap_types.h"
 #include "overmapbuffer.h"
 #include "point.h"
+#include "rng.h"
 #include "type_id.h"
 
 TEST_CASE( "set_and_get_overmap_scents" )
@@ -208,3 +209,22 @@ TEST_CASE( "is_ot_match", "[overmap][terrain]" )
         CHECK_FALSE( is_ot_match( "forestry", oter_id( "forest" ), ot_match_type::contains ) );
     }
 }
+
+TEST_CASE( "pregenerating_overmaps_leaves_the_rng_sequence_alone", "[overmap][slow]" )
+{
+    // Pregenerated overmaps are seeded from their position instead
+    const cata_default_random_engine before = rng_get_engine();
+    overmap_buffer.generate_around( point_abs_om( 60, -60 ), 0 );
+    CHECK( overmap_buffer.get_existing( point_abs_om( 60, -60 ) ) != nullptr );
+    CHECK( rng_get_engine() == before );
+}
+
+TEST_CASE( "overmaps_around_a_point_are_generated_together", "[overmap][slow]" )
+{
+    const point_abs_om center( -60, 60 );
+    overmap_buffer.generate_around( center );
+    for( const point_abs_om &p : closest_points_first( center, 1 ) ) {
+        CAPTURE( p );
+        CHECK( overmap_buffer.get_existing( p ) != nullptr );
+    }
+}
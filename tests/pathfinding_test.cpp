@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "pathfinding.h"
+#include "point.h"
+
+static const pathfinding_settings walker_settings( 0, 60, 500, 0, false, false, true, false,
+        false );
+
+// A wall along x == 60 with a single gap at y == 52
+static void build_wall_with_gap()
+{
+    clear_map();
+    map &here = get_map();
+    for( int y = 10; y < 110; y++ ) {
+        if( y != 52 ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+}
+
+static void check_route_is_walkable( const std::vector<tripoint> &route, const tripoint &from,
+                                     const tripoint &to )
+{
+    REQUIRE_FALSE( route.empty() );
+    CHECK( route.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        CAPTURE( prev, p );
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( get_map().passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "route_goes_through_the_gap", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    const tripoint from( 50, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+
+    const std::vector<tripoint> route = get_map().route( from, to, walker_settings );
+    check_route_is_walkable( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( 60, 52, 0 ) ) != route.end() );
+}
+
+TEST_CASE( "route_results_do_not_depend_on_earlier_searches", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    const tripoint from( 50, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+
+    const std::vector<tripoint> first = here.route( from, to, walker_settings );
+    check_route_is_walkable( first, from, to );
+
+    // Searches that visit and close many cells, including a failing one and
+    // one with pre-closed cells, must not leak state into later searches.
+    const std::set<tripoint> pre_closed = { tripoint( 60, 52, 0 ) };
+    CHECK( here.route( from, to, walker_settings, pre_closed ).empty() );
+    CHECK_FALSE( here.route( tripoint( 70, 30, 0 ), tripoint( 50, 80, 0 ),
+                             walker_settings ).empty() );
+    CHECK( here.route( from, tripoint( 60, 58, 0 ), walker_settings ).empty() );
+
+    for( int i = 0; i < 3; i++ ) {
+        CHECK( here.route( from, to, walker_settings ) == first );
+    }
+    const std::vector<tripoint> reverse = here.route( to, from, walker_settings );
+    check_route_is_walkable( reverse, to, from );
+    CHECK( here.route( to, from, walker_settings ) == reverse );
+}
+
+TEST_CASE( "route_respects_max_length", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    const tripoint from( 50, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+
+    pathfinding_settings short_settings = walker_settings;
+    short_settings.max_length = 20;
+    CHECK( here.route( from, to, short_settings ).empty() );
+    // And the rejected search does not affect the next one.
+    check_route_is_walkable( here.route( from, to, walker_settings ), from, to );
+}
+
+TEST_CASE( "long_route_goes_around_a_distant_gap", "[pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+    // The gap is far outside the padded box of a direct search
+    for( int y = 0; y < MAPSIZE_Y; y++ ) {
+        if( y != 100 ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+    const tripoint from( 30, 40, 0 );
+    const tripoint to( 90, 40, 0 );
+
+    // Only callers that ask for it are guided by the portal graph
+    CHECK( here.route( from, to, walker_settings ).empty() );
+
+    pathfinding_settings guided = walker_settings;
+    guided.guide_by_portals = true;
+    const std::vector<tripoint> route = here.route( from, to, guided );
+    check_route_is_walkable( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( 60, 100, 0 ) ) != route.end() );
+}
+
+TEST_CASE( "portal_graph_refreshes_incrementally", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    const pathfinding_portal_graph &graph = here.get_portal_graph_ref( 0 );
+    CHECK( graph.portal_count() > 0 );
+    const int generation = graph.cache_generation();
+
+    // Nothing changed, nothing is rebuilt
+    here.get_portal_graph_ref( 0 );
+    CHECK( graph.cache_generation() == generation );
+
+    // Changing one tile rebuilds its submap and the 4 neighbors
+    here.ter_set( tripoint( 30, 30, 0 ), t_wall );
+    here.get_portal_graph_ref( 0 );
+    CHECK( graph.cache_generation() != generation );
+    CHECK( graph.last_rebuilt_clusters() == 5 );
+
+    // A tile change that does not affect walkability rebuilds nothing
+    const int rebuilt_generation = graph.cache_generation();
+    here.ter_set( tripoint( 30, 30, 0 ), t_rock_wall );
+    here.get_portal_graph_ref( 0 );
+    CHECK( graph.cache_generation() != rebuilt_generation );
+    CHECK( graph.last_rebuilt_clusters() == 0 );
+}
+
+TEST_CASE( "portal_graph_waypoints", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    const pathfinding_portal_graph &graph = get_map().get_portal_graph_ref( 0 );
+
+    // Same submap, no waypoints needed
+    CHECK( graph.find_waypoints( point( 13, 13 ), point( 22, 22 ) ).empty() );
+
+    const std::vector<point> waypoints = graph.find_waypoints( point( 30, 60 ), point( 90, 60 ) );
+    REQUIRE_FALSE( waypoints.empty() );
+    // Every waypoint is walkable and the wall is crossed at the gap
+    for( const point &w : waypoints ) {
+        CAPTURE( w );
+        CHECK( get_map().passable( tripoint( w, 0 ) ) );
+        if( w.x == 60 ) {
+            CHECK( w.y == 52 );
+        }
+    }
+}
+
+static int route_cost( const std::vector<tripoint> &route, const tripoint &from )
+{
+    int cost = 0;
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        cost += ( prev.x != p.x && prev.y != p.y ) ? 3 : 2;
+        prev = p;
+    }
+    return cost;
+}
+
+TEST_CASE( "guided_route_follows_the_portal_waypoints", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    // Close enough to the gap for the direct search to find it too
+    const tripoint from( 30, 60, 0 );
+    const tripoint to( 90, 60, 0 );
+    const std::vector<tripoint> direct = here.route( from, to, walker_settings );
+    check_route_is_walkable( direct, from, to );
+
+    pathfinding_settings guided_settings = walker_settings;
+    guided_settings.guide_by_portals = true;
+    const std::vector<tripoint> guided = here.route( from, to, guided_settings );
+    check_route_is_walkable( guided, from, to );
+
+    const std::vector<point> waypoints = here.get_portal_graph_ref( 0 ).find_waypoints( from.xy(),
+                                         to.xy() );
+    REQUIRE_FALSE( waypoints.empty() );
+    // Every waypoint is on the guided route, in order
+    auto it = guided.begin();
+    for( const point &w : waypoints ) {
+        CAPTURE( w );
+        it = std::find( it, guided.end(), tripoint( w, 0 ) );
+        CHECK( it != guided.end() );
+    }
+    // And the detour through the portal midpoints stays short
+    CHECK( route_cost( guided, from ) >= route_cost( direct, from ) );
+    CHECK( route_cost( guided, from ) <= route_cost( direct, from ) + 2 * SEEX );
+}
+
+TEST_CASE( "crowd_routes_match_individual_routes", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    const tripoint target( 70, 60, 0 );
+
+    // The first pursuer searches alone, the rest share a flow field
+    for( const tripoint &from : {
+             tripoint( 50, 60, 0 ), tripoint( 50, 70, 0 ), tripoint( 55, 40, 0 ), tripoint( 45, 58, 0 )
+         } ) {
+        CAPTURE( from );
+        const std::vector<tripoint> crowd = here.crowd_route( from, target, walker_settings );
+        check_route_is_walkable( crowd, from, target );
+        CHECK( route_cost( crowd, from ) == route_cost( here.route( from, target, walker_settings ),
+                from ) );
+    }
+
+    // Too far for the settings, nothing to share
+    pathfinding_settings short_settings = walker_settings;
+    short_settings.max_length = 20;
+    CHECK( here.crowd_route( tripoint( 50, 60, 0 ), target, short_settings ).empty() );
+    CHECK( here.crowd_route( tripoint( 50, 61, 0 ), target, short_settings ).empty() );
+}
@@ -0,0 +1,130 @@
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_iterator.h"
+#include "mapdata.h"
+#include "monster.h"
+#include "optional.h"
+#include "point.h"
+#include "rng.h"
+
+static const tripoint target( 50, 60, 0 );
+
+// A wall along x == 60 with a single gap at y == 52
+static void build_wall_with_gap()
+{
+    clear_map();
+    map &here = get_map();
+    for( int y = 10; y < 110; y++ ) {
+        if( y != 52 ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0, true );
+}
+
+TEST_CASE( "perception_pass_agrees_with_lines_of_sight", "[vision][monster]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    here.build_perception_cache( { target } );
+
+    int cells = 0;
+    int decided = 0;
+    for( const tripoint &from : here.points_in_radius( target, 40 ) ) {
+        CAPTURE( from );
+        cells++;
+        if( const cata::optional<bool> perceived = here.perceived( target, from ) ) {
+            decided++;
+            CHECK( *perceived == here.sees( from, target, -1 ) );
+        }
+    }
+    // Only lines passing the edges of the gap are left to map::sees
+    CHECK( decided * 10 > cells * 9 );
+
+    // Not a target of the pass
+    CHECK_FALSE( here.perceived( target + point_east, target ) );
+
+    SECTION( "changing the map outdates the pass" ) {
+        here.ter_set( tripoint( 60, 52, 0 ), t_wall );
+        here.build_map_cache( 0, true );
+        CHECK_FALSE( here.perceived( target, target + point( 20, -8 ) ) );
+    }
+
+    SECTION( "an empty pass forgets the targets" ) {
+        here.build_perception_cache( {} );
+        CHECK_FALSE( here.perceived( target, target + point_east ) );
+    }
+}
+
+TEST_CASE( "perception_pass_agrees_with_lines_of_sight_among_scattered_walls", "[vision][monster]" )
+{
+    clear_map();
+    map &here = get_map();
+    for( const tripoint &p : here.points_in_radius( target, 40 ) ) {
+        if( p != target && one_in( 8 ) ) {
+            here.ter_set( p, t_wall );
+        }
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0, true );
+    here.build_perception_cache( { target } );
+
+    int decided = 0;
+    for( const tripoint &from : here.points_in_radius( target, 40 ) ) {
+        if( const cata::optional<bool> perceived = here.perceived( target, from ) ) {
+            CAPTURE( from );
+            decided++;
+            CHECK( *perceived == here.sees( from, target, -1 ) );
+        }
+    }
+    CHECK( decided > 0 );
+}
+
+TEST_CASE( "perception_pass_benchmark", "[.][vision][monster][benchmark]" )
+{
+    build_wall_with_gap();
+    map &here = get_map();
+    std::vector<monster *> zombies;
+    for( int i = 0; i < 300; ++i ) {
+        const tripoint p( rng( 10, 110 ), rng( 10, 110 ), 0 );
+        if( here.passable( p ) && g->critter_at( p ) == nullptr ) {
+            zombies.push_back( &spawn_test_monster( "mon_zombie", p ) );
+        }
+    }
+    const std::vector<tripoint> targets = {
+        target, target + point( 30, 0 ), target + point( 0, 30 ), target + point( -20, -20 ),
+        target + point( 40, 40 )
+    };
+
+    BENCHMARK( "trace every line" ) {
+        here.build_perception_cache( {} );
+        // Vision changes around the targets every turn
+        here.invalidate_map_cache( 0 );
+        here.build_map_cache( 0, true );
+        int seen = 0;
+        for( const monster *z : zombies ) {
+            for( const tripoint &t : targets ) {
+                seen += z->sees( t );
+            }
+        }
+        return seen;
+    };
+    BENCHMARK( "perception pass" ) {
+        here.invalidate_map_cache( 0 );
+        here.build_map_cache( 0, true );
+        here.build_perception_cache( targets );
+        int seen = 0;
+        for( const monster *z : zombies ) {
+            for( const tripoint &t : targets ) {
+                seen += z->sees( t );
+            }
+        }
+        return seen;
+    };
+    clear_creatures();
+}
@@ -0,0 +1,142 @@
+#include <memory>
+
+#include "catch/catch.hpp"
+#include "game_constants.h"
+#include "point.h"
+#include "rng.h"
+#include "scent_map.h"
+
+template<typename T>
+using scent_array = scent_map::scent_array<T>;
+
+namespace
+{
+
+struct scent_fixture {
+    scent_array<int> scent;
+    scent_array<bool> blocks_scent;
+    scent_array<bool> reduces_scent;
+};
+
+} // namespace
+
+// The diffusion loops scent_map::update used before scent_map::diffuse
+static void reference_diffuse( scent_array<int> &grscent, const scent_array<bool> &blocks_scent,
+                               const scent_array<bool> &reduces_scent, const point &min, const point &max )
+{
+    auto sum_3_scent_y = std::make_unique<scent_array<int>>();
+    auto squares_used_y = std::make_unique<scent_array<int>>();
+    const int diffusivity = 100;
+
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            ( *sum_3_scent_y )[y][x] = 0;
+            ( *squares_used_y )[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks_scent[x][i] ) {
+                    if( reduces_scent[x][i] ) {
+                        ( *sum_3_scent_y )[y][x] += 2 * grscent[x][i];
+                        ( *squares_used_y )[y][x] += 2;
+                    } else {
+                        ( *sum_3_scent_y )[y][x] += 10 * grscent[x][i];
+                        ( *squares_used_y )[y][x] += 10;
+                    }
+                }
+            }
+        }
+    }
+
+    for( int x = min.x; x <= max.x; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            int &scent_here = grscent[x][y];
+            if( !blocks_scent[x][y] ) {
+                const int squares_used = ( *squares_used_y )[y][x - 1]
+                                         + ( *squares_used_y )[y][x]
+                                         + ( *squares_used_y )[y][x + 1];
+
+                int this_diffusivity;
+                if( !reduces_scent[x][y] ) {
+                    this_diffusivity = diffusivity;
+                } else {
+                    this_diffusivity = diffusivity / 5;
+                }
+                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+                scent_here =
+                    ( temp_scent
+                      + this_diffusivity * ( ( *sum_3_scent_y )[y][x - 1]
+                                             + ( *sum_3_scent_y )[y][x]
+                                             + ( *sum_3_scent_y )[y][x + 1] )
+                    ) / ( 1000 * 10 );
+            } else {
+                scent_here = 0;
+            }
+        }
+    }
+}
+
+// Scent in a few spots and some scent blocking and reducing terrain, like around a player
+static std::unique_ptr<scent_fixture> make_fixture( int scent_sources )
+{
+    auto ret = std::make_unique<scent_fixture>();
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            ret->scent[x][y] = 0;
+            // Vehicle obstacles can reduce scent on squares that block it
+            ret->blocks_scent[x][y] = one_in( 10 );
+            ret->reduces_scent[x][y] = one_in( 8 );
+        }
+    }
+    for( int i = 0; i < scent_sources; ++i ) {
+        ret->scent[rng( 0, MAPSIZE_X - 1 )][rng( 0, MAPSIZE_Y - 1 )] = rng( 1, 10000 );
+    }
+    return ret;
+}
+
+static const point diffusion_center( MAPSIZE_X / 2, MAPSIZE_Y / 2 );
+static const point diffusion_min = diffusion_center - point( 40, 40 );
+static const point diffusion_max = diffusion_center + point( 40, 40 );
+
+TEST_CASE( "scent_diffusion_matches_reference", "[scent]" )
+{
+    const int scent_sources = GENERATE( 0, 1, 20, 2000 );
+    CAPTURE( scent_sources );
+    const std::unique_ptr<scent_fixture> expected = make_fixture( scent_sources );
+    const std::unique_ptr<scent_fixture> actual = std::make_unique<scent_fixture>( *expected );
+    for( int turn = 0; turn < 20; ++turn ) {
+        reference_diffuse( expected->scent, expected->blocks_scent, expected->reduces_scent,
+                           diffusion_min, diffusion_max );
+        scent_map::diffuse( actual->scent, actual->blocks_scent, actual->reduces_scent,
+                            diffusion_min, diffusion_max );
+        CAPTURE( turn );
+        REQUIRE( actual->scent == expected->scent );
+    }
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.][scent][benchmark]" )
+{
+    const std::unique_ptr<scent_fixture> sparse = make_fixture( 5 );
+    const std::unique_ptr<scent_fixture> dense = make_fixture( 5000 );
+    std::unique_ptr<scent_fixture> f = std::make_unique<scent_fixture>();
+
+    BENCHMARK( "old kernel, sparse scent" ) {
+        *f = *sparse;
+        reference_diffuse( f->scent, f->blocks_scent, f->reduces_scent, diffusion_min, diffusion_max );
+        return f->scent[diffusion_center.x][diffusion_center.y];
+    };
+    BENCHMARK( "new kernel, sparse scent" ) {
+        *f = *sparse;
+        scent_map::diffuse( f->scent, f->blocks_scent, f->reduces_scent, diffusion_min, diffusion_max );
+        return f->scent[diffusion_center.x][diffusion_center.y];
+    };
+    BENCHMARK( "old kernel, dense scent" ) {
+        *f = *dense;
+        reference_diffuse( f->scent, f->blocks_scent, f->reduces_scent, diffusion_min, diffusion_max );
+        return f->scent[diffusion_center.x][diffusion_center.y];
+    };
+    BENCHMARK( "new kernel, dense scent" ) {
+        *f = *dense;
+        scent_map::diffuse( f->scent, f->blocks_scent, f->reduces_scent, diffusion_min, diffusion_max );
+        return f->scent[diffusion_center.x][diffusion_center.y];
+    };
+}
@@ -633,6 +633,119 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+namespace
+{
+
+struct bitplane_fixture {
+    float transparency[MAPSIZE_X][MAPSIZE_Y];
+    transparency_bitplanes planes;
+    float seen_plain[MAPSIZE_X][MAPSIZE_Y];
+    float seen_packed[MAPSIZE_X][MAPSIZE_Y];
+    four_quadrants lit_plain[MAPSIZE_X][MAPSIZE_Y];
+    four_quadrants lit_packed[MAPSIZE_X][MAPSIZE_Y];
+
+    // Mostly open ground with scattered walls and patches of smoke, so that
+    // rows are a mix of uniform and mixed spans.
+    void fill() {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( one_in( 30 ) ) {
+                    transparency[x][y] = LIGHT_TRANSPARENCY_SOLID;
+                } else if( one_in( 30 ) ) {
+                    transparency[x][y] = LIGHT_TRANSPARENCY_OPEN_AIR * 4;
+                } else {
+                    transparency[x][y] = LIGHT_TRANSPARENCY_OPEN_AIR;
+                }
+            }
+        }
+        planes.build( transparency );
+    }
+
+    void cast( const point &origin, const int offset_distance ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                seen_plain[x][y] = 0.0f;
+                seen_packed[x][y] = 0.0f;
+                lit_plain[x][y].fill( 0.0f );
+                lit_packed[x][y].fill( 0.0f );
+            }
+        }
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            seen_plain, transparency, origin, offset_distance );
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            seen_packed, transparency, origin, offset_distance, VISIBILITY_FULL, &planes );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>(
+                         lit_plain, transparency, origin, offset_distance );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>(
+                         lit_packed, transparency, origin, offset_distance, VISIBILITY_FULL, &planes );
+    }
+
+    int differences() const {
+        int ret = 0;
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( seen_plain[x][y] != seen_packed[x][y] ||
+                    lit_plain[x][y].values != lit_packed[x][y].values ) {
+                    ret++;
+                }
+            }
+        }
+        return ret;
+    }
+};
+
+} // namespace
+
+TEST_CASE( "shadowcasting_bitplanes_give_identical_output", "[shadowcasting]" )
+{
+    std::unique_ptr<bitplane_fixture> fixture = std::make_unique<bitplane_fixture>();
+    fixture->fill();
+
+    // The center, the edges and the corners, so rows leave the map on every side.
+    const std::vector<point> origins = {
+        point( 65, 65 ), point( 0, 0 ), point( MAPSIZE_X - 1, MAPSIZE_Y - 1 ),
+        point( 0, MAPSIZE_Y - 1 ), point( MAPSIZE_X - 1, 0 ), point( 3, 70 ), point( 70, 128 )
+    };
+    for( const point &origin : origins ) {
+        for( const int offset_distance : {
+                 0, 40
+             } ) {
+            CAPTURE( origin, offset_distance );
+            fixture->cast( origin, offset_distance );
+            CHECK( fixture->differences() == 0 );
+        }
+    }
+
+    // Planes patched cell by cell must describe the grid as well as rebuilt ones.
+    for( int i = 0; i < 200; i++ ) {
+        const point p( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ) );
+        const float value = one_in( 2 ) ? LIGHT_TRANSPARENCY_SOLID : LIGHT_TRANSPARENCY_OPEN_AIR * 2;
+        fixture->transparency[p.x][p.y] = value;
+        fixture->planes.set( p, value );
+    }
+    fixture->cast( point( 65, 65 ), 0 );
+    CHECK( fixture->differences() == 0 );
+}
+
+TEST_CASE( "shadowcasting_bitplanes_benchmark", "[.][shadowcasting][benchmark]" )
+{
+    std::unique_ptr<bitplane_fixture> fixture = std::make_unique<bitplane_fixture>();
+    fixture->fill();
+    const point origin( 65, 65 );
+
+    BENCHMARK( "castLightAll" ) {
+        return castLightAll<float, float, sight_calc, sight_check, update_light,
+               accumulate_transparency>( fixture->seen_plain, fixture->transparency, origin, 0 );
+    };
+    BENCHMARK( "castLightAll with bitplanes" ) {
+        return castLightAll<float, float, sight_calc, sight_check, update_light,
+               accumulate_transparency>( fixture->seen_packed, fixture->transparency, origin, 0,
+                                         VISIBILITY_FULL, &fixture->planes );
+    };
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "avatar.h"
+#include "catch/catch.hpp"
+#include "creature_tracker.h"
+#include "game.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "memory_fast.h"
+#include "monster.h"
+#include "point.h"
+#include "rng.h"
+#include "sounds.h"
+
+static tripoint random_local_point()
+{
+    return tripoint( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ), 0 );
+}
+
+static std::vector<monster *> spawn_random_zombies( int count )
+{
+    std::set<tripoint> used = { g->u.pos() };
+    std::vector<monster *> ret;
+    while( static_cast<int>( ret.size() ) < count ) {
+        const tripoint p = random_local_point();
+        if( used.insert( p ).second ) {
+            ret.push_back( &spawn_test_monster( "mon_zombie", p ) );
+        }
+    }
+    return ret;
+}
+
+TEST_CASE( "creature_tracker_finds_monsters_in_range", "[sounds][monster]" )
+{
+    clear_map();
+    std::vector<monster *> zombies = spawn_random_zombies( 200 );
+    // Move some of them around, update_pos has to keep the index up to date
+    for( int i = 0; i < 50; ++i ) {
+        monster &z = *zombies[i];
+        const tripoint dest = z.pos() + tripoint( rng( -20, 20 ), rng( -20, 20 ), 0 );
+        if( get_map().inbounds( dest ) && g->critter_at( dest ) == nullptr ) {
+            z.setpos( dest );
+        }
+    }
+    zombies[60]->die( nullptr );
+
+    for( int i = 0; i < 50; ++i ) {
+        const tripoint center = random_local_point();
+        const int radius = rng( 0, 60 );
+        CAPTURE( center, radius );
+        std::vector<const monster *> expected;
+        for( const monster &critter : g->all_monsters() ) {
+            if( std::abs( critter.posx() - center.x ) <= radius &&
+                std::abs( critter.posy() - center.y ) <= radius ) {
+                expected.push_back( &critter );
+            }
+        }
+        std::vector<const monster *> found;
+        for( const shared_ptr_fast<monster> &critter : g->critter_tracker->find_near( center, radius ) ) {
+            found.push_back( critter.get() );
+        }
+        std::sort( expected.begin(), expected.end() );
+        std::sort( found.begin(), found.end() );
+        CHECK( found == expected );
+    }
+    clear_creatures();
+}
+
+TEST_CASE( "monster_sound_delivery_benchmark", "[.][sounds][benchmark]" )
+{
+    clear_map();
+    spawn_random_zombies( 500 );
+    std::vector<tripoint> sources;
+    for( int i = 0; i < 100; ++i ) {
+        sources.push_back( random_local_point() );
+    }
+
+    BENCHMARK( "100 sounds, all monsters" ) {
+        int heard = 0;
+        for( const tripoint &source : sources ) {
+            for( monster &critter : g->all_monsters() ) {
+                heard += rl_dist( source, critter.pos() ) < 40;
+            }
+        }
+        return heard;
+    };
+    BENCHMARK( "100 sounds, monsters in range" ) {
+        int heard = 0;
+        for( const tripoint &source : sources ) {
+            for( const shared_ptr_fast<monster> &critter : g->critter_tracker->find_near( source, 39 ) ) {
+                heard += rl_dist( source, critter->pos() ) < 40;
+            }
+        }
+        return heard;
+    };
+    BENCHMARK( "process 100 sounds" ) {
+        for( const tripoint &source : sources ) {
+            sounds::sound( source, 20, sounds::sound_t::combat, "a thud" );
+        }
+        sounds::process_sounds();
+    };
+    clear_creatures();
+}
@@ -1,8 +1,17 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "catch/catch.hpp"
 #include "submap.h"
 #include "game_constants.h"
 #include "int_id.h"
+#include "mapdata.h"
 #include "point.h"
+#include "submap_binary.h"
+#include "trap.h"
 #include "type_id.h"
 
 TEST_CASE( "submap rotation", "[submap]" )
@@ -89,3 +98,79 @@ TEST_CASE( "submap rotation", "[submap]" )
         }
     }
 }
+
+static void check_same_submap( const submap &a, const submap &b )
+{
+    CHECK( a.get_temperature() == b.get_temperature() );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            const point p( x, y );
+            CAPTURE( p );
+            CHECK( a.get_ter( p ) == b.get_ter( p ) );
+            CHECK( a.get_furn( p ) == b.get_furn( p ) );
+            CHECK( a.get_trap( p ) == b.get_trap( p ) );
+            CHECK( a.get_radiation( p ) == b.get_radiation( p ) );
+        }
+    }
+}
+
+TEST_CASE( "submap binary format round trip", "[submap]" )
+{
+    submap sm;
+    sm.set_all_ter( ter_str_id( "t_dirt" ).id() );
+    for( int x = 0; x < SEEX; x++ ) {
+        sm.set_ter( point( x, 3 ), ter_str_id( "t_wall" ).id() );
+    }
+    sm.set_furn( point( 5, 5 ), furn_str_id( "f_chair" ).id() );
+    sm.set_trap( point( 7, 1 ), trap_str_id( "tr_beartrap" ).id() );
+    sm.set_radiation( point( 2, 9 ), 40 );
+    sm.set_radiation( point( SEEX - 1, SEEY - 1 ), 3 );
+    sm.set_temperature( -12 );
+
+    submap other;
+    other.set_all_ter( ter_str_id( "t_grass" ).id() );
+
+    const std::vector<std::pair<tripoint, const submap *>> quad = {
+        { tripoint( 10, -4, 0 ), &sm }, { tripoint( 11, -4, 0 ), &other }
+    };
+    for( const submap_binary::compression comp : {
+             submap_binary::compression::none, submap_binary::compression::lz
+         } ) {
+        CAPTURE( static_cast<int>( comp ) );
+        const std::string data = submap_binary::encode_quad( quad, comp );
+        CHECK( submap_binary::is_binary( data ) );
+
+        const auto decoded = submap_binary::decode_quad( data );
+        REQUIRE( decoded.size() == 2 );
+        CHECK( decoded[0].first == tripoint( 10, -4, 0 ) );
+        CHECK( decoded[1].first == tripoint( 11, -4, 0 ) );
+        check_same_submap( sm, *decoded[0].second );
+        check_same_submap( other, *decoded[1].second );
+
+        // Truncated files are rejected rather than half loaded
+        CHECK_THROWS_AS( submap_binary::decode_quad( data.substr( 0, data.size() - 5 ) ),
+                         std::runtime_error );
+    }
+    CHECK_FALSE( submap_binary::is_binary( "[{\"version\":33}]" ) );
+}
+
+TEST_CASE( "submap binary compression round trip", "[submap]" )
+{
+    std::string data;
+    for( int i = 0; i < 2000; i++ ) {
+        data += "{\"typeid\":\"rock\",\"charges\":" + std::to_string( i % 7 ) + "},";
+    }
+    data.push_back( '\0' );
+    data += "abc";
+
+    const std::string compressed = submap_binary::compress( data );
+    CHECK( compressed.size() < data.size() / 4 );
+    CHECK( submap_binary::decompress( compressed, data.size() ) == data );
+
+    CHECK( submap_binary::decompress( submap_binary::compress( "" ), 0 ).empty() );
+    CHECK( submap_binary::decompress( submap_binary::compress( "ab" ), 2 ) == "ab" );
+    CHECK_THROWS_AS( submap_binary::decompress( compressed, data.size() + 1 ), std::runtime_error );
+    // A match pointing before the start of the output
+    CHECK_THROWS_AS( submap_binary::decompress( std::string( "\x01\x05\x00\x00", 4 ), 4 ),
+                     std::runtime_error );
+}
@@ -0,0 +1,137 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "turn_profiler.h"
+
+using turn_profiler::phase;
+
+static void record_ms( phase p, int ms )
+{
+    turn_profiler::record( p, std::chrono::milliseconds( ms ) );
+}
+
+TEST_CASE( "turn_profiler_percentiles", "[turn_profiler]" )
+{
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+
+    // 100 turns where fields take 1..100 ms and monmove is called twice per turn.
+    for( int i = 1; i <= 100; i++ ) {
+        turn_profiler::begin_turn();
+        record_ms( phase::fields, i );
+        record_ms( phase::monmove, 1 );
+        record_ms( phase::monmove, 1 );
+        turn_profiler::end_turn();
+    }
+
+    CHECK( turn_profiler::recorded_turns() == 100 );
+
+    const turn_profiler::phase_stats fields = turn_profiler::get_stats( phase::fields );
+    CHECK( fields.calls == 100 );
+    CHECK( fields.max_ms == Approx( 100.0 ) );
+    CHECK( fields.last_ms == Approx( 100.0 ) );
+    CHECK( fields.p50_ms == Approx( 51.0 ) );
+    CHECK( fields.p99_ms == Approx( 100.0 ) );
+    CHECK( fields.total_ms == Approx( 5050.0 ) );
+
+    const turn_profiler::phase_stats monmove = turn_profiler::get_stats( phase::monmove );
+    CHECK( monmove.calls == 200 );
+    CHECK( monmove.max_ms == Approx( 2.0 ) );
+
+    CHECK( turn_profiler::get_stats( phase::route ).calls == 0 );
+
+    turn_profiler::set_enabled( false );
+    turn_profiler::reset();
+}
+
+TEST_CASE( "turn_profiler_history_wraps", "[turn_profiler]" )
+{
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+
+    for( int i = 0; i < turn_profiler::history_size + 10; i++ ) {
+        turn_profiler::begin_turn();
+        record_ms( phase::items, i < turn_profiler::history_size ? 1 : 5 );
+        turn_profiler::end_turn();
+    }
+
+    CHECK( turn_profiler::recorded_turns() == turn_profiler::history_size );
+    const turn_profiler::phase_stats items = turn_profiler::get_stats( phase::items );
+    CHECK( items.last_ms == Approx( 5.0 ) );
+    CHECK( items.max_ms == Approx( 5.0 ) );
+    CHECK( items.p50_ms == Approx( 1.0 ) );
+    CHECK( items.total_ms == Approx( ( turn_profiler::history_size - 10 ) + 5.0 * 10 ) );
+
+    turn_profiler::set_enabled( false );
+    turn_profiler::reset();
+}
+
+TEST_CASE( "turn_profiler_disabled_records_nothing", "[turn_profiler]" )
+{
+    turn_profiler::reset();
+    turn_profiler::set_enabled( false );
+
+    turn_profiler::begin_turn();
+    {
+        turn_profiler::scoped_timer timer( phase::scent );
+    }
+    turn_profiler::end_turn();
+
+    CHECK( turn_profiler::recorded_turns() == 0 );
+}
+
+TEST_CASE( "turn_profiler_nested_timers_count_once", "[turn_profiler]" )
+{
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+
+    turn_profiler::begin_turn();
+    {
+        turn_profiler::scoped_timer outer( phase::route );
+        turn_profiler::scoped_timer inner( phase::route );
+        turn_profiler::scoped_timer other( phase::cast_light );
+    }
+    {
+        turn_profiler::scoped_timer again( phase::route );
+    }
+    turn_profiler::end_turn();
+
+    CHECK( turn_profiler::get_stats( phase::route ).calls == 2 );
+    CHECK( turn_profiler::get_stats( phase::cast_light ).calls == 1 );
+
+    turn_profiler::set_enabled( false );
+    turn_profiler::reset();
+}
+
+TEST_CASE( "turn_profiler_collects_timers_from_worker_threads", "[turn_profiler]" )
+{
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+
+    turn_profiler::begin_turn();
+    {
+        // The main thread is inside a route while workers time routes of their own.
+        turn_profiler::scoped_timer outer( phase::route );
+        std::vector<std::thread> workers;
+        for( int i = 0; i < 4; i++ ) {
+            workers.emplace_back( [] {
+                for( int j = 0; j < 100; j++ )
+                {
+                    turn_profiler::scoped_timer timer( phase::route );
+                    turn_profiler::scoped_timer nested( phase::route );
+                }
+            } );
+        }
+        for( std::thread &worker : workers ) {
+            worker.join();
+        }
+    }
+    turn_profiler::end_turn();
+
+    CHECK( turn_profiler::get_stats( phase::route ).calls == 401 );
+
+    turn_profiler::set_enabled( false );
+    turn_profiler::reset();
+}
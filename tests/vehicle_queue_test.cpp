@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "rng.h"
+#include "vehicle.h"
+#include "vehicle_queue.h"
+
+// What map::vehproceed did before, for comparison
+static vehicle *linear_top( const std::vector<vehicle *> &vehicles )
+{
+    vehicle *ret = nullptr;
+    float max_of_turn = 0;
+    for( vehicle *veh : vehicles ) {
+        if( veh->of_turn > max_of_turn ) {
+            ret = veh;
+            max_of_turn = veh->of_turn;
+        }
+    }
+    return ret;
+}
+
+TEST_CASE( "vehicle_queue_orders_by_movement_left", "[vehicle]" )
+{
+    std::array<vehicle, 4> vehs;
+    vehs[0].of_turn = 1.0f;
+    vehs[1].of_turn = 3.0f;
+    vehs[2].of_turn = 3.0f;
+    vehs[3].of_turn = 2.0f;
+    vehicle_queue queue;
+    for( vehicle &veh : vehs ) {
+        queue.push( &veh );
+    }
+    REQUIRE( queue.size() == 4 );
+    // Ties go to the vehicle added first
+    CHECK( queue.top() == &vehs[1] );
+
+    vehs[1].of_turn = 0.5f;
+    queue.update( &vehs[1] );
+    CHECK( queue.top() == &vehs[2] );
+
+    queue.erase( &vehs[2] );
+    CHECK_FALSE( queue.contains( &vehs[2] ) );
+    CHECK( queue.top() == &vehs[3] );
+
+    // A vehicle replacing another one takes over its place among equals
+    vehicle merged;
+    merged.of_turn = 1.0f;
+    vehs[3].of_turn = 1.0f;
+    queue.update( &vehs[3] );
+    queue.replace( &vehs[3], &merged );
+    CHECK_FALSE( queue.contains( &vehs[3] ) );
+    CHECK( queue.top() == &vehs[0] );
+    vehs[0].of_turn = 0.0f;
+    queue.update( &vehs[0] );
+    CHECK( queue.top() == &merged );
+
+    CHECK( queue.first_added( []( const vehicle & veh ) {
+        return veh.of_turn < 0.75f;
+    } ) == &vehs[0] );
+
+    queue.clear();
+    CHECK( queue.empty() );
+    CHECK( queue.top() == nullptr );
+}
+
+TEST_CASE( "vehicle_queue_matches_linear_scan", "[vehicle]" )
+{
+    std::vector<vehicle> storage( 50 );
+    std::vector<vehicle *> vehicles;
+    vehicle_queue queue;
+    for( vehicle &veh : storage ) {
+        veh.of_turn = rng( 0, 10 ) / 2.0f;
+        vehicles.push_back( &veh );
+        queue.push( &veh );
+    }
+    for( int step = 0; step < 500; step++ ) {
+        vehicle *expected = linear_top( vehicles );
+        vehicle *top = queue.top();
+        CAPTURE( step );
+        if( expected == nullptr ) {
+            CHECK( top->of_turn <= 0 );
+            break;
+        }
+        REQUIRE( top == expected );
+        // Moving spends some of the movement, collisions change another vehicle's
+        top->of_turn -= rng( 1, 4 ) / 2.0f;
+        queue.update( top );
+        vehicle *other = random_entry( vehicles );
+        other->of_turn = rng( 0, 10 ) / 2.0f;
+        queue.update( other );
+        if( one_in( 20 ) ) {
+            queue.erase( other );
+            vehicles.erase( std::find( vehicles.begin(), vehicles.end(), other ) );
+        }
+    }
+}
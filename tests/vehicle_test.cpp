@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -72,3 +73,82 @@ TEST_CASE( "add_item_to_broken_vehicle_part" )
     const item itm2 = item( "jeans" );
     REQUIRE( !veh_ptr->add_item( *cargo_part, itm2 ) );
 }
+
+// Everything refresh caches about the parts, to compare an incremental update with a full one
+static std::vector<std::vector<int>> part_caches( const vehicle &veh )
+{
+    std::vector<std::vector<int>> ret = {
+        veh.engines, veh.wheelcache, veh.steering, veh.floating
+    };
+    for( const vehicle::mount_parts &mp : veh.relative_parts ) {
+        ret.push_back( { mp.mount.x, mp.mount.y } );
+        ret.push_back( mp.parts );
+    }
+    for( const vehicle_part &part : veh.parts ) {
+        ret.push_back( { part.precalc[0].x, part.precalc[0].y, part.enabled } );
+    }
+    return ret;
+}
+
+static void install_frame_row( vehicle &veh, int y, int length )
+{
+    for( int x = 0; x < length; x++ ) {
+        veh.install_part( point( x, y ), vpart_id( "frame_vertical" ) );
+        if( x % 4 == 0 ) {
+            veh.install_part( point( x, y ), vpart_id( "seat" ) );
+        }
+        if( x % 8 == 0 ) {
+            veh.install_part( point( x, y ), vpart_id( "wheel" ) );
+        }
+    }
+}
+
+TEST_CASE( "installing_parts_matches_a_full_refresh", "[vehicle]" )
+{
+    clear_map();
+    vehicle *veh_ptr = g->m.add_vehicle( vproto_id( "car" ), tripoint( 60, 60, 0 ), 30, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    install_frame_row( *veh_ptr, 3, 10 );
+    install_frame_row( *veh_ptr, -5, 3 );
+    veh_ptr->install_part( point( 1, 3 ), vpart_id( "engine_v6" ) );
+
+    const std::vector<std::vector<int>> incremental = part_caches( *veh_ptr );
+    // Does a full refresh
+    veh_ptr->enable_refresh();
+    CHECK( part_caches( *veh_ptr ) == incremental );
+    for( int x = -8; x <= 12; x++ ) {
+        for( int y = -8; y <= 8; y++ ) {
+            // The cached parts are in display order instead of index order
+            std::vector<int> cached = veh_ptr->parts_at_relative( point( x, y ), true );
+            std::sort( cached.begin(), cached.end() );
+            CHECK( cached == veh_ptr->parts_at_relative( point( x, y ), false ) );
+        }
+    }
+}
+
+TEST_CASE( "vehicle_geometry_benchmark", "[.][vehicle][benchmark]" )
+{
+    clear_map();
+    vehicle *veh_ptr = g->m.add_vehicle( vproto_id( "car" ), tripoint( 60, 60, 0 ), 0, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    for( int y = 3; y < 23; y++ ) {
+        install_frame_row( *veh_ptr, y, 20 );
+    }
+    REQUIRE( veh_ptr->parts.size() > 500 );
+
+    BENCHMARK( "install a part" ) {
+        const int p = veh_ptr->install_part( point( 0, 2 ), vpart_id( "seat" ) );
+        veh_ptr->remove_part( p );
+        veh_ptr->part_removal_cleanup();
+        return p;
+    };
+    int dir = 0;
+    BENCHMARK( "turn" ) {
+        dir = ( dir + 15 ) % 360;
+        veh_ptr->precalc_mounts( 1, dir, veh_ptr->pivot_point() );
+        return dir;
+    };
+    BENCHMARK( "full refresh" ) {
+        veh_ptr->enable_refresh();
+    };
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "cached_options.h"
+#include "catch/catch.hpp"
+#include "game_constants.h"
+#include "lightmap.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "point.h"
+#include "worker_pool.h"
+
+TEST_CASE( "worker_pool_runs_every_task_once", "[worker_pool]" )
+{
+    for( int extra_threads : { 0, 1, 3 } ) {
+        CAPTURE( extra_threads );
+        worker_pool pool( extra_threads );
+        CHECK( pool.thread_count() == extra_threads + 1 );
+        // Repeated batches reuse the same threads
+        for( int batch = 0; batch < 20; batch++ ) {
+            std::vector<std::atomic<int>> runs( 100 );
+            pool.run( static_cast<int>( runs.size() ), [&runs]( int i ) {
+                runs[i]++;
+            } );
+            CHECK( std::all_of( runs.begin(), runs.end(), []( const std::atomic<int> &r ) {
+                return r == 1;
+            } ) );
+        }
+    }
+}
+
+TEST_CASE( "worker_pool_rethrows_task_errors", "[worker_pool]" )
+{
+    worker_pool pool( 2 );
+    std::atomic<int> runs( 0 );
+    CHECK_THROWS_AS( pool.run( 10, [&runs]( int i ) {
+        runs++;
+        if( i == 5 ) {
+            throw std::runtime_error( "task failed" );
+        }
+    } ), std::runtime_error );
+    // The failing task does not stop the others
+    CHECK( runs == 10 );
+    // And the pool is still usable
+    runs = 0;
+    pool.run( 4, [&runs]( int ) {
+        runs++;
+    } );
+    CHECK( runs == 4 );
+}
+
+struct level_snapshot {
+    float transparency[MAPSIZE_X][MAPSIZE_Y];
+    bool outside[MAPSIZE_X][MAPSIZE_Y];
+    bool floor[MAPSIZE_X][MAPSIZE_Y];
+};
+
+static std::vector<std::unique_ptr<level_snapshot>> build_and_snapshot( bool parallel )
+{
+    map &here = get_map();
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        here.set_outside_cache_dirty( z );
+        here.set_transparency_cache_dirty( z );
+        here.set_floor_cache_dirty( z );
+    }
+    const bool old_parallel = parallel_map_cache;
+    parallel_map_cache = parallel;
+    here.build_map_cache( 0 );
+    parallel_map_cache = old_parallel;
+
+    std::vector<std::unique_ptr<level_snapshot>> ret;
+    const int minz = here.has_zlevels() ? -OVERMAP_DEPTH : 0;
+    const int maxz = here.has_zlevels() ? OVERMAP_HEIGHT : 0;
+    for( int z = minz; z <= maxz; z++ ) {
+        const level_cache &ch = here.get_cache_ref( z );
+        auto snap = std::make_unique<level_snapshot>();
+        std::memcpy( snap->transparency, ch.transparency_cache, sizeof( snap->transparency ) );
+        std::memcpy( snap->outside, ch.outside_cache, sizeof( snap->outside ) );
+        std::memcpy( snap->floor, ch.floor_cache, sizeof( snap->floor ) );
+        ret.push_back( std::move( snap ) );
+    }
+    return ret;
+}
+
+TEST_CASE( "parallel_map_cache_matches_serial", "[worker_pool][map]" )
+{
+    clear_map();
+    map &here = get_map();
+    // A roofed room with a window and an opening in the floor above
+    for( int x = 50; x <= 60; x++ ) {
+        for( int y = 50; y <= 60; y++ ) {
+            const tripoint p( x, y, 0 );
+            if( x == 50 || x == 60 || y == 50 || y == 60 ) {
+                here.ter_set( p, y == 55 ? t_window : t_wall );
+            } else {
+                here.ter_set( p, t_floor );
+            }
+            if( here.has_zlevels() ) {
+                here.ter_set( p + tripoint_above, x == 55 && y == 55 ? t_open_air : t_floor );
+            }
+        }
+    }
+
+    const auto serial = build_and_snapshot( false );
+    const auto parallel = build_and_snapshot( true );
+    REQUIRE( serial.size() == parallel.size() );
+    for( size_t i = 0; i < serial.size(); i++ ) {
+        CAPTURE( i );
+        CHECK( std::memcmp( serial[i].get(), parallel[i].get(), sizeof( level_snapshot ) ) == 0 );
+    }
+}